@@ -65,6 +65,8 @@
                             <th>Tests Passed</th>
                             <th>Tests Failed</th>
                             <th>Tests Timeout</th>
+                            <th>Makespan(in sec)</th>
+                            <th>Ideal Makespan(in sec)</th>
 		                </tr>
 		                <tr>
                             <th>Total</th>
@@ -75,6 +77,8 @@
                             <td><xsl:value-of select = "TestFramework/Summary/TestsPassed"/></td>
                             <td><xsl:value-of select = "TestFramework/Summary/TestsFailed"/></td>
                             <td><xsl:value-of select = "TestFramework/Summary/TestsTimeout"/></td>
+                            <td><xsl:value-of select = "TestFramework/Summary/Makespan"/></td>
+                            <td><xsl:value-of select = "TestFramework/Summary/IdealMakespan"/></td>
                         </tr>
 	                </table>
 	            </div>
@@ -87,6 +91,10 @@
                         <th>Test Case Name</th> 
                         <th>Result</th>
 		                <th>Elapsed Time(in sec)</th> 
+		                <th>Latency p50 / p99 / max(in sec)</th>
+		                <th>Throughput MB/s (min)</th>
+		                <th>CPU user / sys(in sec)</th>
+		                <th>Start skew(in sec)</th>
                     </tr> 
 				
                     <xsl:for-each select="TestFramework/TestSuite"> 
@@ -95,6 +103,10 @@
 					        <td><xsl:value-of select = "TestCase/Name"/></td> 
                             <td class="result"><xsl:value-of select = "TestCase/Result"/></td>
 		                    <td class="elapsedtime"><xsl:value-of select = "TestCase/ElapsedTime"/></td>
+		                    <td class="elapsedtime"><xsl:if test = "TestCase/Latency"><xsl:value-of select = "TestCase/Latency/P50"/> / <xsl:value-of select = "TestCase/Latency/P99"/> / <xsl:value-of select = "TestCase/Latency/Max"/></xsl:if></td>
+		                    <td class="elapsedtime"><xsl:if test = "TestCase/Throughput"><xsl:value-of select = "TestCase/Throughput/MBps"/> (<xsl:value-of select = "TestCase/Throughput/MinMBps"/>)</xsl:if></td>
+		                    <td class="elapsedtime"><xsl:if test = "TestCase/Usage"><xsl:value-of select = "TestCase/Usage/UserTime"/> / <xsl:value-of select = "TestCase/Usage/SystemTime"/></xsl:if></td>
+		                    <td class="elapsedtime"><xsl:value-of select = "TestCase/StartBarrier/Skew"/></td>
                         </tr> 
                     </xsl:for-each> 
 					
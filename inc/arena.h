@@ -0,0 +1,100 @@
+/**=============================================================================
+  $Workfile: arena.h $
+
+  File Description: Contains declarations of the shared result arena, the
+                    test case results written by the test execution processes
+                    and the eventfd channels which schedule the test cases
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/resource.h>
+
+#include "deviceDrvTestFW.h"
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+typedef enum
+{
+    E_RESULT_IDLE = 0,
+    E_RESULT_RUNNING,                       /* Test case started */
+    E_RESULT_DONE                           /* Status and end time written */
+}E_RESULT_STATE;
+
+/* Result of a test case, written by the test execution process into the
+ * MAP_SHARED arena and read by the scheduler. uState is stored last with
+ * release semantics, the other fields are valid once it reads DONE.
+ */
+typedef struct test_result
+{
+    uint32_t uState;                        /* E_RESULT_STATE */
+    uint32_t eStatus;                       /* E_TST_STATUS of the run */
+    uint64_t uStartAtNs;                    /* Scheduled start, 0 to start
+                                               at once, written by the
+                                               scheduler */
+    uint64_t uStartNs;                      /* CLOCK_MONOTONIC start */
+    uint64_t uEndNs;                        /* CLOCK_MONOTONIC end */
+    uint32_t uRunCount;                     /* Number of runs */
+    sLatency_t Latency;                     /* Iterations of the run */
+    sThroughput_t Throughput;               /* Benchmark run */
+    sUsage_t Usage;                         /* Resources used by the run */
+    sIrqStat_t IrqStat;                     /* Interrupts during the run */
+}sTestResult_t;
+
+/* Scheduler to test execution process channel, the eventfds are inherited
+ * through fork() and kept when the process is forked again.
+ */
+typedef struct test_channel
+{
+    int nRequestFd;                         /* Case index + 1 to execute */
+    int nDoneFd;                            /* Signalled when result written */
+    unsigned int uResultBase;               /* First result of the process */
+    unsigned int uSlot;                     /* Histograms and clock estimate
+                                               of the process */
+}sTestChannel_t;
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int arenaCreate(unsigned int uSets);
+void arenaDestroy(void);
+void arenaBegin(unsigned int uIndex);
+void arenaPublish(unsigned int uIndex, E_TST_STATUS eStatus);
+void arenaSchedule(unsigned int uIndex, uint64_t uStartAtNs);
+uint64_t arenaStarted(unsigned int uIndex);
+bool arenaCollect(unsigned int uIndex, E_TST_STATUS *peStatus,
+    uint64_t *puElapsedNs, int nCase);
+void arenaSettle(unsigned int uIndex, const struct rusage *pExitUsage);
+
+int channelCreate(sTestChannel_t *pChannel);
+void channelClose(sTestChannel_t *pChannel);
+void channelPost(sTestChannel_t *pChannel, unsigned int uIndex);
+int channelWait(sTestChannel_t *pChannel, unsigned int *puIndex);
+void channelNotify(sTestChannel_t *pChannel);
+bool channelDrain(sTestChannel_t *pChannel);
+
+void executeTestCases(sTestChannel_t *pChannel);
+
+#endif //__ARENA_H__
@@ -0,0 +1,45 @@
+/**=============================================================================
+  $Workfile: benchmark.h $
+
+  File Description: Contains declarations of the throughput benchmark cases,
+                    run by the test execution process for a time or a byte
+                    budget while the case counts the data it moves.
+
+  Author: Johnnie Alan
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <stdbool.h>
+
+#include "deviceDrvTestFW.h"
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+E_TST_STATUS benchmarkRun(unsigned int uCase, sThroughput_t *pThroughput);
+double benchmarkMBps(const sThroughput_t *pThroughput);
+double benchmarkMessagesPerSec(const sThroughput_t *pThroughput);
+bool benchmarkBelowMinimum(const sThroughput_t *pThroughput);
+
+#endif //__BENCHMARK_H__
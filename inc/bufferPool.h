@@ -0,0 +1,89 @@
+/**=============================================================================
+  $Workfile: bufferPool.h $
+
+  File Description: Contains declarations of the payload buffer pools. Every
+                    test execution process has a pool mapped and faulted in
+                    before it is forked, test cases take their payload
+                    buffers from it instead of allocating them.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __BUFFER_POOL_H__
+#define __BUFFER_POOL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "testStruct.h"
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Kilobytes of the pool of a test execution process, 0 for no pools */
+#define BUFFER_POOL_KB_KEY          "BUFFER_POOL_KB"
+#define BUFFER_POOL_DEFAULT_KB      0
+
+/* Contents of the pools (BUFFER_POOL_PATTERN), see aPattern */
+#define BUFFER_POOL_PATTERN_KEY     "BUFFER_POOL_PATTERN"
+#define BUFFER_POOL_DEFAULT_PATTERN "NONE"
+
+/* Buffers start on a cache line */
+#define BUFFER_ALIGN                64
+
+/* Buffers a test case may take by name */
+#define BUFFER_MAX_NAMED            8
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+/* Contents a pool is filled with, byte at a position of the pool */
+typedef enum buffer_pattern
+{
+    E_BUFFER_NONE,                          /* Left as the last case wrote */
+    E_BUFFER_ZERO,                          /* 0 */
+    E_BUFFER_SEQUENCE,                      /* Position modulo 256 */
+    E_BUFFER_RANDOM                         /* Pseudo random of the position */
+}E_BUFFER_PATTERN;
+
+/* Pool of one test execution process, kept in shared memory so that a
+ * process restarted after a crash refills what the crashed one used
+ */
+typedef struct buffer_slot
+{
+    uint64_t uDirty;                        /* Bytes handed out since the
+                                               last fill */
+}sBufferSlot_t;
+
+/* Buffer taken by the running test case */
+typedef struct buffer_named
+{
+    char szName[30];                        /* Name given to bufferGet */
+    uint64_t uOffset;                       /* Position in the pool */
+    size_t uSize;                           /* Bytes asked for */
+}sBufferNamed_t;
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int bufferPoolCreate(unsigned int uSlots);
+void bufferPoolDestroy(void);
+void bufferPoolBind(unsigned int uSlot);
+void bufferPoolBegin(void);
+
+#endif //__BUFFER_POOL_H__
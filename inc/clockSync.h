@@ -0,0 +1,86 @@
+/**=============================================================================
+  $Workfile: clockSync.h $
+
+  File Description: Contains declarations of the clock synchronization of
+                    master and slave. The slave estimates the offset and
+                    drift of the clock of master over the control connection,
+                    master takes the estimate from the slave. Test cases
+                    convert the timestamps of the other machine through it.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __CLOCK_SYNC_H__
+#define __CLOCK_SYNC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Milliseconds between two rounds, 0 disables the synchronization */
+#define CLOCK_SYNC_INTERVAL_KEY     "CLOCK_SYNC_INTERVAL"
+#define CLOCK_SYNC_DEFAULT_INTERVAL 10000
+
+/* Request/reply exchanges of a round, the one with the shortest round trip
+ * gives the offset of the round
+ */
+#define CLOCK_SYNC_SAMPLES          8
+
+/* Rounds the drift is fitted over */
+#define CLOCK_SYNC_POINTS           8
+
+/* Drift allowed between two crystal clocks, 1000 ppm */
+#define CLOCK_SYNC_MAX_DRIFT        1e-3
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+/* Clock of the other machine, remote = RemoteRef + (local - LocalRef) * Rate */
+typedef struct clock_estimate
+{
+    uint64_t uLocalRefNs;                   /* Local time of the reference */
+    uint64_t uRemoteRefNs;                  /* Remote time of the reference */
+    double dRate;                           /* Remote seconds per local one */
+    uint64_t uErrorNs;                      /* Half the best round trip */
+    uint32_t uRounds;                       /* Rounds taken, 0 for none */
+}sClockEstimate_t;
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int clockSyncCreate(unsigned int uSlots);
+void clockSyncDestroy(void);
+void clockSyncBind(unsigned int uSlot);
+void clockSyncReset(unsigned int uSlot);
+bool clockSyncRead(unsigned int uSlot, sClockEstimate_t *pEstimate);
+bool clockSyncToLocal(unsigned int uSlot, uint64_t uRemoteNs,
+    uint64_t *puLocalNs, uint64_t *puErrorNs);
+bool clockSyncToRemote(unsigned int uSlot, uint64_t uLocalNs,
+    uint64_t *puRemoteNs);
+uint64_t clockSyncNow(void);
+bool clockSyncDue(void);
+unsigned int clockSyncReply(uint64_t uReceivedNs, unsigned char *pPayload);
+void clockSyncSample(uint64_t uSentNs, const unsigned char *pPayload,
+    unsigned int uLength, uint64_t uReceivedNs);
+unsigned int clockSyncRound(unsigned char *pPayload);
+void clockSyncApply(unsigned int uSlot, const unsigned char *pPayload,
+    unsigned int uLength);
+
+#endif //__CLOCK_SYNC_H__
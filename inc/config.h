@@ -0,0 +1,62 @@
+/**=============================================================================
+  $Workfile: config.h $
+
+  File Description: Contains declarations of the configuration cache. The
+                    configuration files are parsed once at start up into a
+                    key/value hash table which the framework and the test
+                    case shared objects look values up in.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __CONFIG_H__
+#define __CONFIG_H__
+
+#include <stdbool.h>
+
+#include "uthash.h"
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+#define TESTFW_CFG              "testFWCfg.xml"
+#define TEST_CASE_CFG           "test_cfg.xml"
+
+#define CONFIG_KEY_LEN          64
+#define CONFIG_VALUE_LEN        128
+#define CONFIG_MAX_FILES        4
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+/* Configuration value, keyed by the element name */
+typedef struct config_entry
+{
+    char szKey[CONFIG_KEY_LEN];             /* Element name - key */
+    char szValue[CONFIG_VALUE_LEN];         /* Text of the element */
+    UT_hash_handle hh;                      /* Hash table handle */
+}sConfigEntry_t;
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int configLoad(const char *pszFile, bool bRequired);
+const char *configLookup(const char *pszKey);
+void configFree(void);
+
+#endif //__CONFIG_H__
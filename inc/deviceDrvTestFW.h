@@ -32,9 +32,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef  __DEVICE_DRV_TEST_FW_H__
 #define  __DEVICE_DRV_TEST_FW_H__
 
+#include <stdint.h>
+
 #include "testStruct.h"
 #include "uthash.h"
 #include "console.h"
+#include "logger.h"
 
 /*------------------------ D E F I N E S   S E C T I O N ---------------------*/
 
@@ -45,8 +48,84 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SLAVE           "Slave"
 #define MASTER          "Master"
 #define STANDALONE      "Standalone"
+#define COORDINATOR     "Coordinator"
 #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
 
+/* Handshake frame layout:
+ * Length(2) | Slave Id | Msg type | Sequence number(2) | Payload | Checksum(2)
+ * Multi byte fields are little endian, the length covers the complete frame.
+ * Master answers the requests in order, a reply carries the sequence number
+ * of its request.
+ */
+#define FW_MSG_HEADER_LEN       6
+#define FW_MSG_CHECKSUM_LEN     2
+#define FW_MAX_MSG_LEN          0xFFFF
+#define FW_MAX_PAYLOAD_LEN      (FW_MAX_MSG_LEN - FW_MSG_HEADER_LEN - \
+                                    FW_MSG_CHECKSUM_LEN)
+
+/* Handshake stream buffers, room for a packet next to a partial one */
+#define FW_RX_BUFFER_LEN        (2 * FW_MAX_MSG_LEN)
+#define FW_TX_BUFFER_LEN        (2 * FW_MAX_MSG_LEN)
+
+/* Manifest record kinds, each record is Kind | Name length | Name */
+#define MANIFEST_SUITE_RECORD   'S'
+#define MANIFEST_CASE_RECORD    'C'
+
+/* Test result sent by slave once a case is settled, Test id(4) followed by
+ * the payload Status | Elapsed time in nanoseconds(8). Master does not
+ * answer it.
+ */
+#define FW_TST_RESULT_LEN       9
+
+/* Clock request of slave has no payload, the reply of master carries
+ * Received time(8) | Sent time(8) of its CLOCK_MONOTONIC. The estimate
+ * taken from a round of requests is sent to master, which does not answer
+ * it, as Reference time(8) | Offset(8) | Drift in 10^-12(8) | Error(8).
+ */
+#define FW_CLOCK_SYNC_LEN       16
+#define FW_CLOCK_ESTIMATE_LEN   32
+
+/* Run request of a case started at a scheduled time carries the start time
+ * on the clock of master, Test id(4) | Start time(8). The status reply of
+ * master then carries the time its case started, Status | Start time(8).
+ */
+#define FW_START_TIME_LEN       8
+
+/* Requests sent by slave without waiting for the reply (PIPELINE_WINDOW) */
+#define FW_DEFAULT_PIPELINE_WINDOW  4
+#define FW_MAX_PIPELINE_WINDOW      32
+
+/* Test execution processes in standalone mode (STANDALONE_WORKERS) */
+#define FW_MAX_WORKERS              16
+
+/* Slaves connected to master at the same time, slave ids are 1..255 */
+#define FW_MAX_SLAVES               16
+#define FW_MAX_SLAVE_ID             255
+
+/* Measured iterations of a test case (aTestCaseAttr) */
+#define FW_MAX_ITERATIONS           1000000
+
+/* Kernel statistics taken around a test case, names from IRQ_NAMES,
+ * SOFTIRQ_NAMES and NET_INTERFACES in test_cfg.xml
+ */
+#define FW_MAX_IRQ_NAMES            8
+#define FW_MAX_SOFTIRQ_NAMES        4
+#define FW_MAX_NET_INTERFACES       4
+#define FW_STAT_NAME_SIZE           32
+
+/* Test cases appended to the report between two flushes to the file */
+#define REPORT_FLUSH_INTERVAL       32
+
+/* Log a message through the asynchronous logger. Log types above
+ * FW_LOG_LEVEL are compiled out together with their arguments.
+ */
+#define deviceDrvTstFWDebug(nType, ...) \
+    do \
+    { \
+        if ((nType) <= FW_LOG_LEVEL) \
+            loggerWrite((nType), __VA_ARGS__); \
+    } while (0)
+
 /*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
 
 /* Master-Slave communication messages */
@@ -62,7 +141,12 @@ typedef enum
     E_MSG_ACK,
     E_MSG_NACK,
     E_MSG_STATUS,
-    E_MSG_CLOSE
+    E_MSG_CLOSE,
+    E_MSG_TST_MANIFEST,
+    E_MSG_TST_MANIFEST_RSLT,
+    E_MSG_TST_RESULT,
+    E_MSG_CLOCK_SYNC,
+    E_MSG_CLOCK_ESTIMATE
 }E_MSG_TYPE;
 
 typedef enum
@@ -94,27 +178,152 @@ typedef E_TST_STATUS (*pTestCaseFuncPtr)(void);
 /* Test case cleanup function pointer */
 typedef E_TST_STATUS (*pCleanupFuncPtr)(void);
 
-/* Test case data structure */
-typedef struct framework_test_case
+/* Latency of the measured iterations of a test case, in nanoseconds. The
+ * percentiles are nearest rank.
+ */
+typedef struct test_latency
+{
+    uint32_t uIterations;                   /* Iterations measured, 0 if the
+                                               case ran once */
+    uint32_t uWarmup;                       /* Runs before the measured ones */
+    uint64_t uMinNs;
+    uint64_t uMeanNs;
+    uint64_t uP50Ns;
+    uint64_t uP99Ns;
+    uint64_t uMaxNs;
+    uint64_t uStdDevNs;
+}sLatency_t;
+
+/* Limits of a benchmark case (aBenchmarkAttr) */
+typedef struct test_benchmark
+{
+    bool bEnabled;                          /* Case is a benchmark */
+    unsigned int uDurationMs;               /* Run time, 0 for no limit */
+    uint64_t uByteBudget;                   /* Bytes, 0 for no limit */
+    double dMinMBps;                        /* Minimum throughput */
+    double dMinMessagesPerSec;              /* Minimum message rate */
+}sBenchmark_t;
+
+/* Data moved by a benchmark case, what it cost and the minimums it was
+ * held to
+ */
+typedef struct test_throughput
+{
+    uint64_t uBytes;                        /* Bytes counted */
+    uint64_t uMessages;                     /* Messages counted */
+    uint64_t uElapsedNs;                    /* Time of the calls */
+    uint64_t uCpuNs;                        /* CPU time of the process */
+    uint32_t uCalls;                        /* Calls of the case, 0 if the
+                                               case is not a benchmark */
+    double dMinMBps;                        /* Minimum throughput */
+    double dMinMessagesPerSec;              /* Minimum message rate */
+}sThroughput_t;
+
+typedef enum
+{
+    E_USAGE_NONE = 0,
+    E_USAGE_STARTED,                        /* Snapshot at the case start */
+    E_USAGE_DONE                            /* Used by the case */
+}E_USAGE_STATE;
+
+/* Resources used by a test case, taken by the test execution process. While
+ * the case runs the fields hold the totals of the process at its start.
+ */
+typedef struct test_usage
+{
+    uint32_t uState;                        /* E_USAGE_STATE */
+    uint32_t bCounters;                     /* Perf counters were read */
+    uint64_t uUserNs;                       /* User CPU time */
+    uint64_t uSystemNs;                     /* System CPU time */
+    uint64_t uVoluntarySwitches;            /* Waits, for I/O or a lock */
+    uint64_t uInvoluntarySwitches;          /* Preemptions */
+    uint64_t uMinorFaults;
+    uint64_t uMajorFaults;                  /* Faults which needed I/O */
+    uint64_t uInBlocks;                     /* File system reads */
+    uint64_t uOutBlocks;                    /* File system writes */
+    uint64_t uMaxRssKb;                     /* Growth of the peak RSS */
+    uint64_t uCycles;                       /* Perf counters, user space */
+    uint64_t uInstructions;
+    uint64_t uCacheMisses;
+}sUsage_t;
+
+/* Traffic of a network interface, from /proc/net/dev */
+typedef struct test_net_stat
+{
+    uint64_t uRxBytes;
+    uint64_t uRxPackets;
+    uint64_t uRxDrops;
+    uint64_t uTxBytes;
+    uint64_t uTxPackets;
+    uint64_t uTxDrops;
+}sNetStat_t;
+
+/* Interrupts and traffic during a test case, in the order of the names
+ * configured. While the case runs the fields hold the totals at its start.
+ */
+typedef struct test_irq_stat
 {
-    int nTestCaseIden;
-    unsigned char szName[30];               /* Test case name  - key */
-    unsigned int uTimeout;                  /* Timeout in seconds */
-    pTestCaseFuncPtr fnPtrTestCase;         /* Test case function pointer */
-    E_TST_STATUS eStatus;                   /* Test case status */
-    double dElapsedTime;                    /* Test case execution time */
-    UT_hash_handle hh;						/* Hash table handle */
-}sTestCase_t;
-
-/* Test suite data structure */
-typedef struct framework_test_suite
+    uint32_t uState;                        /* E_USAGE_STATE */
+    uint64_t auIrq[FW_MAX_IRQ_NAMES];       /* /proc/interrupts, all CPUs */
+    uint64_t auSoftIrq[FW_MAX_SOFTIRQ_NAMES];   /* /proc/softirqs */
+    sNetStat_t aNet[FW_MAX_NET_INTERFACES]; /* /proc/net/dev */
+}sIrqStat_t;
+
+/* Start of a case run at a time scheduled by slave (START_BARRIER_US) */
+typedef struct start_barrier
 {
-    unsigned char szName[30];               /* Test suite name */
-    E_TST_STATUS eStatus;                   /* Test suite status */
-    pCleanupFuncPtr fnPtrCleanup;           /* Test suite cleanup function ptr*/
-    UT_hash_handle hh;						/* Hash table handle */
-    sTestCase_t *sTestCaseList;				/* Pointer to test case list */
-}sTestSuite_t;
+    bool bScheduled;                        /* Case waited for its start */
+    bool bSkewKnown;                        /* Start of master received */
+    uint64_t uStartNs;                      /* Local CLOCK_MONOTONIC start */
+    int64_t nLateNs;                        /* Start after the scheduled
+                                               time */
+    int64_t nSkewNs;                        /* Start of master minus the
+                                               local start */
+    uint64_t uErrorNs;                      /* Error bound of the skew */
+}sStartBarrier_t;
+
+/* Test registry, structure of arrays. Cases of a suite are consecutive, in
+ * the order of aTestSuite, and test case nTestCaseIden is at case index
+ * nTestCaseIden - 1. Fields read while scheduling are in arrays of their own
+ * so that walking the cases touches only them, names are looked up through
+ * the name index.
+ */
+typedef struct test_registry
+{
+    unsigned int uNumberOfSuites;           /* Suites in the registry */
+    unsigned int uNumberOfCases;            /* Cases in the registry */
+
+    /* Suite fields, by suite index */
+    unsigned int *puFirstCase;              /* Index of the first case */
+    unsigned int *puCaseCount;              /* Number of cases */
+    E_TST_STATUS *peSuiteStatus;            /* Test suite status */
+    bool *pbParallel;                       /* Cases may run in parallel */
+    pCleanupFuncPtr *pfnCleanup;            /* Test suite cleanup function */
+    unsigned char (*pszSuiteName)[30];      /* Test suite name */
+
+    /* Case fields, by case index */
+    E_TST_STATUS *peStatus;                 /* Test case status */
+    unsigned int *puTimeout;                /* Timeout in milliseconds */
+    pTestCaseFuncPtr *pfnTestCase;          /* Test case function */
+    unsigned int *puSuite;                  /* Suite index of the case */
+    double *pdElapsedTime;                  /* Test case execution time */
+    unsigned int *puIterations;             /* Measured runs, 0 runs once */
+    unsigned int *puWarmup;                 /* Runs before the measured ones */
+    sLatency_t *pLatency;                   /* Latency of the iterations */
+    sBenchmark_t *pBenchmark;               /* Limits of a benchmark */
+    sThroughput_t *pThroughput;             /* Throughput of a benchmark */
+    sUsage_t *pUsage;                       /* Resources used by the case */
+    sIrqStat_t *pIrqStat;                   /* Interrupts during the case */
+    sStartBarrier_t *pStartBarrier;         /* Scheduled start of the case */
+    unsigned char *puHistogramSlot;         /* Histogram slot + 1 of the
+                                               process which ran the case,
+                                               0 if none */
+    unsigned char (*pszCaseName)[30];       /* Test case name */
+}sTestRegistry_t;
+
+/* One past the last case of a suite */
+#define REGISTRY_SUITE_END(uSuite) \
+    (g_Registry.puFirstCase[uSuite] + g_Registry.puCaseCount[uSuite])
 
 /* Test summary data structure */
 typedef struct framework_test_summary
@@ -139,6 +348,14 @@ typedef struct framework_test_summary
 
     /* Total number of test suites not found */
     unsigned int uNumberOfSuitesNotFound;
+
+    /* Seconds from the first case scheduled till all are settled, 0 if not
+     * measured
+     */
+    double dMakespan;
+
+    /* Shortest makespan possible for the durations of the run */
+    double dIdealMakespan;
 }sTestSummary_t;
 
 /* Eth0 handshake message struct */
@@ -146,21 +363,29 @@ typedef struct handshake_msg
 {
     unsigned int uSlaveId;              /* Slave Id */
     E_MSG_TYPE eMsgType;                /* Message Type */
+    unsigned short uSeqNo;              /* Sequence number */
 	union{
         unsigned char szName[30];  		/* Test case or Test suite name */
         E_TST_STATUS eStatus;			/* Status of the command */
+        unsigned int uTestId;           /* Test case to be run */
     }Msg;
+    unsigned char *pPayload;            /* Manifest records or result bitmap */
+    unsigned int uPayloadLength;        /* Length of the payload in bytes */
 }sHandshakeMsg_t;
 
-/* Inter-process communication msg struct */
-typedef struct inter_process_msg
+/* Handshake connection. Packets are parsed in place in the receive buffer
+ * and queued in the transmit buffer till they are flushed.
+ */
+typedef struct framework_link
 {
-       int nType;						/* Type */
-       char szBuffer[30];				/* Test case name */
-       sTestCase_t *pTestcase;			/* Pointer to test case */
-       E_TST_STATUS eStatus;			/* Status of test case execution */
-
-}sInterProcessMsg_t;
+    int nSockfd;                                /* Connected socket */
+    bool bClosed;                               /* Send failed */
+    unsigned char szRxBuffer[FW_RX_BUFFER_LEN]; /* Handshake stream received */
+    unsigned int uRxHead, uRxTail;              /* Next packet, end of
+                                                   received data */
+    unsigned char szTxBuffer[FW_TX_BUFFER_LEN]; /* Packets queued for sending */
+    unsigned int uTxLength;                     /* Length of queued packets */
+}sLink_t;
 
 /*------------------ G L O B A L   D E C L A R A T I O N S -------------------*/
 
@@ -168,38 +393,57 @@ bool g_bWriteToConsole;
 
 bool g_bConsoleInitialized;
 
-bool g_bTimerCreationFlag;
-
 sTestSummary_t *g_pSummary;	            /* Pointer to summary */
-sTestSuite_t *g_pSuiteHead;             /* Pointer to test suite */
+sTestRegistry_t g_Registry;             /* Test suites and test cases */
 
-timer_t g_timerId;                      /* Timer Id */
+unsigned int g_uPipelineWindow;         /* Requests in flight, slave only */
 
-bool bGenerateReport;
+unsigned int g_uStartBarrierUs;         /* Microseconds from the run request
+                                           to the scheduled start, 0 starts
+                                           at once, slave only */
+
+unsigned int g_uWorkerCount;            /* Test execution processes,
+                                           standalone only */
+
+unsigned int g_uMasterSlaves;           /* Slave sessions served before
+                                           exit, 0 for no limit, master
+                                           only */
+
+bool g_bCoordinator;                    /* Master splits the cases of its
+                                           shared object among the slaves */
+
+unsigned int g_uSlaveId;                /* Id of the slave at master, 0 to
+                                           take the one given by master,
+                                           slave only */
 
 
 /*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
 
-void deviceDrvTstFWDebug(int ntype, char *pszMsg, ...);
-int getTokenValue(char *pszFile, const char *pszToken, unsigned char *pszValue);
+int getTokenValue(char *pszFile, const char *pszToken, unsigned char *pszValue,
+    size_t uSize);
 void createSocket(void);
 int loadSharedObject(void);
 int initializeTestSummary(void);
 int addSuitesAndCases(void);
+void applySuiteAttributes(void);
+void applyCaseAttributes(void);
+void applyBenchmarkAttributes(void);
 int initializeTestFramework(void);
 
 int constructFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szOutBuffer[]);
-void parseFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szInBuffer[]);
+int parseFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szInBuffer[]);
 unsigned short int calculateChecksum(unsigned char *pszBuffer,
     unsigned int uLength);
-void sendMessage(sHandshakeMsg_t *pMsg);
-int receiveMessage(sHandshakeMsg_t *pMsg);
+void sendMessage(sLink_t *pLink, sHandshakeMsg_t *pMsg);
+int flushMessages(sLink_t *pLink);
+bool isMessageBuffered(sLink_t *pLink);
+int receiveMessage(sLink_t *pLink, sHandshakeMsg_t *pMsg);
 
 void generateFileName(void);
-void generateXMLReport(void);
-
-int peek(void);
-uint64_t checkTimer(timer_t *pTimerID, unsigned int nMsec, bool bSet);
+void openXMLReport(void);
+void reportTestCase(unsigned int uCase);
+void reportTestSuiteNotFound(unsigned int uSuite);
+void closeXMLReport(void);
 
 void printUsage(void);
 void printHeader(void);
@@ -0,0 +1,84 @@
+/**=============================================================================
+  $Workfile: histogram.h $
+
+  File Description: Contains declarations of the latency histograms recorded
+                    by the test cases. Every test execution process records in
+                    its own slot of a shared mapping, the scheduler writes the
+                    histograms of a test case in the report.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __HISTOGRAM_H__
+#define __HISTOGRAM_H__
+
+#include <stdint.h>
+
+#include "testStruct.h"
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Every power of two range of values is split in HISTOGRAM_SUB_BUCKETS
+ * buckets, a value is recorded with a relative error below 1/32. Values
+ * below HISTOGRAM_SUB_BUCKETS have a bucket each.
+ */
+#define HISTOGRAM_SUB_BITS      5
+#define HISTOGRAM_SUB_BUCKETS   (1U << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS       ((64 - HISTOGRAM_SUB_BITS + 1) * \
+                                    HISTOGRAM_SUB_BUCKETS)
+
+/* Histograms a test case may record */
+#define HISTOGRAM_MAX_SERIES    4
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+/* One histogram, updated with relaxed atomics so that the threads of a test
+ * case may record in it at the same time
+ */
+struct test_histogram
+{
+    char szName[30];                        /* Name given to histogramGet */
+    uint64_t uCount;                        /* Values recorded */
+    uint64_t uSum;                          /* Sum of the values, for mean */
+    uint64_t uMin;
+    uint64_t uMax;
+    uint64_t auBucket[HISTOGRAM_BUCKETS];   /* Values recorded per bucket */
+};
+
+/* Histograms of the test case run by one test execution process */
+typedef struct histogram_slot
+{
+    uint32_t uSeries;                       /* Histograms in use */
+    sTestHistogram_t aSeries[HISTOGRAM_MAX_SERIES];
+}sHistogramSlot_t;
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int histogramCreate(unsigned int uSlots);
+void histogramDestroy(void);
+void histogramBind(unsigned int uSlot);
+void histogramBegin(void);
+const sHistogramSlot_t *histogramSlot(unsigned int uSlot);
+uint64_t histogramBucketValue(unsigned int uBucket);
+uint64_t histogramPercentile(const sTestHistogram_t *pHistogram,
+    double dPercentile);
+
+#endif //__HISTOGRAM_H__
@@ -0,0 +1,63 @@
+/**=============================================================================
+  $Workfile: irqStat.h $
+
+  File Description: Contains declarations of the kernel statistics taken
+                    around every test case, the interrupts, softirqs and
+                    network interface traffic named in test_cfg.xml.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __IRQ_STAT_H__
+#define __IRQ_STAT_H__
+
+#include "deviceDrvTestFW.h"
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Names in test_cfg.xml, separated by commas or spaces. An IRQ name is the
+ * number or the name before the colon in /proc/interrupts, or a device name
+ * of the action list at the end of the line, which also matches the queues
+ * of the device, e.g. eth0 matches eth0-rx-0 but not eth01.
+ */
+#define IRQ_STAT_IRQ_KEY        "IRQ_NAMES"
+#define IRQ_STAT_SOFTIRQ_KEY    "SOFTIRQ_NAMES"
+#define IRQ_STAT_NET_KEY        "NET_INTERFACES"
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+typedef enum
+{
+    E_STAT_IRQ = 0,
+    E_STAT_SOFTIRQ,
+    E_STAT_NET,
+    E_STAT_KINDS
+}E_STAT_KIND;
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+void irqStatLoad(void);
+unsigned int irqStatCount(E_STAT_KIND eKind);
+const char *irqStatName(E_STAT_KIND eKind, unsigned int uName);
+void irqStatBegin(sIrqStat_t *pStat);
+void irqStatEnd(sIrqStat_t *pStat);
+
+#endif //__IRQ_STAT_H__
@@ -0,0 +1,66 @@
+/**=============================================================================
+  $Workfile: logger.h $
+
+  File Description: Contains declarations of the asynchronous debug logger.
+                    Log calls copy the format, a raw timestamp and the
+                    arguments into a per thread ring, a drainer thread
+                    formats them and writes to stderr or the debug log file.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __LOGGER_H__
+#define __LOGGER_H__
+
+#include <stdbool.h>
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Highest log type compiled in, 1 keeps LOG_TO_USR messages only and drops
+ * the LOG_TO_DBG calls at compile time. Set by the Makefile (LOG_LEVEL).
+ */
+#ifndef FW_LOG_LEVEL
+#define FW_LOG_LEVEL            2
+#endif
+
+/* Messages queued per thread before the caller waits for the drainer */
+#define LOGGER_RING_ENTRIES     512
+
+/* Arguments and string bytes captured per message */
+#define LOGGER_MAX_ARGS         12
+#define LOGGER_ENTRY_LEN        512
+
+/* Formatted output collected by the drainer before a write() */
+#define LOGGER_OUTPUT_LEN       (64 * 1024)
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+extern bool g_bDebugLogFlag;            /* Debug log file in use */
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int loggerInit(void);
+void loggerWrite(int nType, const char *pszMsg, ...)
+    __attribute__((format(printf, 2, 3)));
+void loggerFlush(void);
+void loggerClose(void);
+
+#endif
@@ -0,0 +1,51 @@
+/**=============================================================================
+  $Workfile: nameIndex.h $
+
+  File Description: Contains declarations of the test name index. A minimal
+                    perfect hash over the suite and case names of the
+                    registry is built once the shared object is loaded,
+                    every name is found with one probe.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __NAME_INDEX_H__
+#define __NAME_INDEX_H__
+
+#include <stdint.h>
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Displacement seeds tried for a bucket before the build gives up */
+#define NAME_INDEX_MAX_SEED     (1U << 20)
+
+/* Slot not assigned yet */
+#define NAME_INDEX_FREE         0xFFFFFFFFU
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int nameIndexBuild(void);
+void nameIndexFree(void);
+int findTestSuite(const unsigned char *pszName, unsigned int uNameLength);
+int findTestCase(unsigned int uSuite, const unsigned char *pszName,
+    unsigned int uNameLength);
+
+#endif //__NAME_INDEX_H__
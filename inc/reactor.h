@@ -0,0 +1,57 @@
+/**=============================================================================
+  $Workfile: reactor.h $
+
+  File Description: Contains declarations of the epoll based event reactor,
+                    which waits on the control socket, the socket pair to the
+                    child process and the test timer in a single call
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+
+
+#ifndef __REACTOR_H__
+#define __REACTOR_H__
+
+#include <stdint.h>
+#include <sys/epoll.h>
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+#define REACTOR_MAX_EVENTS      16
+#define REACTOR_WAIT_FOREVER    -1
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+/* Event handler function pointer */
+typedef void (*pEventHandlerFuncPtr)(int nFd, uint32_t uEvents, void *pArg);
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int reactorInit(void);
+int reactorAdd(int nFd, uint32_t uEvents, pEventHandlerFuncPtr fnPtrHandler,
+    void *pArg);
+int reactorModify(int nFd, uint32_t uEvents);
+int reactorRemove(int nFd);
+int reactorDispatch(int nTimeoutMs, int nMaxEvents);
+void reactorClose(void);
+
+#endif //__REACTOR_H__
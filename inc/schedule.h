@@ -0,0 +1,60 @@
+/**=============================================================================
+  $Workfile: schedule.h $
+
+  File Description: Contains declarations of the duration aware scheduling.
+                    The durations of the test cases are kept in a history file
+                    next to the reports and the cases of a parallel suite are
+                    scheduled in the order of the configured policy.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __SCHEDULE_H__
+#define __SCHEDULE_H__
+
+#include <stdbool.h>
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Duration history, one line per test case: Suite, Case and the durations in
+ * seconds of its last runs separated by tabs, the durations separated by
+ * spaces, newest last
+ */
+#define SCHEDULE_HISTORY_FILE       "Test_Durations.txt"
+
+/* Durations kept per test case */
+#define SCHEDULE_HISTORY_SAMPLES    8
+
+/* Policy used when SCHEDULE_ORDER is not configured */
+#define SCHEDULE_DEFAULT_ORDER      "LONGEST_FIRST"
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int scheduleLoad(void);
+double scheduleEstimate(unsigned int uCase);
+bool scheduleHasHistory(unsigned int uCase);
+unsigned int scheduleCase(unsigned int uPosition);
+void scheduleStart(void);
+void scheduleFinish(unsigned int uLanes);
+void scheduleSave(void);
+void scheduleFree(void);
+
+#endif //__SCHEDULE_H__
@@ -32,6 +32,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __TEST_STRUCT__H__
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 
 #define TEST_SUITE_END  "EOL"
 #define TEST_CASE_END   "EOL"
@@ -39,7 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 typedef struct user_test_case
 {
     unsigned char szName[30];
-    unsigned int uTimeout;
+    unsigned int uTimeout;      /* Timeout in milliseconds */
     char *pTestCaseFuncName;
 }sUserTestCase_t;
 
@@ -50,4 +52,98 @@ typedef struct user_test_suite
     sUserTestCase_t *pTestCase;
 }sUserTestSuite_t;
 
+/* Optional array aTestSuiteAttr, terminated by TEST_SUITE_END. Suites not
+ * listed keep the default attributes.
+ */
+typedef struct user_test_suite_attr
+{
+    unsigned char szName[30];
+    bool bParallel;             /* Standalone, cases may run side by side */
+}sUserTestSuiteAttr_t;
+
+/* Optional array aTestCaseAttr, terminated by TEST_CASE_END in szName. Cases
+ * not listed run once. A case with iterations is run uWarmup times, then
+ * uIterations times with the latency of every iteration measured, and stops
+ * at the first run which does not pass. The timeout covers all the runs.
+ */
+typedef struct user_test_case_attr
+{
+    unsigned char szName[30];
+    unsigned char szSuiteName[30];
+    unsigned int uIterations;   /* Measured runs, 0 runs once */
+    unsigned int uWarmup;       /* Runs before the measured ones */
+}sUserTestCaseAttr_t;
+
+/* Optional array aBenchmarkAttr, terminated by TEST_CASE_END in szName. A
+ * case listed is a throughput benchmark: its function is called again and
+ * again, each call moving a batch of data counted through benchmarkCount,
+ * till uDurationMs passed or uByteBudget bytes were counted, whichever comes
+ * first. With neither limit it is called once. The case fails when it
+ * moves less than the minimums, 0 for no minimum. The timeout covers all
+ * the calls.
+ */
+typedef struct user_benchmark_attr
+{
+    unsigned char szName[30];
+    unsigned char szSuiteName[30];
+    unsigned int uDurationMs;   /* Run time, 0 for no limit */
+    uint64_t uByteBudget;       /* Bytes to move, 0 for no limit */
+    double dMinMBps;            /* Minimum megabytes (10^6) per second */
+    double dMinMessagesPerSec;  /* Minimum messages per second */
+}sUserBenchmarkAttr_t;
+
+/* Values of testFWCfg.xml and test_cfg.xml, parsed once when the framework
+ * starts. Exported by testFW, test cases call them instead of reading the
+ * XML files. getConfigValue returns NULL for a key which is not configured.
+ */
+const char *getConfigValue(const char *pszKey);
+long getConfigNumber(const char *pszKey, long lDefault);
+
+/* Latency histograms, exported by testFW. A test case gets a histogram by
+ * name, up to 4 per case, and records values in it, e.g. round trip times in
+ * nanoseconds. The histograms are written in the report with the result of
+ * the case. histogramGet is meant to be called before the test case starts
+ * its threads, histogramRecord is lock free and may be called from any of
+ * them. histogramGet returns NULL when no more histograms are left, and
+ * histogramRecord ignores a NULL histogram.
+ */
+typedef struct test_histogram sTestHistogram_t;
+
+sTestHistogram_t *histogramGet(const char *pszName);
+void histogramRecord(sTestHistogram_t *pHistogram, uint64_t uValue);
+
+/* Data moved by a benchmark case, exported by testFW. Lock free, may be
+ * called from any thread of the test case.
+ */
+void benchmarkCount(uint64_t uBytes, uint64_t uMessages);
+
+/* Clock of the other machine, exported by testFW. In master/slave mode the
+ * offset and drift of the CLOCK_MONOTONIC of the other machine are estimated
+ * over the control connection, at the handshake and every
+ * CLOCK_SYNC_INTERVAL milliseconds between test cases. clockToLocal converts
+ * a CLOCK_MONOTONIC timestamp taken on the other machine, e.g. carried in a
+ * CAN frame, to the local clock, so that one way latency can be measured.
+ * The error bound of the estimate is given in puErrorNs unless it is NULL.
+ * It returns -1 when there is no estimate, as in standalone mode.
+ */
+int clockToLocal(uint64_t uRemoteNs, uint64_t *puLocalNs, uint64_t *puErrorNs);
+
+/* Payload buffers, exported by testFW. With BUFFER_POOL_KB configured every
+ * test execution process has a pool of that many kilobytes, mapped and
+ * faulted in before the test cases run. bufferGet gives a buffer of the
+ * running test case by name, aligned on a cache line, up to 8 per case. The
+ * same name gives the same buffer in the iterations and benchmark calls of
+ * a case, so the buffers are taken once instead of malloc and memset in the
+ * timed part. It returns NULL when the pool is too small or not configured.
+ * Before each case the pool is filled with BUFFER_POOL_PATTERN, ZERO,
+ * SEQUENCE (position modulo 256) or RANDOM (pseudo random of the position),
+ * the pattern starting at position 0 with the first buffer taken. The
+ * default NONE leaves the bytes as the previous case wrote them.
+ * bufferCheck compares data, e.g. received from the other machine, with the
+ * pattern from a position. bufferGet is meant to be called before the test
+ * case starts its threads.
+ */
+void *bufferGet(const char *pszName, size_t uSize);
+bool bufferCheck(const void *pData, size_t uSize, uint64_t uPosition);
+
 #endif //__TEST_STRUCT__H__
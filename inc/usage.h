@@ -0,0 +1,48 @@
+/**=============================================================================
+  $Workfile: usage.h $
+
+  File Description: Contains declarations of the resource accounting of the
+                    test cases, rusage deltas and perf hardware counters
+                    taken by the test execution process around every case.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __USAGE_H__
+#define __USAGE_H__
+
+#include <sys/resource.h>
+
+#include "deviceDrvTestFW.h"
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Perf counters are opened unless configured 0 */
+#define USAGE_PERF_KEY          "PERF_COUNTERS"
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+void usageOpen(void);
+void usageBegin(sUsage_t *pUsage);
+void usageEnd(sUsage_t *pUsage);
+void usageSettle(sUsage_t *pUsage, const struct rusage *pExitUsage);
+
+#endif //__USAGE_H__
@@ -0,0 +1,75 @@
+/**=============================================================================
+  $Workfile: watchdog.h $
+
+  File Description: Contains declarations of the test watchdog, which tracks
+                    a test execution process through a pidfd and times the
+                    test it runs with a timerfd
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+#ifndef __WATCHDOG_H__
+#define __WATCHDOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+#define WATCHDOG_NSEC_PER_SEC   1000000000ULL
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+typedef struct watchdog sWatchdog_t;
+
+/* Called when the test execution process exits, nStatus as from waitpid */
+typedef void (*pWatchdogFuncPtr)(sWatchdog_t *pWatchdog, int nStatus);
+
+/* Watchdog of one test execution process */
+struct watchdog
+{
+    pid_t nPid;                             /* Test execution process */
+    int nPidFd;                             /* Process file descriptor */
+    int nTimerFd;                           /* Test timer (timerfd) */
+    struct timespec StartTime;              /* Start of the running test */
+    bool bRunning;                          /* Test running */
+    bool bExpired;                          /* Test timed out */
+    struct rusage ExitUsage;                /* Totals of the process which
+                                               exited, from wait4 */
+    pWatchdogFuncPtr fnPtrExitHandler;      /* Called when process exits */
+    void *pArg;                             /* Owner of the watchdog */
+    sWatchdog_t *pNext;                     /* Next watchdog created */
+};
+
+/*------------------- F U N C T I O N   P R O T O T Y P E --------------------*/
+
+int watchdogInit(sWatchdog_t *pWatchdog, pWatchdogFuncPtr fnPtrExitHandler,
+    void *pArg);
+int watchdogAttach(sWatchdog_t *pWatchdog, pid_t nPid);
+void watchdogStart(sWatchdog_t *pWatchdog, unsigned int uMsec);
+uint64_t watchdogStop(sWatchdog_t *pWatchdog);
+void watchdogClose(sWatchdog_t *pWatchdog);
+void watchdogCloseAll(void);
+
+#endif //__WATCHDOG_H__
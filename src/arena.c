@@ -0,0 +1,765 @@
+/**=============================================================================
+  $Workfile: arena.c$
+
+  File Description: Shared result arena. The results of all the test cases
+                    live in a MAP_SHARED mapping created before the test
+                    execution processes are forked. A process writes the
+                    result of the case it runs in place and signals an
+                    eventfd, the scheduler reads the result from the arena,
+                    also when the process was killed in the middle of a test.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <math.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+
+#include "deviceDrvTestFW.h"
+#include "reactor.h"
+#include "arena.h"
+#include "histogram.h"
+#include "benchmark.h"
+#include "usage.h"
+#include "irqStat.h"
+#include "clockSync.h"
+#include "bufferPool.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/* Last part of the wait for a scheduled start which is spun, the sleep
+ * before it may be woken late by the scheduler tick
+ */
+#define ARENA_SPIN_NS	200000
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+static sTestResult_t *g_pResult = MAP_FAILED;   /* Shared results */
+static size_t g_uArenaSize;                     /* Size of the mapping */
+static unsigned int g_uNumberOfResults;
+
+static uint64_t *g_puStampNs;                   /* Iteration times of the
+                                                   test execution process */
+
+/*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
+
+static uint64_t getMonotonicNs(void);
+static void waitForStart(uint64_t uStartAtNs);
+static int compareNs(const void *pLeft, const void *pRight);
+static void computeLatency(uint64_t *puSampleNs, unsigned int uSamples,
+	sLatency_t *pLatency);
+static E_TST_STATUS runTestCase(unsigned int uCase, sTestResult_t *pResult);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : getMonotonicNs
+    Description     : Function to read CLOCK_MONOTONIC, which is the same for
+    				  the scheduler and the test execution processes.
+    Arguments       : None
+    Returns         : Time in nanoseconds
+
+  ============================================================================*/
+
+static uint64_t getMonotonicNs(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (uint64_t)Now.tv_sec * 1000000000ULL + Now.tv_nsec;
+}
+
+
+/**=============================================================================
+
+	Function Name   : waitForStart
+    Description     : Function to wait till the scheduled start of a test
+    				  case. It sleeps till shortly before the start and spins
+    				  the rest of the time. A start already passed returns at
+    				  once.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uStartAtNs		In		CLOCK_MONOTONIC start time
+    Returns         : None
+
+  ============================================================================*/
+
+static void waitForStart(uint64_t uStartAtNs)
+{
+	struct timespec Wake;
+	uint64_t uWakeNs = 0;
+
+	if (uStartAtNs > getMonotonicNs() + ARENA_SPIN_NS)
+	{
+		uWakeNs = uStartAtNs - ARENA_SPIN_NS;
+		Wake.tv_sec = uWakeNs / 1000000000ULL;
+		Wake.tv_nsec = uWakeNs % 1000000000ULL;
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Wake,
+			NULL) == EINTR)
+		{
+		}
+	}
+
+	while (getMonotonicNs() < uStartAtNs)
+	{
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : arenaCreate
+    Description     : Function to map the result arena with one set of
+    				  results per test execution process, a set has one
+    				  result per test case in the list. The result of a test
+    				  case is at index nTestCaseIden - 1 of the set. It has
+    				  to be called before the test execution processes are
+    				  forked.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSets			In		Number of result sets
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int arenaCreate(unsigned int uSets)
+{
+	g_uNumberOfResults = g_pSummary->uNumberOfTests * uSets;
+	g_uArenaSize = g_uNumberOfResults * sizeof(sTestResult_t);
+
+	g_pResult = mmap(NULL, g_uArenaSize, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (g_pResult == MAP_FAILED)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in mapping result arena\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : arenaDestroy
+    Description     : Function to unmap the result arena.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void arenaDestroy(void)
+{
+	if (g_pResult != MAP_FAILED)
+	{
+		munmap(g_pResult, g_uArenaSize);
+		g_pResult = MAP_FAILED;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : arenaBegin
+    Description     : Function called by the test execution process before it
+    				  runs a test case, the start time is visible to the
+    				  scheduler even if the process never finishes the case.
+    				  A case scheduled by arenaSchedule waits for its time.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uIndex			In		Result index
+    Returns         : None
+
+  ============================================================================*/
+
+void arenaBegin(unsigned int uIndex)
+{
+	sTestResult_t *pResult = &g_pResult[uIndex];
+
+	/* Kernel statistics are read outside of the time measured */
+	irqStatBegin(&pResult->IrqStat);
+
+	pResult->uEndNs = 0;
+	pResult->uRunCount++;
+	memset(&pResult->Latency, 0, sizeof(sLatency_t));
+	memset(&pResult->Throughput, 0, sizeof(sThroughput_t));
+
+	/* Started together with the case of the other machine */
+	if (pResult->uStartAtNs != 0)
+	{
+		waitForStart(pResult->uStartAtNs);
+	}
+
+	/* Last before the start, the wait is not counted as used */
+	usageBegin(&pResult->Usage);
+	pResult->uStartNs = getMonotonicNs();
+	__atomic_store_n(&pResult->uState, E_RESULT_RUNNING, __ATOMIC_RELEASE);
+}
+
+
+/**=============================================================================
+
+	Function Name   : arenaPublish
+    Description     : Function called by the test execution process to write
+    				  the status of the test case it ran.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uIndex			In		Result index
+                      @eStatus			In		Execution status
+    Returns         : None
+
+  ============================================================================*/
+
+void arenaPublish(unsigned int uIndex, E_TST_STATUS eStatus)
+{
+	sTestResult_t *pResult = &g_pResult[uIndex];
+
+	pResult->uEndNs = getMonotonicNs();
+	usageEnd(&pResult->Usage);
+	pResult->eStatus = eStatus;
+	irqStatEnd(&pResult->IrqStat);
+	__atomic_store_n(&pResult->uState, E_RESULT_DONE, __ATOMIC_RELEASE);
+}
+
+
+/**=============================================================================
+
+	Function Name   : arenaSchedule
+    Description     : Function called by the scheduler before it posts a test
+    				  case, to have the case started at a given time.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uIndex			In		Result index
+                      @uStartAtNs		In		CLOCK_MONOTONIC start time, 0
+                      						to start at once
+    Returns         : None
+
+  ============================================================================*/
+
+void arenaSchedule(unsigned int uIndex, uint64_t uStartAtNs)
+{
+	g_pResult[uIndex].uStartAtNs = uStartAtNs;
+}
+
+
+/**=============================================================================
+
+	Function Name   : arenaStarted
+    Description     : Function called by the scheduler to read the start time
+    				  of a test case run at a scheduled time. It has to be
+    				  called before arenaCollect, which drops the schedule.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uIndex			In		Result index
+    Returns         : CLOCK_MONOTONIC start time, 0 if the case was not
+    				  scheduled or did not start
+
+  ============================================================================*/
+
+uint64_t arenaStarted(unsigned int uIndex)
+{
+	sTestResult_t *pResult = &g_pResult[uIndex];
+
+	if ((pResult->uStartAtNs == 0) ||
+		(__atomic_load_n(&pResult->uState, __ATOMIC_ACQUIRE) ==
+		E_RESULT_IDLE))
+	{
+		return 0;
+	}
+
+	return pResult->uStartNs;
+}
+
+
+/**=============================================================================
+
+	Function Name   : arenaCollect
+    Description     : Function called by the scheduler to read the result of
+    				  a test case and to reset it for the next run. The
+    				  elapsed time of a case still running is measured from
+    				  its start time.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uIndex			In		Result index
+                      @peStatus			Out		Execution status
+                      @puElapsedNs		Out		Elapsed time in nanoseconds
+                      @nCase			In		Case whose latency, throughput,
+                      						usage, kernel statistics and
+                      						start are copied to the
+                      						registry, -1 for none
+    Returns         : true if the status was written, else false
+
+  ============================================================================*/
+
+bool arenaCollect(unsigned int uIndex, E_TST_STATUS *peStatus,
+    uint64_t *puElapsedNs, int nCase)
+{
+	sTestResult_t *pResult = &g_pResult[uIndex];
+	uint32_t uState = 0;
+
+	uState = __atomic_load_n(&pResult->uState, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&pResult->uState, E_RESULT_IDLE, __ATOMIC_RELAXED);
+
+	if (nCase != -1)
+	{
+		memset(&g_Registry.pLatency[nCase], 0, sizeof(sLatency_t));
+		memset(&g_Registry.pThroughput[nCase], 0, sizeof(sThroughput_t));
+		memset(&g_Registry.pUsage[nCase], 0, sizeof(sUsage_t));
+		memset(&g_Registry.pIrqStat[nCase], 0, sizeof(sIrqStat_t));
+		memset(&g_Registry.pStartBarrier[nCase], 0,
+			sizeof(sStartBarrier_t));
+
+		/* Also known for a case whose process died, once it was settled */
+		if (pResult->Usage.uState == E_USAGE_DONE)
+		{
+			g_Registry.pUsage[nCase] = pResult->Usage;
+		}
+		if (pResult->IrqStat.uState == E_USAGE_DONE)
+		{
+			g_Registry.pIrqStat[nCase] = pResult->IrqStat;
+		}
+		if ((pResult->uStartAtNs != 0) && (uState != E_RESULT_IDLE))
+		{
+			g_Registry.pStartBarrier[nCase].bScheduled = true;
+			g_Registry.pStartBarrier[nCase].uStartNs = pResult->uStartNs;
+			g_Registry.pStartBarrier[nCase].nLateNs =
+				(int64_t)(pResult->uStartNs - pResult->uStartAtNs);
+		}
+	}
+	pResult->uStartAtNs = 0;
+
+	if (uState == E_RESULT_DONE)
+	{
+		*peStatus = pResult->eStatus;
+		*puElapsedNs = pResult->uEndNs - pResult->uStartNs;
+		if (nCase != -1)
+		{
+			g_Registry.pLatency[nCase] = pResult->Latency;
+			g_Registry.pThroughput[nCase] = pResult->Throughput;
+		}
+		return true;
+	}
+
+	*puElapsedNs = (uState == E_RESULT_RUNNING) ?
+		getMonotonicNs() - pResult->uStartNs : 0;
+
+	return false;
+}
+
+
+/**=============================================================================
+
+	Function Name   : arenaSettle
+    Description     : Function called by the scheduler when a test execution
+    				  process died, to get the resources used by the case it
+    				  was running from the totals of the process and to end
+    				  its kernel statistics.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uIndex			In		Result index
+                      @pExitUsage		In		Totals from wait4
+    Returns         : None
+
+  ============================================================================*/
+
+void arenaSettle(unsigned int uIndex, const struct rusage *pExitUsage)
+{
+	usageSettle(&g_pResult[uIndex].Usage, pExitUsage);
+	irqStatEnd(&g_pResult[uIndex].IrqStat);
+}
+
+
+/**=============================================================================
+
+	Function Name   : channelCreate
+    Description     : Function to create the eventfds of a channel. The
+    				  request eventfd is read blocking by the test execution
+    				  process, the done eventfd is registered with the
+    				  reactor of the scheduler.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pChannel			In		Channel
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int channelCreate(sTestChannel_t *pChannel)
+{
+	pChannel->nRequestFd = eventfd(0, EFD_CLOEXEC);
+	pChannel->nDoneFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	if ((pChannel->nRequestFd == -1) || (pChannel->nDoneFd == -1))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating eventfd\n");
+		channelClose(pChannel);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : channelClose
+    Description     : Function to close the eventfds of a channel.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pChannel			In		Channel
+    Returns         : None
+
+  ============================================================================*/
+
+void channelClose(sTestChannel_t *pChannel)
+{
+	if (pChannel->nRequestFd != -1)
+	{
+		close(pChannel->nRequestFd);
+		pChannel->nRequestFd = -1;
+	}
+
+	if (pChannel->nDoneFd != -1)
+	{
+		close(pChannel->nDoneFd);
+		pChannel->nDoneFd = -1;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : channelPost
+    Description     : Function called by the scheduler to schedule a test case
+    				  to the test execution process, only one case is posted
+    				  at a time so the eventfd counter carries the index.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pChannel			In		Channel
+                      @uIndex			In		Result index of the case
+    Returns         : None
+
+  ============================================================================*/
+
+void channelPost(sTestChannel_t *pChannel, unsigned int uIndex)
+{
+	eventfd_write(pChannel->nRequestFd, (eventfd_t)uIndex + 1);
+}
+
+
+/**=============================================================================
+
+	Function Name   : channelWait
+    Description     : Function called by the test execution process to block
+    				  till a test case is scheduled.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pChannel			In		Channel
+                      @puIndex			Out		Result index of the case
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int channelWait(sTestChannel_t *pChannel, unsigned int *puIndex)
+{
+	eventfd_t uValue = 0;
+
+	while (eventfd_read(pChannel->nRequestFd, &uValue) == -1)
+	{
+		if (errno != EINTR)
+		{
+			return -1;
+		}
+	}
+
+	*puIndex = (unsigned int)(uValue - 1);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : channelNotify
+    Description     : Function called by the test execution process once the
+    				  result is published in the arena.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pChannel			In		Channel
+    Returns         : None
+
+  ============================================================================*/
+
+void channelNotify(sTestChannel_t *pChannel)
+{
+	eventfd_write(pChannel->nDoneFd, 1);
+}
+
+
+/**=============================================================================
+
+	Function Name   : channelDrain
+    Description     : Function called by the scheduler to consume the done
+    				  notification.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pChannel			In		Channel
+    Returns         : true if a notification was pending, else false
+
+  ============================================================================*/
+
+bool channelDrain(sTestChannel_t *pChannel)
+{
+	eventfd_t uValue = 0;
+
+	return (eventfd_read(pChannel->nDoneFd, &uValue) == 0);
+}
+
+
+/**=============================================================================
+
+	Function Name   : compareNs
+    Description     : qsort comparator, orders durations in nanoseconds.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pLeft			In		Duration
+                      @pRight			In		Duration
+    Returns         : <0, 0, >0 as qsort expects
+
+  ============================================================================*/
+
+static int compareNs(const void *pLeft, const void *pRight)
+{
+	uint64_t uLeft = *(const uint64_t *)pLeft;
+	uint64_t uRight = *(const uint64_t *)pRight;
+
+	return (uLeft > uRight) - (uLeft < uRight);
+}
+
+
+/**=============================================================================
+
+	Function Name   : computeLatency
+    Description     : Function to compute the latency statistics of the
+    				  measured iterations. The durations are sorted in place,
+    				  the percentiles are nearest rank.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @puSampleNs		In/Out	Duration of every iteration
+                      @uSamples			In		Number of iterations
+                      @pLatency			Out		Latency statistics
+    Returns         : None
+
+  ============================================================================*/
+
+static void computeLatency(uint64_t *puSampleNs, unsigned int uSamples,
+	sLatency_t *pLatency)
+{
+	unsigned int i = 0;
+	double dMean = 0, dSquares = 0, dDelta = 0;
+
+	qsort(puSampleNs, uSamples, sizeof(uint64_t), compareNs);
+
+	for (i = 0; i < uSamples; i++)
+	{
+		dMean += (double)puSampleNs[i];
+	}
+	dMean /= uSamples;
+
+	for (i = 0; i < uSamples; i++)
+	{
+		dDelta = (double)puSampleNs[i] - dMean;
+		dSquares += dDelta * dDelta;
+	}
+
+	pLatency->uIterations = uSamples;
+	pLatency->uMinNs = puSampleNs[0];
+	pLatency->uMeanNs = (uint64_t)dMean;
+	pLatency->uP50Ns = puSampleNs[(uSamples * 50 + 99) / 100 - 1];
+	pLatency->uP99Ns = puSampleNs[(uSamples * 99 + 99) / 100 - 1];
+	pLatency->uMaxNs = puSampleNs[uSamples - 1];
+	pLatency->uStdDevNs = (uint64_t)sqrt(dSquares / uSamples);
+}
+
+
+/**=============================================================================
+
+	Function Name   : runTestCase
+    Description     : Function to run a test case, in iterations if it has
+    				  any, or as a benchmark. The warm-up runs are not measured, then the time is
+    				  read once before the first iteration and after every
+    				  iteration, so an iteration costs a single clock read.
+    				  The times go to the buffer executeTestCases allocated,
+    				  without it the iterations run unmeasured. The runs stop
+    				  at the first one which does not pass.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uCase			In		Case index
+                      @pResult			Out		Latency of the iterations or
+                      						throughput of the benchmark
+    Returns         : Status of the last run
+
+  ============================================================================*/
+
+static E_TST_STATUS runTestCase(unsigned int uCase, sTestResult_t *pResult)
+{
+	sLatency_t *pLatency = &pResult->Latency;
+	pTestCaseFuncPtr pfnTestCase = g_Registry.pfnTestCase[uCase];
+	unsigned int uIterations = g_Registry.puIterations[uCase];
+	unsigned int i = 0;
+	uint64_t *puStampNs = g_puStampNs;
+	E_TST_STATUS eStatus = E_PASSED;
+
+	if (g_Registry.pBenchmark[uCase].bEnabled)
+	{
+		return benchmarkRun(uCase, &pResult->Throughput);
+	}
+
+	if ((uIterations == 0) && (g_Registry.puWarmup[uCase] == 0))
+	{
+		return pfnTestCase();
+	}
+
+	for (i = 0; (i < g_Registry.puWarmup[uCase]) && (eStatus == E_PASSED);
+		i++)
+	{
+		eStatus = pfnTestCase();
+	}
+
+	if ((eStatus != E_PASSED) || (uIterations == 0))
+	{
+		return eStatus;
+	}
+
+	/* Without memory for the times the iterations are not measured */
+	if (puStampNs == NULL)
+	{
+		for (i = 0; (i < uIterations) && (eStatus == E_PASSED); i++)
+		{
+			eStatus = pfnTestCase();
+		}
+		return eStatus;
+	}
+
+	/* Iteration i took puStampNs[i + 1] - puStampNs[i] */
+	puStampNs[0] = getMonotonicNs();
+	for (i = 0; (i < uIterations) && (eStatus == E_PASSED); i++)
+	{
+		eStatus = pfnTestCase();
+		puStampNs[i + 1] = getMonotonicNs();
+	}
+
+	for (uIterations = 0; uIterations < i; uIterations++)
+	{
+		puStampNs[uIterations] = puStampNs[uIterations + 1] -
+			puStampNs[uIterations];
+	}
+
+	computeLatency(puStampNs, i, pLatency);
+	pLatency->uWarmup = g_Registry.puWarmup[uCase];
+
+	return eStatus;
+}
+
+
+/**=============================================================================
+
+	Function Name   : executeTestCases
+    Description     : This is the main loop of a forked test execution
+    				  process. It allocates the iteration times of the longest
+    				  case, runs the test cases scheduled on the channel,
+    				  publishes their results in the arena and never returns.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pChannel			In		Channel of the process
+    Returns         : None
+
+  ============================================================================*/
+
+void executeTestCases(sTestChannel_t *pChannel)
+{
+	unsigned int uIndex = 0, uMaxIterations = 0;
+
+	/* Epoll instance belongs to the scheduler */
+	reactorClose();
+
+	/* Nothing else tells a blocked process that the scheduler is gone */
+	prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+	histogramBind(pChannel->uSlot);
+	clockSyncBind(pChannel->uSlot);
+	bufferPoolBind(pChannel->uSlot);
+	usageOpen();
+
+	/* Times of the iterations, taken and faulted in before any case is
+	 * timed
+	 */
+	for (uIndex = 0; uIndex < g_Registry.uNumberOfCases; uIndex++)
+	{
+		if (g_Registry.puIterations[uIndex] > uMaxIterations)
+		{
+			uMaxIterations = g_Registry.puIterations[uIndex];
+		}
+	}
+	if (uMaxIterations > 0)
+	{
+		g_puStampNs = malloc((uMaxIterations + 1) * sizeof(uint64_t));
+		if (g_puStampNs == NULL)
+		{
+			deviceDrvTstFWDebug(LOG_TO_USR,
+				"No memory to measure %u iterations\n", uMaxIterations);
+		}
+		else
+		{
+			memset(g_puStampNs, 0, (uMaxIterations + 1) * sizeof(uint64_t));
+		}
+	}
+
+	while (channelWait(pChannel, &uIndex) == 0)
+	{
+		if (uIndex >= g_Registry.uNumberOfCases)
+		{
+			break;
+		}
+
+		histogramBegin();
+		bufferPoolBegin();
+		arenaBegin(pChannel->uResultBase + uIndex);
+		arenaPublish(pChannel->uResultBase + uIndex,
+			runTestCase(uIndex, &g_pResult[pChannel->uResultBase + uIndex]));
+		channelNotify(pChannel);
+	}
+
+	_exit(0);
+}
@@ -0,0 +1,227 @@
+/**=============================================================================
+  $Workfile: benchmark.c $
+
+  File Description: Throughput benchmark cases. The test execution process
+                    calls the function of a benchmark case till its time or
+                    byte budget is used up, the case counts the bytes and
+                    messages it moves through benchmarkCount. The rates and
+                    the CPU time per byte go to the report, a case moving less
+                    than its minimums fails.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "deviceDrvTestFW.h"
+#include "benchmark.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+/* Counted by the case running in this test execution process */
+static uint64_t g_uBenchmarkBytes;
+static uint64_t g_uBenchmarkMessages;
+
+/*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
+
+static uint64_t readClockNs(clockid_t nClock);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : readClockNs
+    Description     : Function to read a clock in nanoseconds.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nClock			In		CLOCK_MONOTONIC or
+                      						CLOCK_PROCESS_CPUTIME_ID
+    Returns         : Time in nanoseconds
+
+  ============================================================================*/
+
+static uint64_t readClockNs(clockid_t nClock)
+{
+	struct timespec Now;
+
+	clock_gettime(nClock, &Now);
+
+	return (uint64_t)Now.tv_sec * 1000000000ULL + Now.tv_nsec;
+}
+
+
+/**=============================================================================
+
+	Function Name   : benchmarkCount
+    Description     : Function exported to the test cases to count the data a
+    				  benchmark case moved. Relaxed atomics, the counters are
+    				  read after the case returned.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uBytes			In		Bytes moved
+                      @uMessages		In		Messages moved
+    Returns         : None
+
+  ============================================================================*/
+
+void benchmarkCount(uint64_t uBytes, uint64_t uMessages)
+{
+	__atomic_fetch_add(&g_uBenchmarkBytes, uBytes, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&g_uBenchmarkMessages, uMessages, __ATOMIC_RELAXED);
+}
+
+
+/**=============================================================================
+
+	Function Name   : benchmarkRun
+    Description     : Function to run a benchmark case in the test execution
+    				  process. The function of the case is called till the
+    				  duration passed or the byte budget was counted, at least
+    				  once, and the calls stop at the first one which does
+    				  not pass. The CPU time is the one of the whole process,
+    				  so threads started by the case are included. A case
+    				  which passed is failed when it is below a minimum.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uCase			In		Case index
+                      @pThroughput		Out		Data moved and its cost
+    Returns         : Status of the case
+
+  ============================================================================*/
+
+E_TST_STATUS benchmarkRun(unsigned int uCase, sThroughput_t *pThroughput)
+{
+	const sBenchmark_t *pBenchmark = &g_Registry.pBenchmark[uCase];
+	pTestCaseFuncPtr pfnTestCase = g_Registry.pfnTestCase[uCase];
+	uint64_t uStartNs = 0, uDeadlineNs = 0, uNowNs = 0, uCpuStartNs = 0;
+	bool bDone = false;
+	E_TST_STATUS eStatus = E_PASSED;
+
+	pThroughput->dMinMBps = pBenchmark->dMinMBps;
+	pThroughput->dMinMessagesPerSec = pBenchmark->dMinMessagesPerSec;
+
+	__atomic_store_n(&g_uBenchmarkBytes, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&g_uBenchmarkMessages, 0, __ATOMIC_RELAXED);
+
+	uCpuStartNs = readClockNs(CLOCK_PROCESS_CPUTIME_ID);
+	uStartNs = readClockNs(CLOCK_MONOTONIC);
+	uDeadlineNs = uStartNs + (uint64_t)pBenchmark->uDurationMs * 1000000ULL;
+
+	do
+	{
+		eStatus = pfnTestCase();
+		pThroughput->uCalls++;
+		uNowNs = readClockNs(CLOCK_MONOTONIC);
+
+		bDone = ((pBenchmark->uDurationMs == 0) &&
+			(pBenchmark->uByteBudget == 0)) ||
+			((pBenchmark->uDurationMs != 0) && (uNowNs >= uDeadlineNs)) ||
+			((pBenchmark->uByteBudget != 0) &&
+			(__atomic_load_n(&g_uBenchmarkBytes, __ATOMIC_RELAXED) >=
+			pBenchmark->uByteBudget));
+	} while ((eStatus == E_PASSED) && !bDone);
+
+	pThroughput->uElapsedNs = uNowNs - uStartNs;
+	pThroughput->uCpuNs = readClockNs(CLOCK_PROCESS_CPUTIME_ID) - uCpuStartNs;
+	pThroughput->uBytes = __atomic_load_n(&g_uBenchmarkBytes,
+		__ATOMIC_RELAXED);
+	pThroughput->uMessages = __atomic_load_n(&g_uBenchmarkMessages,
+		__ATOMIC_RELAXED);
+
+	if ((eStatus == E_PASSED) &&
+		benchmarkBelowMinimum(pThroughput))
+	{
+		eStatus = E_FAILED;
+	}
+
+	return eStatus;
+}
+
+
+/**=============================================================================
+
+	Function Name   : benchmarkMBps
+    Description     : Function to get the throughput of a benchmark run.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pThroughput		In		Data moved
+    Returns         : Megabytes (10^6) per second, 0 if no time was measured
+
+  ============================================================================*/
+
+double benchmarkMBps(const sThroughput_t *pThroughput)
+{
+	if (pThroughput->uElapsedNs == 0)
+	{
+		return 0.0;
+	}
+
+	return (double)pThroughput->uBytes * 1e3 / pThroughput->uElapsedNs;
+}
+
+
+/**=============================================================================
+
+	Function Name   : benchmarkMessagesPerSec
+    Description     : Function to get the message rate of a benchmark run.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pThroughput		In		Data moved
+    Returns         : Messages per second, 0 if no time was measured
+
+  ============================================================================*/
+
+double benchmarkMessagesPerSec(const sThroughput_t *pThroughput)
+{
+	if (pThroughput->uElapsedNs == 0)
+	{
+		return 0.0;
+	}
+
+	return (double)pThroughput->uMessages * 1e9 / pThroughput->uElapsedNs;
+}
+
+
+/**=============================================================================
+
+	Function Name   : benchmarkBelowMinimum
+    Description     : Function to check a benchmark run against its minimums.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pThroughput		In		Data moved and minimums
+    Returns         : true if a rate is below its minimum, else false
+
+  ============================================================================*/
+
+bool benchmarkBelowMinimum(const sThroughput_t *pThroughput)
+{
+	return (benchmarkMBps(pThroughput) < pThroughput->dMinMBps) ||
+		(benchmarkMessagesPerSec(pThroughput) <
+		pThroughput->dMinMessagesPerSec);
+}
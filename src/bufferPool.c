@@ -0,0 +1,523 @@
+/**=============================================================================
+  $Workfile: bufferPool.c $
+
+  File Description: Payload buffer pools of the test cases. One pool per test
+                    execution process is mapped shared before the processes
+                    are forked, on huge pages when there are some, faulted in
+                    and filled with the configured pattern. Test cases take
+                    cache line aligned buffers from it by name, so that the
+                    timed part of a case moves data instead of allocating
+                    and filling it.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "deviceDrvTestFW.h"
+#include "config.h"
+#include "bufferPool.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+static const char *aPattern[] =
+{
+    [E_BUFFER_NONE]     = "NONE",
+    [E_BUFFER_ZERO]     = "ZERO",
+    [E_BUFFER_SEQUENCE] = "SEQUENCE",
+    [E_BUFFER_RANDOM]   = "RANDOM"
+};
+
+static unsigned char *g_pPool = MAP_FAILED;     /* Shared pools */
+static size_t g_uPoolMapSize;                   /* Size of the mapping */
+static size_t g_uPoolStride;                    /* Distance of two pools */
+static size_t g_uPoolBytes;                     /* Usable bytes of a pool */
+static sBufferSlot_t *g_pSlot = MAP_FAILED;     /* Shared state of the pools */
+static unsigned int g_uNumberOfSlots;
+static E_BUFFER_PATTERN g_ePattern;
+
+static unsigned char *g_pBoundPool;             /* Pool of this test
+                                                   execution process */
+static sBufferSlot_t *g_pBoundSlot;
+static uint64_t g_uOffset;                      /* Next free position */
+static sBufferNamed_t g_aNamed[BUFFER_MAX_NAMED];
+static unsigned int g_uNamed;                   /* Buffers taken by the
+                                                   running test case */
+
+/*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
+
+static uint64_t patternWord(uint64_t uWord);
+static void fillPattern(unsigned char *pData, uint64_t uPosition,
+	size_t uSize);
+static size_t hugePageSize(void);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : patternWord
+    Description     : Function to get 8 bytes of the configured pattern, the
+    				  byte at position p of a pool is byte p % 8 (little
+    				  endian) of the word p / 8.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uWord			In		Word index, position / 8
+    Returns         : Word of the pattern
+
+  ============================================================================*/
+
+static uint64_t patternWord(uint64_t uWord)
+{
+	uint64_t uValue = 0;
+	unsigned int i = 0;
+
+	switch (g_ePattern)
+	{
+		case E_BUFFER_SEQUENCE:
+			for (i = 0; i < 8; i++)
+			{
+				uValue |= ((uWord * 8 + i) & 0xff) << (i * 8);
+			}
+		break;
+
+		/* splitmix64 of the word index */
+		case E_BUFFER_RANDOM:
+			uValue = uWord + 0x9e3779b97f4a7c15ULL;
+			uValue = (uValue ^ (uValue >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			uValue = (uValue ^ (uValue >> 27)) * 0x94d049bb133111ebULL;
+			uValue ^= uValue >> 31;
+		break;
+
+		default:
+		break;
+	}
+
+	return uValue;
+}
+
+
+/**=============================================================================
+
+	Function Name   : fillPattern
+    Description     : Function to write the configured pattern in a range of
+    				  a pool.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pData			In		First byte of the range
+                      @uPosition		In		Position of it in the pool
+                      @uSize			In		Bytes of the range
+    Returns         : None
+
+  ============================================================================*/
+
+static void fillPattern(unsigned char *pData, uint64_t uPosition,
+	size_t uSize)
+{
+	uint64_t uValue = 0;
+	size_t i = 0;
+
+	if (g_ePattern == E_BUFFER_ZERO)
+	{
+		memset(pData, 0, uSize);
+		return;
+	}
+
+	for (i = 0; i < uSize; i++)
+	{
+		if ((i == 0) || (((uPosition + i) & 7) == 0))
+		{
+			uValue = patternWord((uPosition + i) >> 3);
+		}
+		pData[i] = (unsigned char)(uValue >> (((uPosition + i) & 7) * 8));
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : hugePageSize
+    Description     : Function to read the size of the default huge page from
+    				  /proc/meminfo.
+    Arguments       : None
+    Returns         : Bytes of a huge page, 0 if there are none
+
+  ============================================================================*/
+
+static size_t hugePageSize(void)
+{
+	FILE *pMeminfo = NULL;
+	char szLine[128];
+	unsigned long ulKb = 0;
+
+	pMeminfo = fopen("/proc/meminfo", "r");
+	if (pMeminfo == NULL)
+	{
+		return 0;
+	}
+
+	while (fgets(szLine, sizeof(szLine), pMeminfo) != NULL)
+	{
+		if (sscanf(szLine, "Hugepagesize: %lu kB", &ulKb) == 1)
+		{
+			break;
+		}
+	}
+	fclose(pMeminfo);
+
+	return (size_t)ulKb * 1024;
+}
+
+
+/**=============================================================================
+
+	Function Name   : bufferPoolCreate
+    Description     : Function to map the payload buffer pools, one per test
+    				  execution process, of BUFFER_POOL_KB kilobytes each. It
+    				  has to be called before the test execution processes
+    				  are forked. The pools are mapped on huge pages when
+    				  enough are reserved, else transparent huge pages are
+    				  asked for. Every page is then faulted in by filling
+    				  the pools with BUFFER_POOL_PATTERN, and locked when the
+    				  memory lock limit allows it.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlots			In		Number of pools
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int bufferPoolCreate(unsigned int uSlots)
+{
+	const char *pszPattern = NULL;
+	size_t uPageSize = sysconf(_SC_PAGESIZE), uHugeSize = 0, uSize = 0;
+	long lKb = 0;
+	bool bHuge = false, bLocked = false;
+	unsigned int i = 0;
+
+	bufferPoolDestroy();
+
+	lKb = getConfigNumber(BUFFER_POOL_KB_KEY, BUFFER_POOL_DEFAULT_KB);
+	if ((lKb <= 0) || (uSlots == 0))
+	{
+		return 0;
+	}
+
+	pszPattern = configLookup(BUFFER_POOL_PATTERN_KEY);
+	if (pszPattern == NULL)
+	{
+		pszPattern = BUFFER_POOL_DEFAULT_PATTERN;
+	}
+
+	for (i = 0; i < sizeof(aPattern) / sizeof(aPattern[0]); i++)
+	{
+		if (strcmp(pszPattern, aPattern[i]) == 0)
+		{
+			break;
+		}
+	}
+
+	if (i == sizeof(aPattern) / sizeof(aPattern[0]))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"Unknown buffer pattern %s, using %s\n", pszPattern,
+			aPattern[E_BUFFER_NONE]);
+		i = E_BUFFER_NONE;
+	}
+	g_ePattern = (E_BUFFER_PATTERN)i;
+
+	g_uNumberOfSlots = uSlots;
+	g_uPoolBytes = (size_t)lKb * 1024;
+	g_uPoolStride = (g_uPoolBytes + uPageSize - 1) & ~(uPageSize - 1);
+	g_uPoolMapSize = g_uPoolStride * uSlots;
+
+	g_pSlot = mmap(NULL, uSlots * sizeof(sBufferSlot_t),
+		PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (g_pSlot == MAP_FAILED)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in mapping buffer pools\n");
+		return -1;
+	}
+
+	/* Reserved huge pages only when the pools fill at least one */
+#ifdef MAP_HUGETLB
+	uHugeSize = hugePageSize();
+	if ((uHugeSize != 0) && (g_uPoolMapSize >= uHugeSize))
+	{
+		uSize = (g_uPoolMapSize + uHugeSize - 1) & ~(uHugeSize - 1);
+		g_pPool = mmap(NULL, uSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (g_pPool != MAP_FAILED)
+		{
+			g_uPoolMapSize = uSize;
+			bHuge = true;
+		}
+	}
+#endif
+
+	if (g_pPool == MAP_FAILED)
+	{
+		g_pPool = mmap(NULL, g_uPoolMapSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (g_pPool == MAP_FAILED)
+		{
+			deviceDrvTstFWDebug(LOG_TO_USR, "Error in mapping buffer pools\n");
+			bufferPoolDestroy();
+			return -1;
+		}
+
+		/* Has to be asked for before the pages are faulted in */
+#ifdef MADV_HUGEPAGE
+		madvise(g_pPool, g_uPoolMapSize, MADV_HUGEPAGE);
+#endif
+	}
+
+	/* Fault every page in now, not in the first test case using it */
+	for (i = 0; i < uSlots; i++)
+	{
+		if (g_ePattern == E_BUFFER_NONE)
+		{
+			memset(g_pPool + (size_t)i * g_uPoolStride, 0, g_uPoolBytes);
+		}
+		else
+		{
+			fillPattern(g_pPool + (size_t)i * g_uPoolStride, 0, g_uPoolBytes);
+		}
+	}
+
+	bLocked = (mlock(g_pPool, g_uPoolMapSize) == 0);
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tBuffer pools %u x %ld KB, %s pages%s, pattern %s [%s:%d]\n",
+		uSlots, lKb, bHuge ? "reserved huge" : "standard",
+		bLocked ? ", locked" : "", aPattern[g_ePattern], __FILENAME__,
+		__LINE__);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : bufferPoolDestroy
+    Description     : Function to unmap the payload buffer pools.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void bufferPoolDestroy(void)
+{
+	if (g_pPool != MAP_FAILED)
+	{
+		munmap(g_pPool, g_uPoolMapSize);
+		g_pPool = MAP_FAILED;
+	}
+
+	if (g_pSlot != MAP_FAILED)
+	{
+		munmap(g_pSlot, g_uNumberOfSlots * sizeof(sBufferSlot_t));
+		g_pSlot = MAP_FAILED;
+	}
+
+	g_pBoundPool = NULL;
+	g_pBoundSlot = NULL;
+}
+
+
+/**=============================================================================
+
+	Function Name   : bufferPoolBind
+    Description     : Function called by a test execution process to take
+    				  the buffers of its test cases from a pool. A slot
+    				  without a pool is reported, its cases get no buffers.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Pool of the process
+    Returns         : None
+
+  ============================================================================*/
+
+void bufferPoolBind(unsigned int uSlot)
+{
+	if ((g_pPool != MAP_FAILED) && (uSlot < g_uNumberOfSlots))
+	{
+		g_pBoundPool = g_pPool + (size_t)uSlot * g_uPoolStride;
+		g_pBoundSlot = &g_pSlot[uSlot];
+	}
+	else
+	{
+		if (g_pPool != MAP_FAILED)
+		{
+			deviceDrvTstFWDebug(LOG_TO_USR|LOG_TO_DBG,
+				"No buffer pool for slot %u of %u [%s:%d]\n",
+				uSlot, g_uNumberOfSlots, __FILENAME__, __LINE__);
+		}
+		g_pBoundPool = NULL;
+		g_pBoundSlot = NULL;
+	}
+
+	g_uOffset = 0;
+	g_uNamed = 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : bufferPoolBegin
+    Description     : Function called by the test execution process before it
+    				  runs a test case, before the case is timed. The buffers
+    				  of the previous case are dropped and the bytes they
+    				  covered are filled with the pattern again.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void bufferPoolBegin(void)
+{
+	if (g_pBoundSlot == NULL)
+	{
+		return;
+	}
+
+	if ((g_ePattern != E_BUFFER_NONE) && (g_pBoundSlot->uDirty != 0))
+	{
+		fillPattern(g_pBoundPool, 0, g_pBoundSlot->uDirty);
+	}
+
+	g_pBoundSlot->uDirty = 0;
+	g_uOffset = 0;
+	g_uNamed = 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : bufferGet
+    Description     : Function exported to the test case shared objects to
+    				  get a payload buffer of the running test case by name.
+    				  The same name gives the same buffer within a test case,
+    				  across its iterations and benchmark calls. Buffers are
+    				  taken one after the other from the start of the pool,
+    				  each rounded up to BUFFER_ALIGN bytes.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszName			In		Buffer name
+                      @uSize			In		Bytes needed
+    Returns         : Buffer, NULL if the pool is too small, a buffer of the
+    				  name is smaller, BUFFER_MAX_NAMED are in use or the
+    				  caller is not a test execution process with a pool
+
+  ============================================================================*/
+
+void *bufferGet(const char *pszName, size_t uSize)
+{
+	sBufferNamed_t *pNamed = NULL;
+	size_t uAligned = (uSize + BUFFER_ALIGN - 1) & ~(size_t)(BUFFER_ALIGN - 1);
+	unsigned int i = 0;
+
+	if ((g_pBoundPool == NULL) || (pszName == NULL))
+	{
+		return NULL;
+	}
+
+	for (i = 0; i < g_uNamed; i++)
+	{
+		if (strncmp(g_aNamed[i].szName, pszName,
+			sizeof(g_aNamed[i].szName)) == 0)
+		{
+			return (uSize <= g_aNamed[i].uSize) ?
+				g_pBoundPool + g_aNamed[i].uOffset : NULL;
+		}
+	}
+
+	if ((g_uNamed == BUFFER_MAX_NAMED) ||
+		(uAligned > g_uPoolBytes - g_uOffset))
+	{
+		return NULL;
+	}
+
+	pNamed = &g_aNamed[g_uNamed++];
+	strncpy(pNamed->szName, pszName, sizeof(pNamed->szName) - 1);
+	pNamed->szName[sizeof(pNamed->szName) - 1] = '\0';
+	pNamed->uOffset = g_uOffset;
+	pNamed->uSize = uSize;
+
+	/* Kept in the shared slot, a crashed case is refilled too */
+	g_uOffset += uAligned;
+	g_pBoundSlot->uDirty = g_uOffset;
+
+	return g_pBoundPool + pNamed->uOffset;
+}
+
+
+/**=============================================================================
+
+	Function Name   : bufferCheck
+    Description     : Function exported to the test case shared objects to
+    				  compare data, e.g. received from the other machine,
+    				  with the pattern of the pools.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pData			In		Data
+                      @uSize			In		Bytes of data
+                      @uPosition		In		Position in the pattern of
+                      							the first byte
+    Returns         : true if the data is the pattern, false if it is not or
+    				  BUFFER_POOL_PATTERN is NONE
+
+  ============================================================================*/
+
+bool bufferCheck(const void *pData, size_t uSize, uint64_t uPosition)
+{
+	const unsigned char *pByte = pData;
+	uint64_t uValue = 0;
+	size_t i = 0;
+
+	if ((g_ePattern == E_BUFFER_NONE) || (pData == NULL))
+	{
+		return false;
+	}
+
+	for (i = 0; i < uSize; i++)
+	{
+		if ((i == 0) || (((uPosition + i) & 7) == 0))
+		{
+			uValue = patternWord((uPosition + i) >> 3);
+		}
+		if (pByte[i] != (unsigned char)(uValue >> (((uPosition + i) & 7) * 8)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,710 @@
+/**=============================================================================
+  $Workfile: clockSync.c $
+
+  File Description: Clock synchronization of master and slave over the
+                    control connection, in the manner of NTP. The slave
+                    sends a few clock requests in a round, master stamps the
+                    time it received each one and the time it sent the
+                    reply. The request with the shortest round trip is the
+                    least delayed by queues, its offset is taken for the
+                    round and the drift is fitted over the last rounds. The
+                    estimate is kept in a shared mapping, so that the test
+                    execution processes convert the timestamps of the other
+                    machine without asking the scheduler.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#include <math.h>
+#include <sys/mman.h>
+
+#include "deviceDrvTestFW.h"
+#include "clockSync.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+/* Estimate of one machine, written under a sequence lock. The sequence is
+ * odd while the estimate is being written.
+ */
+typedef struct clock_slot
+{
+    uint32_t uSequence;
+    sClockEstimate_t Estimate;
+}sClockSlot_t;
+
+/* Offset of the clock of master at a local time, one per round */
+typedef struct clock_point
+{
+    uint64_t uLocalNs;                      /* Middle of the best request */
+    int64_t nOffsetNs;                      /* Master minus local clock */
+}sClockPoint_t;
+
+static sClockSlot_t *g_pClockSlot = MAP_FAILED;    /* Shared slots */
+static unsigned int g_uNumberOfClockSlots;
+static int g_nBoundClockSlot = -1;          /* Slot of this test execution
+                                               process, -1 for none */
+
+/* Estimator of the slave */
+static long g_lSyncIntervalMs = -1;         /* CLOCK_SYNC_INTERVAL, -1 till
+                                               it is read */
+static bool g_bRoundTaken;
+static uint64_t g_uLastRoundNs;
+static uint64_t g_uBestDelayNs = UINT64_MAX;
+static sClockPoint_t g_BestSample;
+static sClockPoint_t g_aPoint[CLOCK_SYNC_POINTS];
+static uint32_t g_uRounds;
+
+/*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
+
+static void putUint64(unsigned char *pBuffer, uint64_t uValue);
+static uint64_t getUint64(const unsigned char *pBuffer);
+static void writeSlot(unsigned int uSlot, const sClockEstimate_t *pEstimate);
+static void fitPoints(int64_t *pnOffsetNs, double *pdDrift);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : putUint64
+    Description     : Function to write a value little endian in a message.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pBuffer			Out		Payload
+                      @uValue			In		Value
+    Returns         : None
+
+  ============================================================================*/
+
+static void putUint64(unsigned char *pBuffer, uint64_t uValue)
+{
+	int i = 0;
+
+	for (i = 0; i < 8; i++)
+	{
+		pBuffer[i] = (unsigned char)(uValue & 0xff);
+		uValue >>= 8;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : getUint64
+    Description     : Function to read a little endian value of a message.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pBuffer			In		Payload
+    Returns         : Value
+
+  ============================================================================*/
+
+static uint64_t getUint64(const unsigned char *pBuffer)
+{
+	uint64_t uValue = 0;
+	int i = 0;
+
+	for (i = 7; i >= 0; i--)
+	{
+		uValue = (uValue << 8) | pBuffer[i];
+	}
+
+	return uValue;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncNow
+    Description     : Function to read CLOCK_MONOTONIC, the clock converted
+    				  by clockToLocal.
+    Arguments       : None
+    Returns         : Time in nanoseconds
+
+  ============================================================================*/
+
+uint64_t clockSyncNow(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (uint64_t)Now.tv_sec * 1000000000ULL + Now.tv_nsec;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncCreate
+    Description     : Function to map the estimate slots, one per machine
+    				  whose clock is converted. It has to be called before the
+    				  test execution processes are forked.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlots			In		Number of slots
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int clockSyncCreate(unsigned int uSlots)
+{
+	clockSyncDestroy();
+
+	g_pClockSlot = mmap(NULL, uSlots * sizeof(sClockSlot_t),
+		PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (g_pClockSlot == MAP_FAILED)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in mapping clock estimates\n");
+		return -1;
+	}
+
+	g_uNumberOfClockSlots = uSlots;
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncDestroy
+    Description     : Function to unmap the estimate slots.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void clockSyncDestroy(void)
+{
+	if (g_pClockSlot != MAP_FAILED)
+	{
+		munmap(g_pClockSlot, g_uNumberOfClockSlots * sizeof(sClockSlot_t));
+		g_pClockSlot = MAP_FAILED;
+	}
+
+	g_uNumberOfClockSlots = 0;
+	g_nBoundClockSlot = -1;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncBind
+    Description     : Function called by a test execution process to convert
+    				  the timestamps of the other machine with the estimate of
+    				  a slot.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot of the process
+    Returns         : None
+
+  ============================================================================*/
+
+void clockSyncBind(unsigned int uSlot)
+{
+	g_nBoundClockSlot = (uSlot < g_uNumberOfClockSlots) ? (int)uSlot : -1;
+}
+
+
+/**=============================================================================
+
+	Function Name   : writeSlot
+    Description     : Function to publish an estimate in a slot. Readers
+    				  retry while the sequence is odd or has moved.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot
+                      @pEstimate		In		Estimate
+    Returns         : None
+
+  ============================================================================*/
+
+static void writeSlot(unsigned int uSlot, const sClockEstimate_t *pEstimate)
+{
+	sClockSlot_t *pSlot = NULL;
+
+	if ((g_pClockSlot == MAP_FAILED) || (uSlot >= g_uNumberOfClockSlots))
+	{
+		return;
+	}
+
+	pSlot = &g_pClockSlot[uSlot];
+
+	__atomic_store_n(&pSlot->uSequence, pSlot->uSequence + 1,
+		__ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	memcpy(&pSlot->Estimate, pEstimate, sizeof(sClockEstimate_t));
+
+	__atomic_store_n(&pSlot->uSequence, pSlot->uSequence + 1,
+		__ATOMIC_RELEASE);
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncReset
+    Description     : Function to drop the estimate of a slot, when another
+    				  slave takes the session of master.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot
+    Returns         : None
+
+  ============================================================================*/
+
+void clockSyncReset(unsigned int uSlot)
+{
+	sClockEstimate_t Estimate;
+
+	memset(&Estimate, 0, sizeof(Estimate));
+	writeSlot(uSlot, &Estimate);
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncRead
+    Description     : Function to read the estimate of a slot.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot
+                      @pEstimate		Out		Estimate
+    Returns         : true if the slot holds an estimate
+
+  ============================================================================*/
+
+bool clockSyncRead(unsigned int uSlot, sClockEstimate_t *pEstimate)
+{
+	sClockSlot_t *pSlot = NULL;
+	uint32_t uSequence = 0;
+
+	if ((g_pClockSlot == MAP_FAILED) || (uSlot >= g_uNumberOfClockSlots))
+	{
+		return false;
+	}
+
+	pSlot = &g_pClockSlot[uSlot];
+
+	do
+	{
+		uSequence = __atomic_load_n(&pSlot->uSequence, __ATOMIC_ACQUIRE);
+		memcpy(pEstimate, &pSlot->Estimate, sizeof(sClockEstimate_t));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	}while ((uSequence & 1) ||
+		(uSequence != __atomic_load_n(&pSlot->uSequence, __ATOMIC_RELAXED)));
+
+	return (pEstimate->uRounds != 0);
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncToLocal
+    Description     : Function to convert a CLOCK_MONOTONIC timestamp of the
+    				  other machine to the local CLOCK_MONOTONIC with the
+    				  estimate of a slot.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot
+                      @uRemoteNs		In		Timestamp of the other machine
+                      @puLocalNs		Out		Local timestamp
+                      @puErrorNs		Out		Error bound, may be NULL
+    Returns         : true if the slot holds an estimate
+
+  ============================================================================*/
+
+bool clockSyncToLocal(unsigned int uSlot, uint64_t uRemoteNs,
+	uint64_t *puLocalNs, uint64_t *puErrorNs)
+{
+	sClockEstimate_t Estimate;
+	int64_t nRemoteNs = 0;
+
+	if (!clockSyncRead(uSlot, &Estimate))
+	{
+		return false;
+	}
+
+	nRemoteNs = (int64_t)(uRemoteNs - Estimate.uRemoteRefNs);
+	*puLocalNs = Estimate.uLocalRefNs +
+		(int64_t)llround((double)nRemoteNs / Estimate.dRate);
+
+	if (puErrorNs != NULL)
+	{
+		*puErrorNs = Estimate.uErrorNs;
+	}
+
+	return true;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncToRemote
+    Description     : Function to convert a local CLOCK_MONOTONIC timestamp to
+    				  the CLOCK_MONOTONIC of the other machine with the
+    				  estimate of a slot.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot
+                      @uLocalNs			In		Local timestamp
+                      @puRemoteNs		Out		Timestamp of the other machine
+    Returns         : true if the slot holds an estimate
+
+  ============================================================================*/
+
+bool clockSyncToRemote(unsigned int uSlot, uint64_t uLocalNs,
+	uint64_t *puRemoteNs)
+{
+	sClockEstimate_t Estimate;
+	int64_t nLocalNs = 0;
+
+	if (!clockSyncRead(uSlot, &Estimate))
+	{
+		return false;
+	}
+
+	nLocalNs = (int64_t)(uLocalNs - Estimate.uLocalRefNs);
+	*puRemoteNs = Estimate.uRemoteRefNs +
+		(int64_t)llround((double)nLocalNs * Estimate.dRate);
+
+	return true;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockToLocal
+    Description     : Function exported to the test case shared objects to
+    				  convert a CLOCK_MONOTONIC timestamp of the other machine
+    				  to the local CLOCK_MONOTONIC.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uRemoteNs		In		Timestamp of the other machine
+                      @puLocalNs		Out		Local timestamp
+                      @puErrorNs		Out		Error bound, may be NULL
+    Returns         : 0 ON SUCCESS, -1 if there is no estimate
+
+  ============================================================================*/
+
+int clockToLocal(uint64_t uRemoteNs, uint64_t *puLocalNs, uint64_t *puErrorNs)
+{
+	if ((g_nBoundClockSlot < 0) || !clockSyncToLocal(g_nBoundClockSlot,
+		uRemoteNs, puLocalNs, puErrorNs))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncDue
+    Description     : Function called by the slave between test cases to
+    				  check whether a round has to be taken, first one at the
+    				  handshake and then every CLOCK_SYNC_INTERVAL
+    				  milliseconds.
+    Arguments       : None
+    Returns         : true if a round is due
+
+  ============================================================================*/
+
+bool clockSyncDue(void)
+{
+	if (g_lSyncIntervalMs < 0)
+	{
+		g_lSyncIntervalMs = getConfigNumber(CLOCK_SYNC_INTERVAL_KEY,
+			CLOCK_SYNC_DEFAULT_INTERVAL);
+		if (g_lSyncIntervalMs < 0)
+		{
+			g_lSyncIntervalMs = 0;
+		}
+	}
+
+	if ((g_lSyncIntervalMs == 0) || (g_pClockSlot == MAP_FAILED))
+	{
+		return false;
+	}
+
+	return (!g_bRoundTaken || ((clockSyncNow() - g_uLastRoundNs) >=
+		(uint64_t)g_lSyncIntervalMs * 1000000ULL));
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncReply
+    Description     : Function called by master to fill the reply to a clock
+    				  request, Received time(8) | Sent time(8). The reply has
+    				  to be sent right away.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uReceivedNs		In		Time the request was received
+                      @pPayload			Out		Payload of the reply
+    Returns         : Length of the payload
+
+  ============================================================================*/
+
+unsigned int clockSyncReply(uint64_t uReceivedNs, unsigned char *pPayload)
+{
+	putUint64(&pPayload[0], uReceivedNs);
+	putUint64(&pPayload[8], clockSyncNow());
+
+	return FW_CLOCK_SYNC_LEN;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncSample
+    Description     : Function called by the slave with the reply to a clock
+    				  request. Offset of master is ((t2 - t1) + (t3 - t4)) / 2
+    				  and the round trip (t4 - t1) - (t3 - t2), the sample
+    				  with the shortest round trip of the round is kept.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSentNs			In		Request sent, t1
+                      @pPayload			In		Reply, t2 and t3
+                      @uLength			In		Length of the reply
+                      @uReceivedNs		In		Reply received, t4
+    Returns         : None
+
+  ============================================================================*/
+
+void clockSyncSample(uint64_t uSentNs, const unsigned char *pPayload,
+	unsigned int uLength, uint64_t uReceivedNs)
+{
+	uint64_t uMasterReceivedNs = 0, uMasterSentNs = 0, uDelayNs = 0;
+
+	if (uLength < FW_CLOCK_SYNC_LEN)
+	{
+		return;
+	}
+
+	uMasterReceivedNs = getUint64(&pPayload[0]);
+	uMasterSentNs = getUint64(&pPayload[8]);
+	if ((uMasterSentNs < uMasterReceivedNs) || (uReceivedNs < uSentNs))
+	{
+		return;
+	}
+
+	uDelayNs = uReceivedNs - uSentNs;
+	uDelayNs = (uDelayNs > (uMasterSentNs - uMasterReceivedNs)) ?
+		uDelayNs - (uMasterSentNs - uMasterReceivedNs) : 0;
+
+	if (uDelayNs < g_uBestDelayNs)
+	{
+		g_uBestDelayNs = uDelayNs;
+		g_BestSample.uLocalNs = uSentNs + (uReceivedNs - uSentNs) / 2;
+		g_BestSample.nOffsetNs = ((int64_t)(uMasterReceivedNs - uSentNs) +
+			(int64_t)(uMasterSentNs - uReceivedNs)) / 2;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : fitPoints
+    Description     : Function to fit the offsets of the last rounds to a
+    				  line by least squares, the slope is the drift of the
+    				  clock of master. Values are taken relative to the last
+    				  round, which keeps them small enough for a double.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pnOffsetNs		Out		Offset at the last round
+                      @pdDrift			Out		Drift, master seconds gained
+                      					 		per local second
+    Returns         : None
+
+  ============================================================================*/
+
+static void fitPoints(int64_t *pnOffsetNs, double *pdDrift)
+{
+	const sClockPoint_t *pLast =
+		&g_aPoint[(g_uRounds - 1) % CLOCK_SYNC_POINTS];
+	unsigned int uPoints = 0, i = 0;
+	double dX = 0, dY = 0, dMeanX = 0, dMeanY = 0, dSxx = 0, dSxy = 0;
+	double dDrift = 0;
+
+	uPoints = (g_uRounds < CLOCK_SYNC_POINTS) ? g_uRounds : CLOCK_SYNC_POINTS;
+
+	for (i = 0; i < uPoints; i++)
+	{
+		dMeanX += (double)(int64_t)(g_aPoint[i].uLocalNs - pLast->uLocalNs);
+		dMeanY += (double)(g_aPoint[i].nOffsetNs - pLast->nOffsetNs);
+	}
+	dMeanX /= uPoints;
+	dMeanY /= uPoints;
+
+	for (i = 0; i < uPoints; i++)
+	{
+		dX = (double)(int64_t)(g_aPoint[i].uLocalNs - pLast->uLocalNs) -
+			dMeanX;
+		dY = (double)(g_aPoint[i].nOffsetNs - pLast->nOffsetNs) - dMeanY;
+		dSxx += dX * dX;
+		dSxy += dX * dY;
+	}
+
+	if (dSxx > 0)
+	{
+		dDrift = dSxy / dSxx;
+	}
+	if (dDrift > CLOCK_SYNC_MAX_DRIFT)
+	{
+		dDrift = CLOCK_SYNC_MAX_DRIFT;
+	}
+	else if (dDrift < -CLOCK_SYNC_MAX_DRIFT)
+	{
+		dDrift = -CLOCK_SYNC_MAX_DRIFT;
+	}
+
+	*pdDrift = dDrift;
+	*pnOffsetNs = pLast->nOffsetNs + llround(dMeanY - dDrift * dMeanX);
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncRound
+    Description     : Function called by the slave once the requests of a
+    				  round are answered. The best sample of the round is
+    				  added to the points, the estimate is published in slot 0
+    				  and filled in the payload sent to master, Reference
+    				  time(8) | Offset(8) | Drift in 10^-12(8) | Error(8).
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pPayload			Out		Estimate for master
+    Returns         : Length of the payload, 0 if no request was answered
+
+  ============================================================================*/
+
+unsigned int clockSyncRound(unsigned char *pPayload)
+{
+	sClockEstimate_t Estimate;
+	int64_t nOffsetNs = 0;
+	double dDrift = 0;
+
+	g_bRoundTaken = true;
+	g_uLastRoundNs = clockSyncNow();
+
+	if (g_uBestDelayNs == UINT64_MAX)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG, "\tNo clock sample in round [%s:%d]\n",
+			__FILENAME__, __LINE__);
+		return 0;
+	}
+
+	g_aPoint[g_uRounds % CLOCK_SYNC_POINTS] = g_BestSample;
+	g_uRounds++;
+
+	fitPoints(&nOffsetNs, &dDrift);
+
+	memset(&Estimate, 0, sizeof(Estimate));
+	Estimate.uLocalRefNs = g_BestSample.uLocalNs;
+	Estimate.uRemoteRefNs = g_BestSample.uLocalNs + nOffsetNs;
+	Estimate.dRate = 1 + dDrift;
+	Estimate.uErrorNs = g_uBestDelayNs / 2;
+	Estimate.uRounds = g_uRounds;
+	writeSlot(0, &Estimate);
+
+	if (g_uRounds == 1)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"Clock offset to master %lld ns, error %llu ns\n",
+			(long long)nOffsetNs, (unsigned long long)Estimate.uErrorNs);
+	}
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tClock offset %lld ns, drift %.3lf ppm, error %llu ns, "
+		"round %u [%s:%d]\n", (long long)nOffsetNs, dDrift * 1e6,
+		(unsigned long long)Estimate.uErrorNs, g_uRounds,
+		__FILENAME__, __LINE__);
+
+	putUint64(&pPayload[0], Estimate.uLocalRefNs);
+	putUint64(&pPayload[8], (uint64_t)nOffsetNs);
+	putUint64(&pPayload[16], (uint64_t)llround(dDrift * 1e12));
+	putUint64(&pPayload[24], Estimate.uErrorNs);
+
+	g_uBestDelayNs = UINT64_MAX;
+
+	return FW_CLOCK_ESTIMATE_LEN;
+}
+
+
+/**=============================================================================
+
+	Function Name   : clockSyncApply
+    Description     : Function called by master with the estimate sent by a
+    				  slave. The slave gives the clock of master against its
+    				  own, it is turned around for the slot of the session.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot of the session
+                      @pPayload			In		Estimate of the slave
+                      @uLength			In		Length of the estimate
+    Returns         : None
+
+  ============================================================================*/
+
+void clockSyncApply(unsigned int uSlot, const unsigned char *pPayload,
+	unsigned int uLength)
+{
+	sClockEstimate_t Estimate;
+	uint64_t uReferenceNs = 0;
+	int64_t nOffsetNs = 0;
+	double dDrift = 0;
+
+	if (uLength < FW_CLOCK_ESTIMATE_LEN)
+	{
+		return;
+	}
+
+	uReferenceNs = getUint64(&pPayload[0]);
+	nOffsetNs = (int64_t)getUint64(&pPayload[8]);
+	dDrift = (double)(int64_t)getUint64(&pPayload[16]) / 1e12;
+
+	if (!clockSyncRead(uSlot, &Estimate))
+	{
+		Estimate.uRounds = 0;
+	}
+
+	Estimate.uLocalRefNs = uReferenceNs + nOffsetNs;
+	Estimate.uRemoteRefNs = uReferenceNs;
+	Estimate.dRate = 1 / (1 + dDrift);
+	Estimate.uErrorNs = getUint64(&pPayload[24]);
+	Estimate.uRounds++;
+	writeSlot(uSlot, &Estimate);
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tClock offset of slave %lld ns, drift %.3lf ppm, error %llu ns "
+		"[%s:%d]\n",
+		(long long)(Estimate.uRemoteRefNs - Estimate.uLocalRefNs),
+		(Estimate.dRate - 1) * 1e6,
+		(unsigned long long)Estimate.uErrorNs, __FILENAME__, __LINE__);
+}
@@ -0,0 +1,270 @@
+/**=============================================================================
+  $Workfile: config.c$
+
+  File Description: Configuration cache. testFWCfg.xml and test_cfg.xml are
+                    read once at start up, every element below the root is
+                    stored with its text in a hash table. The framework and
+                    the test case shared objects look the values up without
+                    reading the XML files again.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <libxml/xmlreader.h>
+
+#include "deviceDrvTestFW.h"
+#include "config.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+#define NODE_TYPE_ELEMENT  	1
+#define NODE_TYPE_TEXT     	3
+#define NODE_DEPTH_1       	1
+#define NODE_DEPTH_2       	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+static sConfigEntry_t *g_pConfigHead;       /* Values of all the files */
+static char g_szLoaded[CONFIG_MAX_FILES][CONFIG_VALUE_LEN];  /* Parsed files */
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : configStore
+    Description     : Function to add a value to the cache, a key already
+    				  present keeps its first value.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszKey			In		Element name
+                      @pszValue			In		Text of the element
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+static int configStore(const char *pszKey, const char *pszValue)
+{
+	sConfigEntry_t *pEntry = NULL;
+
+	HASH_FIND_STR(g_pConfigHead, pszKey, pEntry);
+	if (pEntry != NULL)
+	{
+		return 0;
+	}
+
+	pEntry = calloc(1, sizeof(sConfigEntry_t));
+	if (!pEntry)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "No memory to store configuration\n");
+		return -1;
+	}
+
+	snprintf(pEntry->szKey, sizeof(pEntry->szKey), "%s", pszKey);
+	snprintf(pEntry->szValue, sizeof(pEntry->szValue), "%s", pszValue);
+
+	HASH_ADD_STR(g_pConfigHead, szKey, pEntry);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : configLoad
+    Description     : Function to parse a configuration file into the cache.
+    				  Text of the elements directly below the root is stored
+    				  under the element name. A file is parsed only once.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszFile			In		File name with path
+                      @bRequired		In		Report a missing file
+    Returns         : Number of values stored, -1 ON FAILURE
+
+  ============================================================================*/
+
+int configLoad(const char *pszFile, bool bRequired)
+{
+	xmlTextReaderPtr pReader = NULL;
+	const xmlChar *pName = NULL, *pValue = NULL;
+	char szKey[CONFIG_KEY_LEN] = {0};
+	int nRet = 0, nCount = 0, i = 0;
+
+	for (i = 0; i < CONFIG_MAX_FILES && g_szLoaded[i][0] != '\0'; i++)
+	{
+		if (strcmp(g_szLoaded[i], pszFile) == 0)
+		{
+			return 0;
+		}
+	}
+
+	LIBXML_TEST_VERSION;
+
+	pReader = xmlReaderForFile(pszFile, NULL, 0);
+	if (pReader == NULL)
+	{
+		if (bRequired)
+		{
+			fprintf(stderr, "Error in reading xml file\n");
+		}
+		return -1;
+	}
+
+	nRet = xmlTextReaderRead(pReader);
+	while (nRet == 1)
+	{
+		if (xmlTextReaderDepth(pReader) == NODE_DEPTH_1 &&
+			xmlTextReaderNodeType(pReader) == NODE_TYPE_ELEMENT)
+		{
+			pName = xmlTextReaderConstName(pReader);
+			snprintf(szKey, sizeof(szKey), "%s", (const char *)pName);
+		}
+		else if (xmlTextReaderDepth(pReader) == NODE_DEPTH_2 &&
+			xmlTextReaderNodeType(pReader) == NODE_TYPE_TEXT &&
+			szKey[0] != '\0')
+		{
+			pValue = xmlTextReaderConstValue(pReader);
+			if (pValue != NULL && configStore(szKey, (const char *)pValue) == 0)
+			{
+				nCount++;
+			}
+			szKey[0] = '\0';
+		}
+
+		nRet = xmlTextReaderRead(pReader);
+	}
+	xmlFreeTextReader(pReader);
+
+	if (i < CONFIG_MAX_FILES)
+	{
+		snprintf(g_szLoaded[i], sizeof(g_szLoaded[i]), "%s", pszFile);
+	}
+
+	deviceDrvTstFWDebug(LOG_TO_DBG, "\tConfiguration %s, %d values [%s:%d]\n",
+		pszFile, nCount, __FILENAME__, __LINE__);
+
+	return nCount;
+}
+
+
+/**=============================================================================
+
+	Function Name   : configLookup
+    Description     : Function to look a value up in the cache.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszKey			In		Element name
+    Returns         : Value, NULL if the key is not configured
+
+  ============================================================================*/
+
+const char *configLookup(const char *pszKey)
+{
+	sConfigEntry_t *pEntry = NULL;
+
+	if (pszKey == NULL)
+	{
+		return NULL;
+	}
+
+	HASH_FIND_STR(g_pConfigHead, pszKey, pEntry);
+
+	return (pEntry != NULL) ? pEntry->szValue : NULL;
+}
+
+
+/**=============================================================================
+
+	Function Name   : configFree
+    Description     : Function to release the cache.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void configFree(void)
+{
+	sConfigEntry_t *pEntry = NULL, *pTemp = NULL;
+
+	HASH_ITER(hh, g_pConfigHead, pEntry, pTemp)
+	{
+		HASH_DEL(g_pConfigHead, pEntry);
+		free(pEntry);
+	}
+
+	memset(g_szLoaded, 0, sizeof(g_szLoaded));
+}
+
+
+/**=============================================================================
+
+	Function Name   : getConfigValue
+    Description     : Function exported to the test case shared objects to
+    				  read a configuration value.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszKey			In		Element name, e.g. BITRATE
+    Returns         : Value, NULL if the key is not configured
+
+  ============================================================================*/
+
+const char *getConfigValue(const char *pszKey)
+{
+	return configLookup(pszKey);
+}
+
+
+/**=============================================================================
+
+	Function Name   : getConfigNumber
+    Description     : Function exported to the test case shared objects to
+    				  read a numeric configuration value. Decimal, octal and
+    				  0x prefixed hexadecimal values are accepted.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszKey			In		Element name, e.g. NODEID
+                      @lDefault			In		Value if the key is not
+                      							configured or not a number
+    Returns         : Value of the key
+
+  ============================================================================*/
+
+long getConfigNumber(const char *pszKey, long lDefault)
+{
+	const char *pszValue = configLookup(pszKey);
+	char *pszEnd = NULL;
+	long lValue = 0;
+
+	if (pszValue == NULL)
+	{
+		return lDefault;
+	}
+
+	lValue = strtol(pszValue, &pszEnd, 0);
+
+	return (pszEnd == pszValue) ? lDefault : lValue;
+}
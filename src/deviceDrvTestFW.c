@@ -34,6 +34,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <pthread.h>
 #include <arpa/inet.h>
 #include <time.h>
@@ -41,12 +42,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <signal.h>
 #include <unistd.h>
 #include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <libxml/xmlreader.h>
+#include <libxml/xmlwriter.h>
 
 #include "deviceDrvTestFW.h"
 #include "console.h"
+#include "watchdog.h"
+#include "arena.h"
+#include "config.h"
+#include "nameIndex.h"
+#include "histogram.h"
+#include "schedule.h"
+#include "shard.h"
+#include "benchmark.h"
+#include "irqStat.h"
+#include "clockSync.h"
+#include "bufferPool.h"
 
 #define LOG_TO_USR 		    1
 #define LOG_TO_DBG  		2
@@ -54,11 +69,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define RET_SUCCESS		    0
 #define RET_FAILURE	        -1
 
-#define NODE_TYPE_ELEMENT  	1
-#define NODE_TYPE_TEXT     	3
-#define NODE_DEPTH_2       	2
-
-#define TESTFW_CFG    "testFWCfg.xml"
 
 
 /*------------------ G L O B A L   D E C L A R A T I O N S -------------------*/
@@ -67,12 +77,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 unsigned int g_uObjectHandleCount;      /* Object handle reference counter */
 
 int g_nMasterSockfd;                  	/* Master device socket */
-int g_nSlaveSockfd;                   	/* Slave device socket */
+sLink_t g_SlaveLink;                  	/* Slave device connection */
 
 unsigned char *g_pszIPAddress;       	/* IP address of master device */
 unsigned char *g_pszSharedObject;   	/* Pointer to shared object */
 
 unsigned char g_szFileName[100];        /* To store the test report filename */
+static xmlTextWriterPtr g_pReportWriter;    /* Test report being written */
+static int g_nReportFd = -1;            /* Test report file */
+static unsigned int g_uReportPending;   /* Nodes written since last flush */
 unsigned char g_szLogBuffer[255];       /* To store the string to be logged in
                                            Test report*/
 
@@ -83,189 +96,52 @@ void *g_hObjectHandle;                  /* Handle for a shared object */
 E_MODE_TYPE g_eMode;                    /* Device mode of operation */
 
 struct sockaddr_in DeviceAddress;       /* Master/Slave device address */
-sUserTestSuite_t *g_pUserTestSuite;     /* Pointer to user test suite */
 
-FILE *g_pDebugLogFile;					/* File pointer for storing debug log */
-bool g_bDebugLogFlag;					/* Flag to check whether debug file
-										   created */
+sUserTestSuite_t *g_pUserTestSuite;     /* Pointer to user test suite */
+static void *g_pRegistry;               /* Registry arrays */
 
-pid_t cpid;
 
 /*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
 
-/**=============================================================================
-
-    Function Name   : deviceDrvTstFWDebug
-    Description     : Function to send message to console UI or debug log file.
-    Arguments       :
-                      Name              Dir         Description
-                      @type             In          Log type
-                      @pszMsg			In			Message to be logged
-                      @variable argument list
-
-    Returns         : None
-
-  ============================================================================*/
-
-void deviceDrvTstFWDebug(int ntype, char *pszMsg, ...)
-{
-	unsigned char szDateTime[20];
-    unsigned char szDbgFileName[30] = "debug_fw_";
-    unsigned char szLog[200];
-    struct tm *pTimeInfo;
-
-	va_list fmt;
-	va_start(fmt, pszMsg);
-
-	time_t Rawtime;
-    time(&Rawtime);
-
-    memset(szLog, 0, 200);
-
-    switch (ntype)
-	{
-		case LOG_TO_USR:
-			if (g_bConsoleInitialized)
-			{
-				writeDbgMessage(pszMsg, fmt);
-			}
-			else
-			{
-				vfprintf(stderr, pszMsg, fmt);
-			}
-		break;
-
-		case LOG_TO_DBG:
-			if (g_bConsoleInitialized)
-			{
-				if(g_bDebugLogFlag == false)
-				{
-					if(g_eMode == E_SLAVE)
-						strcat(szDbgFileName, SLAVE);
-					else if(g_eMode == E_MASTER)
-						strcat(szDbgFileName, MASTER);
-					else if(g_eMode == E_STANDALONE)
-						strcat(szDbgFileName, STANDALONE);
-
-					strcat(szDbgFileName, ".txt");
-
-					g_pDebugLogFile = fopen(szDbgFileName, "a");
-
-					g_bDebugLogFlag = true;
-				}
-
-				/* Get the local time into the timeinfo structure */
-				pTimeInfo = localtime(&Rawtime);
-
-				strftime(szDateTime, sizeof(szDateTime), "%m/%d/%Y_%H:%M:%S",
-					pTimeInfo);
-
-				vsprintf(szLog, pszMsg, fmt);
-
-				fprintf(g_pDebugLogFile, "%s%s", szDateTime, szLog);
-			}
-			else
-			{
-				vfprintf(stderr, pszMsg, fmt);
-			}
-		break;
-	}
-
-	va_end(fmt);
-}
-
-
-/**=============================================================================
-
-    Function Name   : getValue
-    Description     : This function is for fetching the value of the node from
-    				  XML file
-    Arguments       :
-                      Name              Dir         Description
-                      @pReader          In          XML reader pointer
-                      @out              Out         Output parameter
-
-    Returns         : None
-
-  ============================================================================*/
-
-static void getValue(xmlTextReaderPtr pReader, unsigned char **pszOut)
-{
-    const xmlChar *pValue = NULL;
-    int nRet = 0;
-
-    /* Read Next Node */
-    nRet = xmlTextReaderRead(pReader);
-    if (nRet != 1)
-    {
-    	return;
-    }
-
-    pValue = xmlTextReaderConstValue(pReader);
-
-    if (NULL != pValue  && xmlTextReaderDepth(pReader) == NODE_DEPTH_2 &&
-    	xmlTextReaderNodeType(pReader) == NODE_TYPE_TEXT)
-    {
-         memcpy(*pszOut, pValue, xmlStrlen(pValue));
-    }
-}
-
-
 /**=============================================================================
 
     Function Name   : getTokenValue
-    Description     : This function is used to parse XML file.
+    Description     : This function is used to read a configuration value.
+    				  The file is parsed into the configuration cache unless
+    				  it was already.
     Arguments       :
                       Name              Dir         Description
                       @pszFile          In          File name with path
                       @pszToken         In          Key to fetch value
                       @pszValue         Out         Output value for the token
+                      @uSize            In          Size of pszValue, longer
+                                                    values are truncated
 
     Returns         : Returns RET_FAILURE on failure, RET_SUCCESS on success
 
   ============================================================================*/
 
-int getTokenValue(char *pszFile, const char *pszToken, unsigned char *pszValue)
+int getTokenValue(char *pszFile, const char *pszToken, unsigned char *pszValue,
+    size_t uSize)
 {
-    xmlTextReaderPtr pConfigRead = NULL;
-    const char *pszName = NULL;
-    int nRet = 0, eRet = RET_SUCCESS;
-
-    LIBXML_TEST_VERSION;
+    const char *pszCached = NULL;
 
-    if (NULL == pszValue)
+    if ((NULL == pszValue) || (uSize == 0))
     {
     	return RET_FAILURE;
     }
 
-    pConfigRead = xmlReaderForFile(pszFile, NULL, 0);
-    if (pConfigRead != NULL)
-    {
-        nRet = xmlTextReaderRead(pConfigRead);
-        while (nRet == 1)
-        {
-            pszName = (char*)xmlTextReaderConstName(pConfigRead);
+    configLoad(pszFile, true);
 
-            /* Consumes the Entire node */
-            if ((strcmp(pszToken,pszName) == 0) &&
-                (xmlTextReaderNodeType(pConfigRead) == NODE_TYPE_ELEMENT))
-            {
-                 getValue(pConfigRead,&pszValue);
-                 nRet = 0,eRet = RET_FAILURE;
-                 break;
-            }
-            nRet = xmlTextReaderRead(pConfigRead);
-        }
-        xmlFreeTextReader(pConfigRead);
-    }
-    else
+    pszCached = configLookup(pszToken);
+    if (pszCached == NULL)
     {
-    	eRet = RET_FAILURE;
-        fprintf(stderr, "Error in reading xml file\n");
+        return RET_FAILURE;
     }
 
-    xmlCleanupParser();
-    return eRet;
+    snprintf(pszValue, uSize, "%s", pszCached);
+
+    return RET_SUCCESS;
 }
 
 
@@ -282,6 +158,7 @@ int getTokenValue(char *pszFile, const char *pszToken, unsigned char *pszValue)
 void createSocket(void)
 {
     int nTest = 0;
+    int nNoDelay = 1;
     unsigned int uPortNumber = 0;
     unsigned int uAttempts = 0;
     time_t RandomPortGenerator;
@@ -332,26 +209,14 @@ void createSocket(void)
             }
         }
 
-        if (listen(g_nMasterSockfd, 3) < 0)
+        if (listen(g_nMasterSockfd, FW_MAX_SLAVES) < 0)
         {
             fprintf(stderr, "Listen failed\n");
             freeMemory(1);
         }
 
-        fprintf(stderr, "Waiting for the slave to connect...\n");
-
-        /* Accept the connection from the slave */
-        if ((g_nSlaveSockfd = accept(g_nMasterSockfd,
-            (struct sockaddr *)&DeviceAddress,
-            (socklen_t*)&uAddressLength)) < 0)
-        {
-            fprintf(stderr, "Client connection failed\n");
-            freeMemory(1);
-		}
-        else
-        {
-            fprintf(stderr, "Client connected successfully\n");
-        }
+        /* Slaves are accepted by the master thread as they connect */
+        fprintf(stderr, "Waiting for the slaves to connect...\n");
     }
 
     /* Create socket for slave mode and connect to the port number
@@ -364,7 +229,7 @@ void createSocket(void)
         scanf("%d", &uPortNumber);
 
         fprintf(stderr, "Allocating socket...\n");
-        if ((g_nSlaveSockfd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        if ((g_SlaveLink.nSockfd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
         {
             fprintf(stderr, "Socket allocation failed\n");
             freeMemory(1);
@@ -389,7 +254,7 @@ void createSocket(void)
 
         fprintf(stderr, "Connecting on port number %d...\n",
         	uPortNumber);
-        if (connect(g_nSlaveSockfd, (struct sockaddr *)&DeviceAddress,
+        if (connect(g_SlaveLink.nSockfd, (struct sockaddr *)&DeviceAddress,
         	uAddressLength) < 0)
         {
             fprintf(stderr, "Connect failed \n");
@@ -397,6 +262,10 @@ void createSocket(void)
         }
 
         fprintf(stderr, "Connected successfully\n");
+
+        /* Frames are batched by sendMessage, do not delay them further */
+        setsockopt(g_SlaveLink.nSockfd, IPPROTO_TCP, TCP_NODELAY, &nNoDelay,
+            sizeof(nNoDelay));
     }
 }
 
@@ -492,11 +361,69 @@ int initializeTestSummary(void)
 }
 
 
+/**=============================================================================
+
+    Function Name   : layoutRegistry
+    Description     : Function to place the registry arrays in one block. Called with a NULL block it only
+                      computes the size of the block.
+    Arguments       :
+                      Name              Dir         Description
+                      @pBlock           In          Registry block or NULL
+                      @uSuites          In          Number of suites
+                      @uCases           In          Number of cases
+
+    Returns         : Size of the block
+
+  ============================================================================*/
+
+static size_t layoutRegistry(unsigned char *pBlock, unsigned int uSuites,
+    unsigned int uCases)
+{
+    size_t uOffset = 0;
+
+#define PLACE_ARRAY(pArray, uCount)                                         \
+    do                                                                      \
+    {                                                                       \
+        if (pBlock != NULL)                                                 \
+            pArray = (void *)(pBlock + uOffset);                            \
+        uOffset += (sizeof(*(pArray)) * (uCount) + 15) & ~(size_t)15;       \
+    } while (0)
+
+    /* Scheduling fields first, then the names */
+    PLACE_ARRAY(g_Registry.puFirstCase, uSuites);
+    PLACE_ARRAY(g_Registry.puCaseCount, uSuites);
+    PLACE_ARRAY(g_Registry.peSuiteStatus, uSuites);
+    PLACE_ARRAY(g_Registry.pbParallel, uSuites);
+    PLACE_ARRAY(g_Registry.peStatus, uCases);
+    PLACE_ARRAY(g_Registry.puTimeout, uCases);
+    PLACE_ARRAY(g_Registry.pfnTestCase, uCases);
+    PLACE_ARRAY(g_Registry.puSuite, uCases);
+    PLACE_ARRAY(g_Registry.pdElapsedTime, uCases);
+    PLACE_ARRAY(g_Registry.puIterations, uCases);
+    PLACE_ARRAY(g_Registry.puWarmup, uCases);
+    PLACE_ARRAY(g_Registry.pLatency, uCases);
+    PLACE_ARRAY(g_Registry.pBenchmark, uCases);
+    PLACE_ARRAY(g_Registry.pThroughput, uCases);
+    PLACE_ARRAY(g_Registry.pUsage, uCases);
+    PLACE_ARRAY(g_Registry.pIrqStat, uCases);
+    PLACE_ARRAY(g_Registry.pStartBarrier, uCases);
+    PLACE_ARRAY(g_Registry.puHistogramSlot, uCases);
+    PLACE_ARRAY(g_Registry.pfnCleanup, uSuites);
+    PLACE_ARRAY(g_Registry.pszSuiteName, uSuites);
+    PLACE_ARRAY(g_Registry.pszCaseName, uCases);
+
+#undef PLACE_ARRAY
+
+    return uOffset;
+}
+
+
 /**=============================================================================
 
     Function Name   : addSuitesAndCases
     Description     : Function to add test cases and test suites from the shared
-                      objects to hash list test framework.
+                      objects to the test registry. The suites and cases are
+                      counted first and the registry is placed in one block.
     Arguments       : None
     Returns         : 0 ON SUCCESS, -1 ON FAILURE
 
@@ -504,112 +431,266 @@ int initializeTestSummary(void)
 
 int addSuitesAndCases(void)
 {
-    sTestCase_t *pHead1 = NULL, *pIndividual = NULL, *pTemp1 = NULL;
-    sTestCase_t *pTemp2 = NULL;
-    sTestSuite_t *pSuite = NULL, *pTemp3 = NULL;
-    int i = 1;
+    sUserTestSuite_t *pUserSuite = NULL;
+    sUserTestCase_t *pUserCase = NULL;
+    unsigned int uSuites = 0, uCases = 0, uSuite = 0, uCase = 0;
 
     deviceDrvTstFWDebug(LOG_TO_DBG,
     	"\tAdding test suites and test cases... [%s:%d]\n",
     	__FILENAME__, __LINE__);
 
-    if (strcmp(g_pUserTestSuite->szName, TEST_SUITE_END) != 0)
+    if (strcmp(g_pUserTestSuite->szName, TEST_SUITE_END) == 0)
     {
-		while (strcmp(g_pUserTestSuite->szName, TEST_SUITE_END) != 0)
-		{
-			/* Add test case */
-			pSuite = malloc(sizeof(sTestSuite_t));
-
-			if (!pSuite)
-			{
-				deviceDrvTstFWDebug(LOG_TO_USR,
-					"No memory to add test suite\n");
-				freeMemory(1);
-			}
+		if(g_bDebugLogFlag)
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tNo test suites and test cases in the shared object [%s:%d]\n",
+			__FILENAME__, __LINE__);
 
-			memset(pSuite, 0, sizeof(sTestSuite_t));
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"No test suites and test cases in the shared object\n");
 
-			if(strcmp(g_pUserTestSuite->pTestCase->szName, TEST_CASE_END) != 0)
-			{
+		return -1;
+	}
 
-				/* Iterate over the array of user test case structure */
-				while (
-					strcmp(g_pUserTestSuite->pTestCase->szName, TEST_CASE_END) != 0)
-				{
-					/* Add test case */
-					pIndividual = malloc(sizeof(sTestCase_t));
-					if (!pIndividual)
-					{
-						deviceDrvTstFWDebug(LOG_TO_USR, "No memory to add test case\n");
-						freeMemory(1);
-					}
-
-					memset(pIndividual, 0, sizeof(sTestCase_t));
-					strcpy(pIndividual->szName, g_pUserTestSuite->pTestCase->szName);
-					pIndividual->nTestCaseIden = i++;
-					pIndividual->uTimeout = g_pUserTestSuite->pTestCase->uTimeout;
-					pIndividual->fnPtrTestCase = dlsym(g_hObjectHandle,
-						g_pUserTestSuite->pTestCase->pTestCaseFuncName);
-					pIndividual->eStatus = E_NOT_FOUND;
-
-					deviceDrvTstFWDebug(LOG_TO_DBG, "\tAdding test case %s [%s:%d]\n",
-						pIndividual->szName, __FILENAME__, __LINE__);
-
-					HASH_ADD(hh, pHead1, szName, strlen(pIndividual->szName),
-						pIndividual);
-
-					g_pUserTestSuite->pTestCase++;
-					pIndividual=NULL;
-					g_pSummary->uNumberOfTests++;
-				}
-
-				strcpy(pSuite->szName, g_pUserTestSuite->szName);
-				pSuite->fnPtrCleanup = dlsym(g_hObjectHandle,
-					g_pUserTestSuite->pCleanupFuncName);
-				pSuite->sTestCaseList = pHead1;
+	/* Size the registry */
+	for (pUserSuite = g_pUserTestSuite;
+		strcmp(pUserSuite->szName, TEST_SUITE_END) != 0; pUserSuite++)
+	{
+		uSuites++;
+		for (pUserCase = pUserSuite->pTestCase;
+			strcmp(pUserCase->szName, TEST_CASE_END) != 0; pUserCase++)
+		{
+			uCases++;
+		}
+	}
 
+	g_pRegistry = calloc(1, layoutRegistry(NULL, uSuites, uCases));
+	if (!g_pRegistry)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"No memory to add test suites and test cases\n");
+		freeMemory(1);
+	}
+	layoutRegistry(g_pRegistry, uSuites, uCases);
 
+	for (pUserSuite = g_pUserTestSuite;
+		strcmp(pUserSuite->szName, TEST_SUITE_END) != 0; pUserSuite++)
+	{
+		if (strcmp(pUserSuite->pTestCase->szName, TEST_CASE_END) == 0)
+		{
+			if(g_bDebugLogFlag)
 				deviceDrvTstFWDebug(LOG_TO_DBG,
-					"\tAdding test suite %s [%s:%d]\n",
-				   pSuite->szName, __FILENAME__, __LINE__);
+					"\tTest suite %s is empty [%s:%d]\n",
+					pUserSuite->szName, __FILENAME__, __LINE__);
 
-				HASH_ADD_STR(g_pSuiteHead, szName, pSuite);
-				pHead1 = NULL;
-				g_pUserTestSuite++;
-				g_pSummary->uNumberOfSuites++;
-			}
-			else
-			{
-				if(g_bDebugLogFlag)
-					deviceDrvTstFWDebug(LOG_TO_DBG,
-						"\tTest suite %s is empty [%s:%d]\n",
-						g_pUserTestSuite->szName, __FILENAME__, __LINE__);
+			deviceDrvTstFWDebug(LOG_TO_USR,
+				"Test suite %s is empty\n", pUserSuite->szName);
+			continue;
+		}
 
-				deviceDrvTstFWDebug(LOG_TO_USR,
-					"Test suite %s is empty\n", g_pUserTestSuite->szName);
+		g_Registry.puFirstCase[uSuite] = uCase;
 
-				free(pSuite);
-				g_pUserTestSuite++;
-			}
+		/* Iterate over the array of user test case structure */
+		for (pUserCase = pUserSuite->pTestCase;
+			strcmp(pUserCase->szName, TEST_CASE_END) != 0; pUserCase++)
+		{
+			/* Add test case */
+			strcpy(g_Registry.pszCaseName[uCase], pUserCase->szName);
+			g_Registry.puTimeout[uCase] = pUserCase->uTimeout;
+			g_Registry.pfnTestCase[uCase] = dlsym(g_hObjectHandle,
+				pUserCase->pTestCaseFuncName);
+			g_Registry.peStatus[uCase] = E_NOT_FOUND;
+			g_Registry.puSuite[uCase] = uSuite;
+
+			deviceDrvTstFWDebug(LOG_TO_DBG, "\tAdding test case %s [%s:%d]\n",
+				g_Registry.pszCaseName[uCase], __FILENAME__, __LINE__);
+
+			uCase++;
+			g_pSummary->uNumberOfTests++;
 		}
+
+		g_Registry.puCaseCount[uSuite] = uCase - g_Registry.puFirstCase[uSuite];
+
+		strcpy(g_Registry.pszSuiteName[uSuite], pUserSuite->szName);
+		g_Registry.pfnCleanup[uSuite] = dlsym(g_hObjectHandle,
+			pUserSuite->pCleanupFuncName);
+
 		deviceDrvTstFWDebug(LOG_TO_DBG,
-			"\tTest suites and test cases added successfully [%s:%d]\n",
-			__FILENAME__, __LINE__);
+			"\tAdding test suite %s [%s:%d]\n",
+		   g_Registry.pszSuiteName[uSuite], __FILENAME__, __LINE__);
 
-		return 0;
+		uSuite++;
+		g_pSummary->uNumberOfSuites++;
 	}
-	else
-	{
-		if(g_bDebugLogFlag)
-			deviceDrvTstFWDebug(LOG_TO_DBG,
-			"\tNo test suites and test cases in the shared object [%s:%d]\n",
-			__FILENAME__, __LINE__);
 
-		deviceDrvTstFWDebug(LOG_TO_USR,
-			"No test suites and test cases in the shared object\n");
+	g_Registry.uNumberOfSuites = uSuite;
+	g_Registry.uNumberOfCases = uCase;
 
-		return -1;
-	}
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tTest suites and test cases added successfully [%s:%d]\n",
+		__FILENAME__, __LINE__);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+    Function Name   : applySuiteAttributes
+    Description     : Function to apply the suite attributes of the optional
+                      aTestSuiteAttr array in the shared object to the test
+                      suites of the registry.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void applySuiteAttributes(void)
+{
+    sUserTestSuiteAttr_t *pAttr = NULL;
+    int nSuite = 0;
+
+    pAttr = dlsym(g_hObjectHandle, "aTestSuiteAttr");
+    if (!pAttr)
+    {
+        return;
+    }
+
+    while (strcmp(pAttr->szName, TEST_SUITE_END) != 0)
+    {
+        nSuite = findTestSuite(pAttr->szName, strlen(pAttr->szName));
+        if (nSuite != -1)
+        {
+            g_Registry.pbParallel[nSuite] = pAttr->bParallel;
+
+            deviceDrvTstFWDebug(LOG_TO_DBG,
+                "\tTest suite %s parallel %d [%s:%d]\n",
+                g_Registry.pszSuiteName[nSuite], g_Registry.pbParallel[nSuite],
+                __FILENAME__, __LINE__);
+        }
+        else
+        {
+            deviceDrvTstFWDebug(LOG_TO_USR,
+                "Attributes of unknown test suite %s ignored\n",
+                pAttr->szName);
+        }
+
+        pAttr++;
+    }
+}
+
+
+/**=============================================================================
+
+    Function Name   : applyCaseAttributes
+    Description     : Function to apply the case attributes of the optional
+                      aTestCaseAttr array in the shared object to the test
+                      cases of the registry. Iterations above
+                      FW_MAX_ITERATIONS are cut to it.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void applyCaseAttributes(void)
+{
+    sUserTestCaseAttr_t *pAttr = NULL;
+    int nSuite = 0, nCase = -1;
+
+    pAttr = dlsym(g_hObjectHandle, "aTestCaseAttr");
+    if (!pAttr)
+    {
+        return;
+    }
+
+    while (strcmp(pAttr->szName, TEST_CASE_END) != 0)
+    {
+        nSuite = findTestSuite(pAttr->szSuiteName,
+            strlen(pAttr->szSuiteName));
+        nCase = (nSuite == -1) ? -1 :
+            findTestCase(nSuite, pAttr->szName, strlen(pAttr->szName));
+        if (nCase != -1)
+        {
+            g_Registry.puIterations[nCase] =
+                (pAttr->uIterations > FW_MAX_ITERATIONS) ?
+                FW_MAX_ITERATIONS : pAttr->uIterations;
+            g_Registry.puWarmup[nCase] = pAttr->uWarmup;
+
+            deviceDrvTstFWDebug(LOG_TO_DBG,
+                "\tTest case %s iterations %d warm-up %d [%s:%d]\n",
+                g_Registry.pszCaseName[nCase], g_Registry.puIterations[nCase],
+                g_Registry.puWarmup[nCase], __FILENAME__, __LINE__);
+        }
+        else
+        {
+            deviceDrvTstFWDebug(LOG_TO_USR,
+                "Attributes of unknown test case %s:%s ignored\n",
+                pAttr->szSuiteName, pAttr->szName);
+        }
+
+        pAttr++;
+    }
+}
+
+
+/**=============================================================================
+
+    Function Name   : applyBenchmarkAttributes
+    Description     : Function to make benchmarks of the test cases listed in
+                      the optional aBenchmarkAttr array in the shared object.
+                      Negative minimums are taken as no minimum.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void applyBenchmarkAttributes(void)
+{
+    sUserBenchmarkAttr_t *pAttr = NULL;
+    sBenchmark_t *pBenchmark = NULL;
+    int nSuite = 0, nCase = -1;
+
+    pAttr = dlsym(g_hObjectHandle, "aBenchmarkAttr");
+    if (!pAttr)
+    {
+        return;
+    }
+
+    while (strcmp(pAttr->szName, TEST_CASE_END) != 0)
+    {
+        nSuite = findTestSuite(pAttr->szSuiteName,
+            strlen(pAttr->szSuiteName));
+        nCase = (nSuite == -1) ? -1 :
+            findTestCase(nSuite, pAttr->szName, strlen(pAttr->szName));
+        if (nCase != -1)
+        {
+            pBenchmark = &g_Registry.pBenchmark[nCase];
+            pBenchmark->bEnabled = true;
+            pBenchmark->uDurationMs = pAttr->uDurationMs;
+            pBenchmark->uByteBudget = pAttr->uByteBudget;
+            pBenchmark->dMinMBps =
+                (pAttr->dMinMBps > 0) ? pAttr->dMinMBps : 0;
+            pBenchmark->dMinMessagesPerSec =
+                (pAttr->dMinMessagesPerSec > 0) ?
+                pAttr->dMinMessagesPerSec : 0;
+
+            deviceDrvTstFWDebug(LOG_TO_DBG,
+                "\tTest case %s benchmark %u ms %llu bytes, minimum "
+                "%.3f MB/s %.1f messages/s [%s:%d]\n",
+                g_Registry.pszCaseName[nCase], pBenchmark->uDurationMs,
+                (unsigned long long)pBenchmark->uByteBudget,
+                pBenchmark->dMinMBps, pBenchmark->dMinMessagesPerSec,
+                __FILENAME__, __LINE__);
+        }
+        else
+        {
+            deviceDrvTstFWDebug(LOG_TO_USR,
+                "Attributes of unknown test case %s:%s ignored\n",
+                pAttr->szSuiteName, pAttr->szName);
+        }
+
+        pAttr++;
+    }
 }
 
 
@@ -663,6 +744,74 @@ int initializeTestFramework(void)
     if (nRet != 0)
     	return -1;
 
+    /* Names are fixed from here on, index them for the lookups */
+    nRet = nameIndexBuild();
+    if (nRet != 0)
+    	return -1;
+
+    /* Optional suite and case attributes */
+    applySuiteAttributes();
+    applyCaseAttributes();
+    applyBenchmarkAttributes();
+
+    /* Durations of the previous runs order the cases, master only runs
+     * what its slaves ask for
+     */
+    if ((g_eMode != E_MASTER) || g_bCoordinator)
+    {
+        nRet = scheduleLoad();
+        if (nRet != 0)
+            return -1;
+    }
+
+    /* IRQs and interfaces watched around the cases, the results of the
+     * cases run by master are not reported
+     */
+    if (g_eMode != E_MASTER)
+    {
+        irqStatLoad();
+    }
+
+    /* Results written by the test execution processes, one set per slave
+     * connected to master
+     */
+    nRet = arenaCreate((g_eMode == E_MASTER) ? FW_MAX_SLAVES : 1);
+    if (nRet != 0)
+    	return -1;
+
+    /* Histograms recorded by the test cases, one slot per test execution
+     * process
+     */
+    nRet = histogramCreate((g_eMode == E_MASTER) ? FW_MAX_SLAVES :
+        (g_eMode == E_STANDALONE) ? FW_MAX_WORKERS : 1);
+    if (nRet != 0)
+    	return -1;
+
+    /* Clock of the other machine, one estimate per slave connected to
+     * master
+     */
+    if (g_eMode != E_STANDALONE)
+    {
+        nRet = clockSyncCreate((g_eMode == E_MASTER) ? FW_MAX_SLAVES : 1);
+        if (nRet != 0)
+            return -1;
+    }
+
+    /* Payload buffers of the test cases, one pool per test execution
+     * process, as many as the arena has slots since a session may take any
+     * of them. The coordinator runs no cases
+     */
+    if (g_eMode == E_MASTER)
+    {
+        nRet = g_bCoordinator ? 0 : bufferPoolCreate(FW_MAX_SLAVES);
+    }
+    else
+    {
+        nRet = bufferPoolCreate((g_eMode == E_STANDALONE) ? g_uWorkerCount : 1);
+    }
+    if (nRet != 0)
+    	return -1;
+
     deviceDrvTstFWDebug(LOG_TO_DBG,
         "\tTest framework initialized successfully [%s:%d]\n",
         __FILENAME__, __LINE__);
@@ -686,19 +835,23 @@ int initializeTestFramework(void)
 
 int constructFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szOutBuffer[])
 {
-    unsigned char szMsgBuffer[1024] = {0};
     unsigned int uMsgLength = 0;
     unsigned int uMsgChecksum = 0;
+    unsigned int uNameLength = 0;
 
 
     /* Create a packet */
 
     /* Add slave id */
-    szMsgBuffer[1] = pMsg->uSlaveId;
+    szOutBuffer[2] = pMsg->uSlaveId;
 
     /* Add message type to be sent */
-    szMsgBuffer[2] = pMsg->eMsgType;
-    uMsgLength = 3;
+    szOutBuffer[3] = pMsg->eMsgType;
+
+    /* Add sequence number */
+    szOutBuffer[4] = (unsigned char)(pMsg->uSeqNo & 0xff);
+    szOutBuffer[5] = (unsigned char)((pMsg->uSeqNo >> 8) & 0xff);
+    uMsgLength = FW_MSG_HEADER_LEN;
 
     switch (pMsg->eMsgType)
     {
@@ -709,48 +862,86 @@ int constructFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szOutBuffer[])
         case E_MSG_TST_CASE_LIST_COMPLETED:
         case E_MSG_TST_SUITE_LIST_COMPLETED:
         case E_MSG_CLOSE:
-        case E_MSG_TST_RUN:
         break;
 
         /* Add test case / test suite name to packet*/
         case E_MSG_TST_CASE_NAME:
         case E_MSG_TST_SUITE_NAME:
         {
-            uMsgLength ++;
-            szMsgBuffer[3] = strlen(pMsg->Msg.szName);
-            uMsgLength += strlen(pMsg->Msg.szName);
-            memcpy(&szMsgBuffer[4],pMsg->Msg.szName,strlen(pMsg->Msg.szName));
+            uNameLength = strlen(pMsg->Msg.szName);
+            szOutBuffer[uMsgLength++] = uNameLength;
+            memcpy(&szOutBuffer[uMsgLength], pMsg->Msg.szName, uNameLength);
+            uMsgLength += uNameLength;
             memset(pMsg->Msg.szName,0,30);
         }
         break;
 
+        /* Add test id of the test case to be executed / settled */
+        case E_MSG_TST_RUN:
+        case E_MSG_TST_RESULT:
+        {
+            szOutBuffer[uMsgLength++] = (unsigned char)(pMsg->Msg.uTestId & 0xff);
+            szOutBuffer[uMsgLength++] =
+                (unsigned char)((pMsg->Msg.uTestId >> 8) & 0xff);
+            szOutBuffer[uMsgLength++] =
+                (unsigned char)((pMsg->Msg.uTestId >> 16) & 0xff);
+            szOutBuffer[uMsgLength++] =
+                (unsigned char)((pMsg->Msg.uTestId >> 24) & 0xff);
+
+            /* Status and elapsed time of the settled case, start time
+             * of the run
+             */
+            if (pMsg->uPayloadLength != 0)
+            {
+                memcpy(&szOutBuffer[uMsgLength], pMsg->pPayload,
+                    pMsg->uPayloadLength);
+                uMsgLength += pMsg->uPayloadLength;
+            }
+        }
+        break;
+
         case E_MSG_STATUS:
         {
-            uMsgLength += sizeof(E_TST_STATUS);
-            szMsgBuffer[3] = pMsg->Msg.eStatus ;
+            szOutBuffer[uMsgLength++] = pMsg->Msg.eStatus;
+
+            /* Start time of the case run by master */
+            if (pMsg->uPayloadLength != 0)
+            {
+                memcpy(&szOutBuffer[uMsgLength], pMsg->pPayload,
+                    pMsg->uPayloadLength);
+                uMsgLength += pMsg->uPayloadLength;
+            }
+        }
+        break;
+
+        /* Add manifest records / manifest result bitmap / clock times */
+        case E_MSG_TST_MANIFEST:
+        case E_MSG_TST_MANIFEST_RSLT:
+        case E_MSG_CLOCK_SYNC:
+        case E_MSG_CLOCK_ESTIMATE:
+        {
+            memcpy(&szOutBuffer[uMsgLength], pMsg->pPayload,
+                pMsg->uPayloadLength);
+            uMsgLength += pMsg->uPayloadLength;
         }
         break;
     }
 
     /* Total length of the packet */
-    szMsgBuffer[0] = uMsgLength+sizeof(uMsgChecksum);
+    szOutBuffer[0] = (unsigned char)((uMsgLength + FW_MSG_CHECKSUM_LEN) & 0xff);
+    szOutBuffer[1] =
+        (unsigned char)(((uMsgLength + FW_MSG_CHECKSUM_LEN) >> 8) & 0xff);
 
-    uMsgChecksum = calculateChecksum(szMsgBuffer, uMsgLength);
+    uMsgChecksum = calculateChecksum(szOutBuffer, uMsgLength);
 
     /* Copy checksum LSB */
-    szMsgBuffer[uMsgLength] = (unsigned char)(uMsgChecksum & 0xff);
+    szOutBuffer[uMsgLength] = (unsigned char)(uMsgChecksum & 0xff);
 
     /* Copy checksum MSB */
-    szMsgBuffer[uMsgLength + 1] = (unsigned char)((uMsgChecksum>>8) & 0xff);
-
-    uMsgLength = uMsgLength+sizeof(uMsgChecksum);
-
-    /* Copy the packet to the output buffer */
-    memset(szOutBuffer,0,512);
-    memcpy(szOutBuffer,szMsgBuffer,uMsgLength);
+    szOutBuffer[uMsgLength + 1] = (unsigned char)((uMsgChecksum>>8) & 0xff);
 
     /* Return total packet length */
-    return uMsgLength;
+    return uMsgLength + FW_MSG_CHECKSUM_LEN;
 }
 
 
@@ -758,34 +949,36 @@ int constructFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szOutBuffer[])
 
     Function Name   : parseFrameworkMsg
     Description     : Function to parse the handshake message packet which
-                      will be received over ethernet.
+                      will be received over ethernet. Manifest payload is not
+                      copied, pPayload points into szInBuffer.
     Arguments       :
                       Name              Dir     Description
                       @pMsg             In      Pointer to msg
                       @szInBuffer       In      Output buffer
 
-    Returns         : None
+    Returns         : 0 ON SUCCESS, -1 if the packet is corrupted
 
   ============================================================================*/
 
-void parseFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szInBuffer[])
+int parseFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szInBuffer[])
 {
-    unsigned int uMsgLength = szInBuffer[0];
+    unsigned int uMsgLength = szInBuffer[0] | (szInBuffer[1] << 8);
     unsigned int uMsgNameLength = 0;
     unsigned int uMsgChecksum = 0;
+    unsigned int uOffset = FW_MSG_HEADER_LEN;
 
-    uMsgChecksum = (szInBuffer[uMsgLength - sizeof(uMsgChecksum)] & 0xff)
-     | ((szInBuffer[(uMsgLength - sizeof(uMsgChecksum))+1]<<8) & 0xff00);
+    uMsgChecksum = (szInBuffer[uMsgLength - FW_MSG_CHECKSUM_LEN] & 0xff)
+     | ((szInBuffer[(uMsgLength - FW_MSG_CHECKSUM_LEN)+1]<<8) & 0xff00);
 
     if(uMsgChecksum!=calculateChecksum(szInBuffer,
-                                    (uMsgLength - sizeof(uMsgChecksum))))
+                                    (uMsgLength - FW_MSG_CHECKSUM_LEN)))
     {
-        deviceDrvTstFWDebug(LOG_TO_USR, "Corrupted Message\n");
-        freeMemory(1);
+        return -1;
     }
 
-    pMsg->uSlaveId = szInBuffer[1];
-    pMsg->eMsgType = szInBuffer[2];
+    pMsg->uSlaveId = szInBuffer[2];
+    pMsg->eMsgType = szInBuffer[3];
+    pMsg->uSeqNo = szInBuffer[4] | (szInBuffer[5] << 8);
 
     switch (pMsg->eMsgType)
     {
@@ -796,27 +989,79 @@ void parseFrameworkMsg(sHandshakeMsg_t *pMsg, unsigned char szInBuffer[])
         case E_MSG_TST_SUITE_LIST_COMPLETED:
         case E_MSG_TST_CASE_LIST_COMPLETED:
         case E_MSG_CLOSE:
-        case E_MSG_TST_RUN:
         break;
 
         case E_MSG_TST_CASE_NAME:
         case E_MSG_TST_SUITE_NAME:
         {
-            uMsgNameLength = szInBuffer[3];
-            uMsgLength += strlen(pMsg->Msg.szName);
+            uMsgNameLength = szInBuffer[uOffset++];
+            if ((uMsgNameLength >= sizeof(pMsg->Msg.szName)) ||
+                ((uOffset + uMsgNameLength + FW_MSG_CHECKSUM_LEN) >
+                uMsgLength))
+            {
+                return -1;
+            }
 
-            memset(pMsg->Msg.szName, 0, 30);
+            memset(pMsg->Msg.szName, 0, sizeof(pMsg->Msg.szName));
 
             /* Copy the test case/test suite name received from the packet */
-            memcpy(pMsg->Msg.szName,&szInBuffer[4],uMsgNameLength);
+            memcpy(pMsg->Msg.szName, &szInBuffer[uOffset], uMsgNameLength);
+        }
+        break;
+
+        case E_MSG_TST_RUN:
+        case E_MSG_TST_RESULT:
+        {
+            if (uMsgLength < (FW_MSG_HEADER_LEN + 4 + FW_MSG_CHECKSUM_LEN))
+            {
+                return -1;
+            }
+
+            pMsg->Msg.uTestId = szInBuffer[uOffset] |
+                (szInBuffer[uOffset + 1] << 8) |
+                (szInBuffer[uOffset + 2] << 16) |
+                ((unsigned int)szInBuffer[uOffset + 3] << 24);
+
+            if (uMsgLength > (FW_MSG_HEADER_LEN + 4 + FW_MSG_CHECKSUM_LEN))
+            {
+                pMsg->pPayload = &szInBuffer[uOffset + 4];
+                pMsg->uPayloadLength = uMsgLength - FW_MSG_HEADER_LEN -
+                    FW_MSG_CHECKSUM_LEN - 4;
+            }
         }
         break;
+
         case E_MSG_STATUS:
         {
-            pMsg->Msg.eStatus = szInBuffer[3] ;
+            if (uMsgLength < (FW_MSG_HEADER_LEN + 1 + FW_MSG_CHECKSUM_LEN))
+            {
+                return -1;
+            }
+
+            pMsg->Msg.eStatus = szInBuffer[uOffset];
+
+            if (uMsgLength > (FW_MSG_HEADER_LEN + 1 + FW_MSG_CHECKSUM_LEN))
+            {
+                pMsg->pPayload = &szInBuffer[uOffset + 1];
+                pMsg->uPayloadLength = uMsgLength - FW_MSG_HEADER_LEN -
+                    FW_MSG_CHECKSUM_LEN - 1;
+            }
+        }
+        break;
+
+        case E_MSG_TST_MANIFEST:
+        case E_MSG_TST_MANIFEST_RSLT:
+        case E_MSG_CLOCK_SYNC:
+        case E_MSG_CLOCK_ESTIMATE:
+        {
+            pMsg->pPayload = &szInBuffer[uOffset];
+            pMsg->uPayloadLength = uMsgLength - FW_MSG_HEADER_LEN -
+                FW_MSG_CHECKSUM_LEN;
         }
         break;
     }
+
+    return 0;
 }
 
 /*******************************************************************************
@@ -850,34 +1095,133 @@ unsigned short int calculateChecksum(unsigned char *pszBuffer,
 /**=============================================================================
 
     Function Name   : sendMessage
-    Description     : Function to send the constructed message packet over
-                      ethernet.
+    Description     : Function to construct the message packet and to queue
+                      it for sending over ethernet. Queued packets are sent
+                      together by flushMessages.
     Arguments       :
                       Name              Dir     Description
+                      @pLink            In      Connection
                       @pMsg             In      Pointer to msg
 
     Returns         : None
 
   ============================================================================*/
 
-void sendMessage(sHandshakeMsg_t *pMsg)
+void sendMessage(sLink_t *pLink, sHandshakeMsg_t *pMsg)
 {
-    unsigned int uMsgLength = 0;
-    unsigned char szOutBuffer[1024];
+    /* Keep room for the largest packet */
+    if ((pLink->uTxLength + FW_MAX_MSG_LEN) > FW_TX_BUFFER_LEN)
+    {
+        flushMessages(pLink);
+    }
+
+    /* Failure is reported by the next flushMessages */
+    if (pLink->bClosed)
+    {
+        return;
+    }
 
     /* Construct Packet to be sent over ethernet */
-    uMsgLength = constructFrameworkMsg(pMsg, szOutBuffer);
+    pLink->uTxLength += constructFrameworkMsg(pMsg,
+        &pLink->szTxBuffer[pLink->uTxLength]);
+}
+
+
+/**=============================================================================
 
+    Function Name   : flushMessages
+    Description     : Function to send the queued message packets over
+                      ethernet. It has to be called before waiting for the
+                      reply of the other device.
+    Arguments       :
+                      Name              Dir     Description
+                      @pLink            In      Connection
+
+    Returns         : 0 ON SUCCESS, -1 if the connection is closed
+
+  ============================================================================*/
 
-    /*
-    if (g_eMode == E_SLAVE)
+int flushMessages(sLink_t *pLink)
+{
+    unsigned int uSent = 0;
+    int nRet = 0;
+
+    while (!pLink->bClosed && (uSent < pLink->uTxLength))
     {
-        sleep(1);	//for testing only
+        nRet = send(pLink->nSockfd, &pLink->szTxBuffer[uSent],
+            pLink->uTxLength - uSent, MSG_NOSIGNAL);
+        if (nRet < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            pLink->bClosed = true;
+            break;
+        }
+
+        uSent += nRet;
     }
-    */
 
-    /* Send the packet */
-    send(g_nSlaveSockfd, szOutBuffer, uMsgLength, 0);
+    pLink->uTxLength = 0;
+
+    return pLink->bClosed ? -1 : 0;
+}
+
+
+/**=============================================================================
+
+    Function Name   : getBufferedFrameLength
+    Description     : Function to get the length of the packet at the head of
+                      the receive buffer.
+    Arguments       :
+                      Name              Dir     Description
+                      @pLink            In      Connection
+
+    Returns         : Length of the packet, 0 if it is not received
+                      completely, -1 if its length is corrupted
+
+  ============================================================================*/
+
+static int getBufferedFrameLength(sLink_t *pLink)
+{
+    unsigned int uMsgLength = 0;
+
+    if ((pLink->uRxTail - pLink->uRxHead) < 2)
+    {
+        return 0;
+    }
+
+    uMsgLength = pLink->szRxBuffer[pLink->uRxHead] |
+        (pLink->szRxBuffer[pLink->uRxHead + 1] << 8);
+    if (uMsgLength < (FW_MSG_HEADER_LEN + FW_MSG_CHECKSUM_LEN))
+    {
+        return -1;
+    }
+
+    return ((pLink->uRxTail - pLink->uRxHead) < uMsgLength) ? 0 : uMsgLength;
+}
+
+
+/**=============================================================================
+
+    Function Name   : isMessageBuffered
+    Description     : Function to check whether a complete packet is already
+                      in the receive buffer. Such a packet does not make the
+                      socket readable again, so it has to be taken with
+                      receiveMessage before waiting on the socket.
+    Arguments       :
+                      Name              Dir     Description
+                      @pLink            In      Connection
+
+    Returns         : true if a complete or corrupted packet is buffered
+
+  ============================================================================*/
+
+bool isMessageBuffered(sLink_t *pLink)
+{
+    return (getBufferedFrameLength(pLink) != 0);
 }
 
 
@@ -885,31 +1229,84 @@ void sendMessage(sHandshakeMsg_t *pMsg)
 
     Function Name   : receiveMessage
     Description     : Function to receive the constructed message over ethernet.
+                      Whatever is available on the socket is read into the
+                      receive buffer and the packets are parsed in place, a
+                      partial packet is completed by the next read. The socket
+                      is not read while a complete packet is buffered. Payload
+                      of the parsed message stays valid till the next call.
+                      A corrupted packet closes the connection, the stream
+                      cannot be followed after it.
     Arguments       :
                       Name              Dir     Description
+                      @pLink            In      Connection
                       @pMsg             In      Pointer to msg
 
-    Returns         : None
+    Returns         : Length of the packet, 0 if socket is closed or the
+                      packet is corrupted, -1 if no complete packet is
+                      received yet
 
   ============================================================================*/
 
-int receiveMessage(sHandshakeMsg_t *pMsg)
+int receiveMessage(sLink_t *pLink, sHandshakeMsg_t *pMsg)
 {
     int nRet = 0;
-    unsigned char szInBuffer[1024] = {0};
+    int nMsgLength = 0;
 
-    /* Receive the packet */
-    nRet = recv(g_nSlaveSockfd, szInBuffer, 1024,0);
+    if (pLink->bClosed)
+    {
+        return 0;
+    }
 
-    if(nRet == 0)
+    nMsgLength = getBufferedFrameLength(pLink);
+    if (nMsgLength == 0)
     {
-    	return nRet;
+        /* Move the partial packet to the start to make room for a packet */
+        if ((FW_RX_BUFFER_LEN - pLink->uRxTail) < FW_MAX_MSG_LEN)
+        {
+            memmove(pLink->szRxBuffer, &pLink->szRxBuffer[pLink->uRxHead],
+                pLink->uRxTail - pLink->uRxHead);
+            pLink->uRxTail -= pLink->uRxHead;
+            pLink->uRxHead = 0;
+        }
+
+        nRet = recv(pLink->nSockfd, &pLink->szRxBuffer[pLink->uRxTail],
+            FW_RX_BUFFER_LEN - pLink->uRxTail, MSG_DONTWAIT);
+        if (nRet == 0)
+        {
+            return 0;
+        }
+        else if (nRet < 0)
+        {
+            return ((errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+                (errno == EINTR)) ? -1 : 0;
+        }
+
+        pLink->uRxTail += nRet;
+
+        nMsgLength = getBufferedFrameLength(pLink);
+        if (nMsgLength == 0)
+        {
+            return -1;
+        }
     }
 
     /* Parse the packet to get message type and test case/test suite name */
-    parseFrameworkMsg(pMsg, szInBuffer);
+    if ((nMsgLength < 0) ||
+        (parseFrameworkMsg(pMsg, &pLink->szRxBuffer[pLink->uRxHead]) != 0))
+    {
+        deviceDrvTstFWDebug(LOG_TO_USR, "Corrupted Message\n");
+        pLink->bClosed = true;
+        return 0;
+    }
 
-    return nRet;
+    pLink->uRxHead += nMsgLength;
+    if (pLink->uRxHead == pLink->uRxTail)
+    {
+        pLink->uRxHead = 0;
+        pLink->uRxTail = 0;
+    }
+
+    return nMsgLength;
 }
 
 
@@ -942,8 +1339,11 @@ void generateFileName(void)
 
 /**=============================================================================
 
-    Function Name   : generateXMLReport
-    Description     : Function to generate test report in the XML format.
+    Function Name   : openXMLReport
+    Description     : Function to create the test report and to write its
+                      header. The results are appended by reportTestCase as
+                      soon as they are settled and the report is completed by
+                      closeXMLReport, also when the framework exits on error.
                       Furthur XSL(XML Style Sheet) is used to display report
                       in tabular format.
     Arguments       : None
@@ -951,280 +1351,642 @@ void generateFileName(void)
 
   ============================================================================*/
 
-void generateXMLReport(void)
+void openXMLReport(void)
 {
-    sTestSuite_t *pSuite = NULL, *pTemp1 = NULL;
-    sTestCase_t *pTestcase = NULL, *pTemp2 = NULL;
-    xmlOutputBufferPtr *buf = NULL;
-    /* XML document pointer */
-    xmlDocPtr pDoc = NULL;
-
-    /* XML node pointers */
-    xmlNodePtr pPiNode = NULL;
-    xmlNodePtr pRootNode = NULL;
-    xmlNodePtr pTestSuiteNode = NULL;
-    xmlNodePtr pTestCaseNode = NULL;
-    xmlNodePtr pSummaryNode = NULL;
-
     deviceDrvTstFWDebug(LOG_TO_DBG,
     	"\tGenerating Test Report...[%s:%d]\n", __FILENAME__, __LINE__);
 
     /* Generate filename with timestamp */
     generateFileName();
 
-    /* LIBXML_TEST_VERSION
-     * This macro must always be called once, and only once, in the main thread
-     * of execution. It will initialize the data structures of the libxml2
-     * library and check for any ABI mis-matches between the library the program
-     * was compiled against and the one it is running with.
-     */
+    g_nReportFd = open(g_szFileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+        0644);
+    if (g_nReportFd == -1)
+    {
+        deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating test report\n");
+        return;
+    }
+
+    /* Output buffer writes straight to the descriptor when flushed */
+    g_pReportWriter = xmlNewTextWriter(xmlOutputBufferCreateFd(g_nReportFd,
+        NULL));
+    if (g_pReportWriter == NULL)
+    {
+        deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating test report\n");
+        close(g_nReportFd);
+        g_nReportFd = -1;
+        return;
+    }
+
+    xmlTextWriterSetIndent(g_pReportWriter, 1);
+    xmlTextWriterStartDocument(g_pReportWriter, NULL, "UTF-8", NULL);
+
+    /* Processing instruction for the style sheet */
+    xmlTextWriterWritePI(g_pReportWriter, BAD_CAST "xml-stylesheet",
+        BAD_CAST "type='text/xsl' href='testRsltStyle.xsl'");
 
-    //LIBXML_TEST_VERSION;
+    /* Root node and filename node */
+    xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "TestFramework");
+    xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "Filename",
+        BAD_CAST g_szFileName);
 
-    /* Create document node */
-    pDoc = xmlNewDoc(BAD_CAST "1.0");
+    xmlTextWriterFlush(g_pReportWriter);
+    g_uReportPending = 0;
+}
 
-    /* Create root node */
-    pRootNode = xmlNewNode(NULL, BAD_CAST "TestFramework");
 
-    /* Add root node to the document node */
-    xmlDocSetRootElement(pDoc, pRootNode);
+/**=============================================================================
 
-    /* Create processing instruction node */
-    pPiNode = xmlNewDocPI(pDoc, BAD_CAST "xml-stylesheet",
-                BAD_CAST "type='text/xsl' href='testRsltStyle.xsl'");
+    Function Name   : writeThroughput
+    Description     : Function to append the throughput of a benchmark case to
+                      its node, with the minimums it was held to.
+    Arguments       :
+                      Name                  Dir         Description
+                      @pThroughput          In          Throughput of the case
+    Returns         : None
 
-    /* Adding processing instruction node */
-    xmlAddPrevSibling(pRootNode, pPiNode);
+  ============================================================================*/
 
-    /* Create filename node */
-    xmlNewChild(pRootNode, NULL, BAD_CAST "Filename", BAD_CAST g_szFileName);
+static void writeThroughput(const sThroughput_t *pThroughput)
+{
+    xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Throughput");
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Calls", "%u",
+        pThroughput->uCalls);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Bytes",
+        "%llu", (unsigned long long)pThroughput->uBytes);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Messages",
+        "%llu", (unsigned long long)pThroughput->uMessages);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Duration",
+        "%.9lf", (double)pThroughput->uElapsedNs / 1e9);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "MBps",
+        "%.3lf", benchmarkMBps(pThroughput));
+    xmlTextWriterWriteFormatElement(g_pReportWriter,
+        BAD_CAST "MessagesPerSec", "%.1lf",
+        benchmarkMessagesPerSec(pThroughput));
+    xmlTextWriterWriteFormatElement(g_pReportWriter,
+        BAD_CAST "CpuTime", "%.9lf", (double)pThroughput->uCpuNs / 1e9);
+    if (pThroughput->uBytes > 0)
+    {
+        xmlTextWriterWriteFormatElement(g_pReportWriter,
+            BAD_CAST "CpuNsPerByte", "%.3lf",
+            (double)pThroughput->uCpuNs / pThroughput->uBytes);
+    }
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "MinMBps",
+        "%.3lf", pThroughput->dMinMBps);
+    xmlTextWriterWriteFormatElement(g_pReportWriter,
+        BAD_CAST "MinMessagesPerSec", "%.1lf",
+        pThroughput->dMinMessagesPerSec);
+    xmlTextWriterEndElement(g_pReportWriter);
+}
 
-    /* Create summary node */
-    pSummaryNode = xmlNewChild(pRootNode, NULL, BAD_CAST "Summary", NULL);
 
-    /* Adding child nodes of summary node */
-    sprintf(g_szLogBuffer, "%d", g_pSummary->uNumberOfSuites);
-    xmlNewChild(pSummaryNode, NULL, BAD_CAST "Suites",
-                                      BAD_CAST g_szLogBuffer);
+/**=============================================================================
 
-    sprintf(g_szLogBuffer, "%d", g_pSummary->uNumberOfTests);
-    xmlNewChild(pSummaryNode, NULL, BAD_CAST "Tests", BAD_CAST g_szLogBuffer);
+    Function Name   : writeIrqStat
+    Description     : Function to append the interrupts, softirqs and network
+                      traffic during a test case to its node, in the order
+                      of the names in the configuration. The rates are over
+                      the elapsed time of the case.
+    Arguments       :
+                      Name                  Dir         Description
+                      @pStat                In          Statistics of the case
+                      @dElapsedTime         In          Elapsed time in sec
+    Returns         : None
 
-    /* Traverse through the test cases and add fetch the test case status
-     * and elapsed time
-     */
+  ============================================================================*/
 
-    /* Check whether test summary is created */
-    if (g_pSummary == NULL)
+static void writeIrqStat(const sIrqStat_t *pStat, double dElapsedTime)
+{
+    const sNetStat_t *pNet = NULL;
+    double dPerSec = (dElapsedTime > 0) ? 1.0 / dElapsedTime : 0;
+    unsigned int i = 0;
+
+    if ((irqStatCount(E_STAT_IRQ) + irqStatCount(E_STAT_SOFTIRQ)) > 0)
     {
-        deviceDrvTstFWDebug(LOG_TO_USR, "No active test summary\n");
-        freeMemory(1);
+        xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Interrupts");
+        for (i = 0; i < irqStatCount(E_STAT_IRQ); i++)
+        {
+            xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Irq");
+            xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "Name",
+                BAD_CAST irqStatName(E_STAT_IRQ, i));
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Count",
+                "%llu", (unsigned long long)pStat->auIrq[i]);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "PerSec", "%.1lf", pStat->auIrq[i] * dPerSec);
+            xmlTextWriterEndElement(g_pReportWriter);
+        }
+        for (i = 0; i < irqStatCount(E_STAT_SOFTIRQ); i++)
+        {
+            xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "SoftIrq");
+            xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "Name",
+                BAD_CAST irqStatName(E_STAT_SOFTIRQ, i));
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Count",
+                "%llu", (unsigned long long)pStat->auSoftIrq[i]);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "PerSec", "%.1lf", pStat->auSoftIrq[i] * dPerSec);
+            xmlTextWriterEndElement(g_pReportWriter);
+        }
+        xmlTextWriterEndElement(g_pReportWriter);
     }
 
-    HASH_ITER(hh, g_pSuiteHead, pSuite, pTemp1)
+    if (irqStatCount(E_STAT_NET) > 0)
     {
-        if(pSuite->eStatus == E_FOUND)
+        xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Network");
+        for (i = 0, pNet = pStat->aNet; i < irqStatCount(E_STAT_NET);
+            i++, pNet++)
         {
-            HASH_ITER(hh,pSuite->sTestCaseList, pTestcase, pTemp2)
-            {
-               /* Create test suite node */
-               pTestSuiteNode = xmlNewChild(pRootNode, NULL,
-                                       BAD_CAST "TestSuite", NULL);
-               xmlNewChild(pTestSuiteNode, NULL, BAD_CAST "Name",
-                              BAD_CAST pSuite->szName);
-
-               /* Create test case node */
-               pTestCaseNode = xmlNewChild(pTestSuiteNode, NULL,
-                                       BAD_CAST "TestCase", NULL);
-               xmlNewChild(pTestCaseNode, NULL, BAD_CAST "Name",
-                           BAD_CAST pTestcase->szName);
-
-
-               if (pTestcase->eStatus == E_PASSED)
-               {
-                   /* Create test case result node */
-                   xmlNewChild(pTestCaseNode, NULL, BAD_CAST "Result",
-                                                   BAD_CAST "PASSED");
-
-                   /* Create elapsed time node */
-                   sprintf(g_szLogBuffer, "%lf",
-                                       pTestcase->dElapsedTime);
-                   xmlNewChild(pTestCaseNode, NULL,
-                       BAD_CAST "ElapsedTime", BAD_CAST g_szLogBuffer);
-               }
-               else if (pTestcase->eStatus == E_FAILED)
-               {
-                   /* Create test case result node */
-                   xmlNewChild(pTestCaseNode, NULL, BAD_CAST "Result",
-                                                   BAD_CAST "FAILED");
-
-                   /* Create elapsed time node */
-                   sprintf(g_szLogBuffer, "%lf",
-                                       pTestcase->dElapsedTime);
-                   xmlNewChild(pTestCaseNode, NULL,
-                       BAD_CAST "ElapsedTime", BAD_CAST g_szLogBuffer);
-               }
-               else if (pTestcase->eStatus == E_TIMEOUT)
-               {
-                   /* Create test case result node */
-                   xmlNewChild(pTestCaseNode, NULL, BAD_CAST "Result",
-                                                   BAD_CAST "TIMEOUT");
-
-                   /* Create elapsed time node */
-                   xmlNewChild(pTestCaseNode, NULL,
-                       BAD_CAST "ElapsedTime", BAD_CAST "-");
-               }
-               else if (pTestcase->eStatus == E_NOT_FOUND)
-               {
-                   /* Create test case result node */
-                   xmlNewChild(pTestCaseNode, NULL, BAD_CAST "Result",
-                                                   BAD_CAST "NOT FOUND");
-
-                   /* Create elapsed time node */
-                   xmlNewChild(pTestCaseNode, NULL,
-                       BAD_CAST "ElapsedTime", BAD_CAST "-");
-               }
-           }
-       }
-       else
-       {
-                /* Create test suite node */
-               pTestSuiteNode = xmlNewChild(pRootNode, NULL,
-                                       BAD_CAST "TestSuite", NULL);
-               xmlNewChild(pTestSuiteNode, NULL, BAD_CAST "Name",
-                              BAD_CAST pSuite->szName);
-
-               /* Create test case node */
-               pTestCaseNode = xmlNewChild(pTestSuiteNode, NULL,
-                                       BAD_CAST "TestCase", NULL);
-
-               xmlNewChild(pTestCaseNode, NULL, BAD_CAST "Name", BAD_CAST "-");
-
-               /* Create test suite result node */
-               xmlNewChild(pTestCaseNode, NULL, BAD_CAST "Result",
-                                                   BAD_CAST "NOT FOUND");
-
-               /* Create elapsed time node */
-               xmlNewChild(pTestCaseNode, NULL,
-                       BAD_CAST "ElapsedTime", BAD_CAST "-");
-       }
-   }
-
-    /* Create child nodes of summary node*/
-    sprintf(g_szLogBuffer, "%d", g_pSummary->uNumberOfTestsNotFound);
-    xmlNewChild(pSummaryNode, NULL, BAD_CAST "TestsNotFound",
-                                                    BAD_CAST g_szLogBuffer);
-
-    sprintf(g_szLogBuffer, "%d", g_pSummary->uNumberOfSuitesNotFound);
-    xmlNewChild(pSummaryNode, NULL, BAD_CAST "SuitesNotFound",
-                                                    BAD_CAST g_szLogBuffer);
-
-    sprintf(g_szLogBuffer, "%d", g_pSummary->uNumberOfTestsPassed);
-    xmlNewChild(pSummaryNode, NULL, BAD_CAST "TestsPassed",
-                                                    BAD_CAST g_szLogBuffer);
-
-    sprintf(g_szLogBuffer, "%d", g_pSummary->uNumberOfTestsFailed);
-    xmlNewChild(pSummaryNode, NULL, BAD_CAST "TestsFailed",
-                                                    BAD_CAST g_szLogBuffer);
-
-    sprintf(g_szLogBuffer, "%d", g_pSummary->uNumberOfTestsTimeout);
-    xmlNewChild(pSummaryNode, NULL, BAD_CAST "TestsTimeout",
-                                                    BAD_CAST g_szLogBuffer);
-
-    /* Save the xml tree to the filename */
-    xmlSaveFormatFileEnc(g_szFileName, pDoc, "UTF-8", 1);
+            xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Interface");
+            xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "Name",
+                BAD_CAST irqStatName(E_STAT_NET, i));
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "RxPackets", "%llu",
+                (unsigned long long)pNet->uRxPackets);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "RxBytes", "%llu",
+                (unsigned long long)pNet->uRxBytes);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "RxDrops", "%llu",
+                (unsigned long long)pNet->uRxDrops);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "TxPackets", "%llu",
+                (unsigned long long)pNet->uTxPackets);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "TxBytes", "%llu",
+                (unsigned long long)pNet->uTxBytes);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "TxDrops", "%llu",
+                (unsigned long long)pNet->uTxDrops);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "RxPacketsPerSec", "%.1lf",
+                pNet->uRxPackets * dPerSec);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "TxPacketsPerSec", "%.1lf",
+                pNet->uTxPackets * dPerSec);
+            xmlTextWriterEndElement(g_pReportWriter);
+        }
+        xmlTextWriterEndElement(g_pReportWriter);
+    }
+}
 
-    deviceDrvTstFWDebug(LOG_TO_DBG, "\tTest Report Generated [%s:%d]\n",
-    	__FILENAME__, __LINE__);
 
-    /* Free document node pointer */
-    xmlFreeDoc(pDoc);
+/**=============================================================================
 
-    /* Cleanup memory allocated by the library */
-    xmlCleanupParser();
+    Function Name   : writeHistograms
+    Description     : Function to append the histograms recorded by a test
+                      case to its node. The buckets with values are written as
+                      Lowest value:Count pairs, so the distribution can be
+                      rebuilt from the report.
+    Arguments       :
+                      Name                  Dir         Description
+                      @pSlot                In          Histograms of the case
+    Returns         : None
 
-    xmlMemoryDump();
+  ============================================================================*/
+
+static void writeHistograms(const sHistogramSlot_t *pSlot)
+{
+    const sTestHistogram_t *pHistogram = NULL;
+    unsigned int uSeries = 0, uBucket = 0;
+    const char *pszSeparator = NULL;
+
+    uSeries = __atomic_load_n(&pSlot->uSeries, __ATOMIC_ACQUIRE);
+    for (pHistogram = pSlot->aSeries; uSeries > 0; uSeries--, pHistogram++)
+    {
+        xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Histogram");
+        xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "Name",
+            BAD_CAST pHistogram->szName);
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Count",
+            "%llu", (unsigned long long)pHistogram->uCount);
+
+        if (pHistogram->uCount > 0)
+        {
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Min",
+                "%llu", (unsigned long long)pHistogram->uMin);
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Mean",
+                "%llu", (unsigned long long)(pHistogram->uSum /
+                pHistogram->uCount));
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "P50",
+                "%llu", (unsigned long long)
+                histogramPercentile(pHistogram, 50));
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "P90",
+                "%llu", (unsigned long long)
+                histogramPercentile(pHistogram, 90));
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "P99",
+                "%llu", (unsigned long long)
+                histogramPercentile(pHistogram, 99));
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "P999",
+                "%llu", (unsigned long long)
+                histogramPercentile(pHistogram, 99.9));
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Max",
+                "%llu", (unsigned long long)pHistogram->uMax);
+
+            xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Buckets");
+            for (uBucket = 0, pszSeparator = ""; uBucket < HISTOGRAM_BUCKETS;
+                uBucket++)
+            {
+                if (pHistogram->auBucket[uBucket] != 0)
+                {
+                    xmlTextWriterWriteFormatString(g_pReportWriter,
+                        "%s%llu:%llu", pszSeparator,
+                        (unsigned long long)histogramBucketValue(uBucket),
+                        (unsigned long long)pHistogram->auBucket[uBucket]);
+                    pszSeparator = " ";
+                }
+            }
+            xmlTextWriterEndElement(g_pReportWriter);
+        }
+
+        xmlTextWriterEndElement(g_pReportWriter);
+
+        deviceDrvTstFWDebug(LOG_TO_USR,
+            "%s: %llu values, p50 %llu p99 %llu max %llu\n",
+            pHistogram->szName, (unsigned long long)pHistogram->uCount,
+            (unsigned long long)histogramPercentile(pHistogram, 50),
+            (unsigned long long)histogramPercentile(pHistogram, 99),
+            (unsigned long long)pHistogram->uMax);
+    }
 }
 
 
 /**=============================================================================
 
-    Function Name   : peek
-    Description     : Function to fetch the number of bytes available to read
-    Arguments       : None
-    Returns         : Number of bytes
+    Function Name   : writeUsage
+    Description     : Function to append the resources used by a test case to
+                      its node, the CPU times in seconds as the elapsed time.
+                      The perf counters are only there when they could be
+                      read.
+    Arguments       :
+                      Name                  Dir         Description
+                      @pUsage               In          Usage of the case
+    Returns         : None
 
   ============================================================================*/
 
-int peek(void)
+static void writeUsage(const sUsage_t *pUsage)
 {
-    int nBytesAvailable = 0, nError = 0;
-    fd_set readset, errors;
+    xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Usage");
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "UserTime",
+        "%.9lf", (double)pUsage->uUserNs / 1e9);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "SystemTime",
+        "%.9lf", (double)pUsage->uSystemNs / 1e9);
+    xmlTextWriterWriteFormatElement(g_pReportWriter,
+        BAD_CAST "VoluntarySwitches", "%llu",
+        (unsigned long long)pUsage->uVoluntarySwitches);
+    xmlTextWriterWriteFormatElement(g_pReportWriter,
+        BAD_CAST "InvoluntarySwitches", "%llu",
+        (unsigned long long)pUsage->uInvoluntarySwitches);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "MinorFaults",
+        "%llu", (unsigned long long)pUsage->uMinorFaults);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "MajorFaults",
+        "%llu", (unsigned long long)pUsage->uMajorFaults);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "InBlocks",
+        "%llu", (unsigned long long)pUsage->uInBlocks);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "OutBlocks",
+        "%llu", (unsigned long long)pUsage->uOutBlocks);
+    xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "MaxRssGrowthKB",
+        "%llu", (unsigned long long)pUsage->uMaxRssKb);
+    if (pUsage->bCounters)
+    {
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Cycles",
+            "%llu", (unsigned long long)pUsage->uCycles);
+        xmlTextWriterWriteFormatElement(g_pReportWriter,
+            BAD_CAST "Instructions", "%llu",
+            (unsigned long long)pUsage->uInstructions);
+        xmlTextWriterWriteFormatElement(g_pReportWriter,
+            BAD_CAST "CacheMisses", "%llu",
+            (unsigned long long)pUsage->uCacheMisses);
+    }
+    xmlTextWriterEndElement(g_pReportWriter);
+}
 
-    /* Initialize time out struct for select() */
-    struct timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = 10000;
 
-    /* Initialize the set */
-    FD_ZERO(&readset);
-    FD_SET(g_nSlaveSockfd, &readset);
-    FD_ZERO(&errors);
-    FD_SET(g_nSlaveSockfd, &errors);
+/**=============================================================================
+
+    Function Name   : writeTestSuiteNode
+    Description     : Function to append one test suite node, holding a single
+                      test case, to the report. The report is flushed every
+                      REPORT_FLUSH_INTERVAL nodes.
+    Arguments       :
+                      Name                  Dir         Description
+                      @pszSuiteName         In          Test suite name
+                      @pszCaseName          In          Test case name
+                      @pszResult            In          Result
+                      @pszElapsedTime       In          Elapsed time
+                      @nCase                In          Case whose latency,
+                                                        throughput, start,
+                                                        usage, kernel
+                                                        statistics and
+                                                        histograms are written,
+                                                        -1 for none
+    Returns         : None
+
+  ============================================================================*/
+
+static void writeTestSuiteNode(unsigned char *pszSuiteName,
+    unsigned char *pszCaseName, char *pszResult, char *pszElapsedTime,
+    int nCase)
+{
+    const sLatency_t *pLatency = NULL;
+    const sThroughput_t *pThroughput = NULL;
+    const sUsage_t *pUsage = NULL;
+    const sIrqStat_t *pIrqStat = NULL;
+    const sStartBarrier_t *pBarrier = NULL;
+    const sHistogramSlot_t *pHistograms = NULL;
+
+    if (g_pReportWriter == NULL)
+    {
+        return;
+    }
 
-    /* Now, check for readability */
-    nError = select(g_nSlaveSockfd+1, &readset, NULL, &errors, &tv);
-    if (nError > 0)
+    if (nCase != -1)
     {
-        if (FD_ISSET(g_nSlaveSockfd, &errors))
+        pLatency = &g_Registry.pLatency[nCase];
+        pThroughput = &g_Registry.pThroughput[nCase];
+        pUsage = &g_Registry.pUsage[nCase];
+        pIrqStat = &g_Registry.pIrqStat[nCase];
+        pBarrier = &g_Registry.pStartBarrier[nCase];
+
+        /* Histograms of a case which ran in a test execution process */
+        if (g_Registry.puHistogramSlot[nCase] != 0)
         {
-            nBytesAvailable=-1;
+            pHistograms =
+                histogramSlot(g_Registry.puHistogramSlot[nCase] - 1);
         }
-        else if (FD_ISSET(g_nSlaveSockfd, &readset))
+    }
+
+    /* Create test suite node */
+    xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "TestSuite");
+    xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "Name",
+        BAD_CAST pszSuiteName);
+
+    /* Create test case node */
+    xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "TestCase");
+    xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "Name",
+        BAD_CAST pszCaseName);
+    xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "Result",
+        BAD_CAST pszResult);
+    xmlTextWriterWriteElement(g_pReportWriter, BAD_CAST "ElapsedTime",
+        BAD_CAST pszElapsedTime);
+
+    /* Latency in seconds, as the elapsed time */
+    if ((pLatency != NULL) && (pLatency->uIterations > 0))
+    {
+        xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "Latency");
+        xmlTextWriterWriteFormatElement(g_pReportWriter,
+            BAD_CAST "Iterations", "%u", pLatency->uIterations);
+        xmlTextWriterWriteFormatElement(g_pReportWriter,
+            BAD_CAST "Warmup", "%u", pLatency->uWarmup);
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Min",
+            "%.9lf", (double)pLatency->uMinNs / 1e9);
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Mean",
+            "%.9lf", (double)pLatency->uMeanNs / 1e9);
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "P50",
+            "%.9lf", (double)pLatency->uP50Ns / 1e9);
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "P99",
+            "%.9lf", (double)pLatency->uP99Ns / 1e9);
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Max",
+            "%.9lf", (double)pLatency->uMaxNs / 1e9);
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "StdDev",
+            "%.9lf", (double)pLatency->uStdDevNs / 1e9);
+        xmlTextWriterEndElement(g_pReportWriter);
+    }
+
+    if ((pThroughput != NULL) && (pThroughput->uCalls > 0))
+    {
+        writeThroughput(pThroughput);
+    }
+
+    /* Start of a scheduled case in seconds, skew is the start of master
+     * minus the local start
+     */
+    if ((pBarrier != NULL) && pBarrier->bScheduled)
+    {
+        xmlTextWriterStartElement(g_pReportWriter, BAD_CAST "StartBarrier");
+        xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Late",
+            "%.9lf", (double)pBarrier->nLateNs / 1e9);
+        if (pBarrier->bSkewKnown)
         {
-            nBytesAvailable=1;
+            xmlTextWriterWriteFormatElement(g_pReportWriter, BAD_CAST "Skew",
+                "%.9lf", (double)pBarrier->nSkewNs / 1e9);
+            xmlTextWriterWriteFormatElement(g_pReportWriter,
+                BAD_CAST "SkewError", "%.9lf",
+                (double)pBarrier->uErrorNs / 1e9);
         }
-        /* Clear flags */
-        FD_CLR(g_nSlaveSockfd, &readset);
-        FD_CLR(g_nSlaveSockfd, &errors);
+        xmlTextWriterEndElement(g_pReportWriter);
+    }
+
+    if ((pUsage != NULL) && (pUsage->uState == E_USAGE_DONE))
+    {
+        writeUsage(pUsage);
+    }
+
+    if ((pIrqStat != NULL) && (pIrqStat->uState == E_USAGE_DONE))
+    {
+        writeIrqStat(pIrqStat, g_Registry.pdElapsedTime[nCase]);
+    }
+
+    if (pHistograms != NULL)
+    {
+        writeHistograms(pHistograms);
+    }
+    xmlTextWriterEndElement(g_pReportWriter);
+
+    xmlTextWriterEndElement(g_pReportWriter);
+
+    if (++g_uReportPending >= REPORT_FLUSH_INTERVAL)
+    {
+        xmlTextWriterFlush(g_pReportWriter);
+        g_uReportPending = 0;
     }
-    return nBytesAvailable;
 }
 
 
 /**=============================================================================
 
-    Function Name   : checkTimer
-    Description     : Function to set the timer or to get the remaining
-    				  timer value
+    Function Name   : reportTestCase
+    Description     : Function to append the result of a settled test case to
+                      the report, with the resources it used and the
+                      histograms it recorded. The latency of a case run in
+                      iterations, the throughput of a benchmark and the
+                      histograms are also shown to the user.
     Arguments       :
                       Name                  Dir         Description
-                      @pTimerID				In			Pointer to timer
-                      @nMsec				In			Time in milliseconds
-                      @bSet					In			Flag
-    Returns         : 0 if bSet is true, else milliseconds.
+                      @uCase                In          Case index
+    Returns         : None
 
   ============================================================================*/
 
-uint64_t checkTimer(timer_t *pTimerID, unsigned int nMsec, bool bSet)
+void reportTestCase(unsigned int uCase)
 {
-    struct itimerspec its;
-    if (true == bSet)
+    unsigned char *pszSuiteName =
+        g_Registry.pszSuiteName[g_Registry.puSuite[uCase]];
+    unsigned char *pszCaseName = g_Registry.pszCaseName[uCase];
+    sLatency_t *pLatency = &g_Registry.pLatency[uCase];
+    sThroughput_t *pThroughput = &g_Registry.pThroughput[uCase];
+    char szElapsedTime[32];
+
+    sprintf(szElapsedTime, "%.9lf", g_Registry.pdElapsedTime[uCase]);
+
+    if (g_Registry.peStatus[uCase] == E_PASSED)
+    {
+        writeTestSuiteNode(pszSuiteName, pszCaseName, "PASSED",
+            szElapsedTime, uCase);
+    }
+    else if (g_Registry.peStatus[uCase] == E_FAILED)
+    {
+        writeTestSuiteNode(pszSuiteName, pszCaseName, "FAILED",
+            szElapsedTime, uCase);
+    }
+    else if (g_Registry.peStatus[uCase] == E_TIMEOUT)
+    {
+        writeTestSuiteNode(pszSuiteName, pszCaseName, "TIMEOUT", "-",
+            uCase);
+    }
+    else if (g_Registry.peStatus[uCase] == E_NOT_FOUND)
     {
-    	its.it_interval.tv_sec = 0;
-        its.it_interval.tv_nsec = 0;
-        its.it_value.tv_sec = nMsec/1000;
-        its.it_value.tv_nsec = (nMsec%1000)*1000000;
+        writeTestSuiteNode(pszSuiteName, pszCaseName, "NOT FOUND", "-",
+            -1);
+    }
 
-        timer_settime(*pTimerID, 0, &its, NULL);
-        return 0;
+    if ((pLatency->uIterations > 0) &&
+        ((g_Registry.peStatus[uCase] == E_PASSED) ||
+        (g_Registry.peStatus[uCase] == E_FAILED)))
+    {
+        deviceDrvTstFWDebug(LOG_TO_USR,
+            "%s: %u iterations, min %.3f mean %.3f p50 %.3f p99 %.3f "
+            "max %.3f stddev %.3f us\n", pszCaseName, pLatency->uIterations,
+            (double)pLatency->uMinNs / 1e3, (double)pLatency->uMeanNs / 1e3,
+            (double)pLatency->uP50Ns / 1e3, (double)pLatency->uP99Ns / 1e3,
+            (double)pLatency->uMaxNs / 1e3,
+            (double)pLatency->uStdDevNs / 1e3);
     }
-    else
+
+    if ((pThroughput->uCalls > 0) &&
+        ((g_Registry.peStatus[uCase] == E_PASSED) ||
+        (g_Registry.peStatus[uCase] == E_FAILED)))
+    {
+        deviceDrvTstFWDebug(LOG_TO_USR,
+            "%s: %llu bytes in %u calls, %.3f MB/s %.1f messages/s, "
+            "%.3f ns CPU per byte%s\n", pszCaseName,
+            (unsigned long long)pThroughput->uBytes, pThroughput->uCalls,
+            benchmarkMBps(pThroughput), benchmarkMessagesPerSec(pThroughput),
+            (pThroughput->uBytes > 0) ?
+            (double)pThroughput->uCpuNs / pThroughput->uBytes : 0.0,
+            benchmarkBelowMinimum(pThroughput) ? ", below minimum" : "");
+    }
+}
+
+
+/**=============================================================================
+
+    Function Name   : reportTestSuiteNotFound
+    Description     : Function to append a test suite not found in master to
+                      the report.
+    Arguments       :
+                      Name                  Dir         Description
+                      @uSuite               In          Suite index
+    Returns         : None
+
+  ============================================================================*/
+
+void reportTestSuiteNotFound(unsigned int uSuite)
+{
+    writeTestSuiteNode(g_Registry.pszSuiteName[uSuite], "-", "NOT FOUND", "-",
+        -1);
+}
+
+
+/**=============================================================================
+
+    Function Name   : closeXMLReport
+    Description     : Function to write the summary, to close the root node
+                      and to flush the report. It is called at the end of the
+                      run and by freeMemory, so the report is a complete
+                      document even when the framework exits on error. The
+                      durations of the reported cases are added to the
+                      duration history.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void closeXMLReport(void)
+{
+    xmlTextWriterPtr pWriter = g_pReportWriter;
+    sClockEstimate_t Clock;
+
+    if (pWriter == NULL)
+    {
+        return;
+    }
+
+    /* freeMemory may be called again on a write error */
+    g_pReportWriter = NULL;
+
+    if (g_pSummary != NULL)
     {
-    	timer_gettime(*pTimerID, &its);
-    	return its.it_value.tv_sec;
+        /* Create summary node */
+        xmlTextWriterStartElement(pWriter, BAD_CAST "Summary");
+
+        xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "Suites", "%d",
+            g_pSummary->uNumberOfSuites);
+        xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "Tests", "%d",
+            g_pSummary->uNumberOfTests);
+        xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "TestsNotFound",
+            "%d", g_pSummary->uNumberOfTestsNotFound);
+        xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "SuitesNotFound",
+            "%d", g_pSummary->uNumberOfSuitesNotFound);
+        xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "TestsPassed",
+            "%d", g_pSummary->uNumberOfTestsPassed);
+        xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "TestsFailed",
+            "%d", g_pSummary->uNumberOfTestsFailed);
+        xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "TestsTimeout",
+            "%d", g_pSummary->uNumberOfTestsTimeout);
+
+        if (g_pSummary->dMakespan > 0)
+        {
+            xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "Makespan",
+                "%.6lf", g_pSummary->dMakespan);
+            xmlTextWriterWriteFormatElement(pWriter,
+                BAD_CAST "IdealMakespan", "%.6lf",
+                g_pSummary->dIdealMakespan);
+        }
+
+        /* Last clock estimate of master, taken by the slave */
+        if ((g_eMode == E_SLAVE) && clockSyncRead(0, &Clock))
+        {
+            xmlTextWriterStartElement(pWriter, BAD_CAST "ClockSync");
+            xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "Offset",
+                "%lld", (long long)(Clock.uRemoteRefNs - Clock.uLocalRefNs));
+            xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "DriftPpm",
+                "%.3lf", (Clock.dRate - 1) * 1e6);
+            xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "Error",
+                "%llu", (unsigned long long)Clock.uErrorNs);
+            xmlTextWriterWriteFormatElement(pWriter, BAD_CAST "Rounds",
+                "%u", Clock.uRounds);
+            xmlTextWriterEndElement(pWriter);
+        }
+
+        xmlTextWriterEndElement(pWriter);
     }
+
+    /* Close root node and the document */
+    xmlTextWriterEndDocument(pWriter);
+    xmlFreeTextWriter(pWriter);
+
+    close(g_nReportFd);
+    g_nReportFd = -1;
+
+    deviceDrvTstFWDebug(LOG_TO_DBG, "\tTest Report Generated [%s:%d]\n",
+    	__FILENAME__, __LINE__);
+
+    /* Durations of the cases in the report are kept for the next run */
+    scheduleSave();
+
+    /* Cleanup memory allocated by the library */
+    xmlCleanupParser();
+
+    xmlMemoryDump();
 }
 
 
@@ -1243,7 +2005,8 @@ void printUsage(void)
        "\n Usage: ./testFW <mode> <IP-address> <shared-object-filename>\n");
 
     fprintf(stderr, "\n mode                     ");
-    fprintf(stderr, "\t\tIt can be Master/Slave/Standalone/--help/-h\n");
+    fprintf(stderr,
+        "\t\tIt can be Master/Slave/Standalone/Coordinator/--help/-h\n");
 
     fprintf(stderr, "\n IP-address               ");
     fprintf(stderr, "Master IP address and will be used ");
@@ -1254,7 +2017,8 @@ void printUsage(void)
 
     fprintf(stderr, "\n For example: ./testFW Slave 127.0.0.1 testcases\n");
     fprintf(stderr, "              ./testFW Master testcases\n");
-    fprintf(stderr, "              ./testFW Standalone testcases\n\n");
+    fprintf(stderr, "              ./testFW Standalone testcases\n");
+    fprintf(stderr, "              ./testFW Coordinator testcases\n\n");
 
     freeMemory(1);
 }
@@ -1297,8 +2061,6 @@ void printHeader(void)
 
 void freeMemory(bool status)
 {
-    sTestSuite_t *pSuite = NULL,*pTemp1 = NULL;
-    sTestCase_t *pTestcase = NULL, *pTemp2 = NULL, *pTemp3 = NULL;
 
     deviceDrvTstFWDebug(LOG_TO_USR, "Closing test framework...\n");
 
@@ -1306,48 +2068,33 @@ void freeMemory(bool status)
     	deviceDrvTstFWDebug(LOG_TO_DBG, "\tClosing test framework... [%s:%d]\n",
     	__FILENAME__, __LINE__);
 
+    /* Results settled so far are kept in a complete report */
+    closeXMLReport();
+
     /* Free memory allocated to test summary */
     if (g_pSummary != NULL)
     {
         free(g_pSummary);
     }
 
-    /* Free the memory allocated to test suite and test cases */
-    if(g_pSuiteHead != NULL)
-    {
-        HASH_ITER(hh, g_pSuiteHead, pSuite, pTemp1)
-        {
-             HASH_ITER(hh,pSuite->sTestCaseList, pTestcase, pTemp2)
-             {
-                 HASH_DEL(pSuite->sTestCaseList, pTestcase);
-                 free(pTestcase);
-             }
-
-             HASH_DEL(g_pSuiteHead, pSuite);
-             free(pSuite);
-        }
-    }
+    /* Release the schedule, the shard plan, the name index and the
+     * registry block
+     */
+    scheduleFree();
+    shardFree();
+    nameIndexFree();
+    free(g_pRegistry);
+    g_pRegistry = NULL;
+    memset(&g_Registry, 0, sizeof(g_Registry));
+
     switch (g_eMode)
     {
         case E_SLAVE:
             if (g_bSocketFlag == true)
             {
                 /* Close the socket */
-                close(g_nSlaveSockfd);
-            }
-
-            if(g_bTimerCreationFlag == true)
-            {
-                /* Delete the timer created for select() */
-                timer_delete(g_timerId);
+                close(g_SlaveLink.nSockfd);
             }
-
-            if(cpid > 0)
-			{
-				/* Kill child process */
-				kill(cpid, SIGKILL);
-				wait(NULL);
-			}
         break;
 
         case E_MASTER:
@@ -1356,46 +2103,25 @@ void freeMemory(bool status)
                 /* Close the socket */
                 close(g_nMasterSockfd);
             }
-
-            if(g_bTimerCreationFlag == true)
-            {
-                /* Delete the timer created for select() */
-                timer_delete(g_timerId);
-            }
-
-            if(cpid > 0)
-			{
-				/* Kill child process */
-				kill(cpid, SIGKILL);
-				wait(NULL);
-			}
-        break;
-
-        case E_STANDALONE:
-            if(g_bTimerCreationFlag == true)
-            {
-                /* Delete the timer created for select() */
-                timer_delete(g_timerId);
-            }
-
-            if(cpid > 0)
-			{
-				/* Kill child process */
-				kill(cpid, SIGKILL);
-				wait(NULL);
-			}
         break;
     }
 
+    /* Kill test execution processes and close their timers */
+    watchdogCloseAll();
+    arenaDestroy();
+    histogramDestroy();
+    clockSyncDestroy();
+    bufferPoolDestroy();
+
     if(g_uObjectHandleCount == 1)
     {
         /* Close dynamically loaded shared object */
         dlclose(g_hObjectHandle);
     }
-    if(g_bDebugLogFlag == true)
-    {
-    	fclose(g_pDebugLogFile);
-    }
+    configFree();
+
+    /* Write the queued log messages and close the debug log file */
+    loggerClose();
     if (g_bConsoleInitialized)
     {
         consoleExit();
@@ -1410,9 +2136,17 @@ void freeMemory(bool status)
 
 int main(int argc, char *argv[])
 {
-    char szConsole[10] = {0};
+    char szConsole[CONFIG_VALUE_LEN] = {0};
+    char szValue[CONFIG_VALUE_LEN] = {0};
     int nTempConsolVar = 0;
 
+    /* Start the log drainer, messages are written synchronously without it */
+    loggerInit();
+
+    /* Parse the configuration files once, values are looked up in the cache */
+    configLoad(TESTFW_CFG, true);
+    configLoad(TEST_CASE_CFG, false);
+
     if (2 > argc){
         fprintf(stderr, "Invalid number of arguments\n");
         printUsage();
@@ -1435,6 +2169,12 @@ int main(int argc, char *argv[])
     {
         g_eMode = E_STANDALONE;
     }
+    /* Coordinator is a master whose slaves run the shards of its cases */
+    else if (0 == strcmp(COORDINATOR, argv[1]))
+    {
+        g_eMode = E_MASTER;
+        g_bCoordinator = true;
+    }
     else
     {
         fprintf(stderr, "Invalid mode, please enter correct mode\n");
@@ -1467,7 +2207,8 @@ int main(int argc, char *argv[])
 
             /* Console Initialization */
             g_bConsoleInitialized = false;
-			getTokenValue(TESTFW_CFG, "CONSOLE_NEEDED", szConsole);
+			getTokenValue(TESTFW_CFG, "CONSOLE_NEEDED", szConsole,
+				sizeof(szConsole));
 			nTempConsolVar = atoi(szConsole);
 			g_bWriteToConsole = (atoi(szConsole)==0)?false:true;
 
@@ -1484,17 +2225,50 @@ int main(int argc, char *argv[])
 			deviceDrvTstFWDebug(LOG_TO_USR, "Console Settings by user is %s\n",
 				(atoi(szConsole) == 0) ? "false" : "true");
 
+			/* Number of requests sent without waiting for master */
+			memset(szValue, 0, sizeof(szValue));
+			getTokenValue(TESTFW_CFG, "PIPELINE_WINDOW", szValue,
+				sizeof(szValue));
+			g_uPipelineWindow = atoi(szValue);
+			if (g_uPipelineWindow == 0)
+			{
+				g_uPipelineWindow = FW_DEFAULT_PIPELINE_WINDOW;
+			}
+			else if (g_uPipelineWindow > FW_MAX_PIPELINE_WINDOW)
+			{
+				g_uPipelineWindow = FW_MAX_PIPELINE_WINDOW;
+			}
+
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tPipeline window %d [%s:%d]\n",
+				g_uPipelineWindow, __FILENAME__, __LINE__);
+
+			/* Id asked from master, 0 to take the lowest free id */
+			memset(szValue, 0, sizeof(szValue));
+			getTokenValue(TESTFW_CFG, "SLAVE_ID", szValue,
+				sizeof(szValue));
+			g_uSlaveId = atoi(szValue);
+			if (g_uSlaveId > FW_MAX_SLAVE_ID)
+			{
+				g_uSlaveId = 0;
+			}
+
+			/* Cases start together on both machines this long after the
+			 * run request, 0 starts them as soon as they are posted
+			 */
+			memset(szValue, 0, sizeof(szValue));
+			getTokenValue(TESTFW_CFG, "START_BARRIER_US", szValue,
+				sizeof(szValue));
+			g_uStartBarrierUs = (atoi(szValue) > 0) ? atoi(szValue) : 0;
+
             deviceDrvTstFWDebug(LOG_TO_USR,
             	"Device mode of operation: Slave\n");
 
             /* Slave Main Thread */
             initializeSlaveDevice();
 
-            if(bGenerateReport == true)
-            {
-            	/* Generate Test Report */
-            	generateXMLReport();
-            }
+            /* Complete Test Report */
+            closeXMLReport();
 
         break;
 
@@ -1517,7 +2291,8 @@ int main(int argc, char *argv[])
 
             /* Console Initialization */
             g_bConsoleInitialized = false;
-			getTokenValue(TESTFW_CFG, "CONSOLE_NEEDED", szConsole);
+			getTokenValue(TESTFW_CFG, "CONSOLE_NEEDED", szConsole,
+				sizeof(szConsole));
 			nTempConsolVar = atoi(szConsole);
 			g_bWriteToConsole = (atoi(szConsole)==0)?false:true;
 
@@ -1534,12 +2309,37 @@ int main(int argc, char *argv[])
 			deviceDrvTstFWDebug(LOG_TO_USR, "Console Settings by user is %s\n",
 				(atoi(szConsole) == 0) ? "false" : "true");
 
+			/* Slave sessions served before exit, 0 to keep serving */
+			memset(szValue, 0, sizeof(szValue));
+			g_uMasterSlaves = 1;
+			if (getTokenValue(TESTFW_CFG, "MASTER_SLAVES", szValue,
+				sizeof(szValue)) == RET_SUCCESS)
+			{
+				g_uMasterSlaves = atoi(szValue);
+			}
+
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tSlave sessions %d [%s:%d]\n",
+				g_uMasterSlaves, __FILENAME__, __LINE__);
+
+			/* Every slave of the coordinator runs one shard */
+			if (g_bCoordinator && (g_uMasterSlaves == 0))
+			{
+				fprintf(stderr,
+					"Coordinator needs the number of shards in MASTER_SLAVES\n");
+				freeMemory(1);
+			}
+
             deviceDrvTstFWDebug(LOG_TO_USR,
-            	"Device mode of operation: Master\n");
+            	"Device mode of operation: %s\n",
+            	g_bCoordinator ? "Coordinator" : "Master");
 
             /* Initialiaze master device */
             initializeMasterDevice();
 
+            /* Complete the report merged by the coordinator */
+            closeXMLReport();
+
         break;
 
         case E_STANDALONE:
@@ -1557,7 +2357,8 @@ int main(int argc, char *argv[])
 
             /* Console Initialization */
             g_bConsoleInitialized = false;
-			getTokenValue(TESTFW_CFG, "CONSOLE_NEEDED", szConsole);
+			getTokenValue(TESTFW_CFG, "CONSOLE_NEEDED", szConsole,
+				sizeof(szConsole));
 			nTempConsolVar = atoi(szConsole);
 			g_bWriteToConsole = (atoi(szConsole)==0)?false:true;
 
@@ -1574,17 +2375,36 @@ int main(int argc, char *argv[])
 			deviceDrvTstFWDebug(LOG_TO_USR, "Console Settings by user is %s\n",
 				(atoi(szConsole) == 0) ? "false" : "true");
 
+			/* Number of test execution processes, 0 for one per CPU */
+			memset(szValue, 0, sizeof(szValue));
+			getTokenValue(TESTFW_CFG, "STANDALONE_WORKERS", szValue,
+				sizeof(szValue));
+			g_uWorkerCount = atoi(szValue);
+			if (g_uWorkerCount == 0)
+			{
+				g_uWorkerCount = sysconf(_SC_NPROCESSORS_ONLN);
+			}
+			if (g_uWorkerCount == 0)
+			{
+				g_uWorkerCount = 1;
+			}
+			else if (g_uWorkerCount > FW_MAX_WORKERS)
+			{
+				g_uWorkerCount = FW_MAX_WORKERS;
+			}
+
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tTest execution processes %d [%s:%d]\n",
+				g_uWorkerCount, __FILENAME__, __LINE__);
+
             deviceDrvTstFWDebug(LOG_TO_USR,
                 "Device mode of operation: Standalone\n");
 
             /* Initialiaze device */
             initializeStandaloneDevice();
 
-            if(bGenerateReport == true)
-            {
-            	/* Generate Test Report */
-            	generateXMLReport();
-            }
+            /* Complete Test Report */
+            closeXMLReport();
 
         break;
     }
@@ -0,0 +1,385 @@
+/**=============================================================================
+  $Workfile: histogram.c $
+
+  File Description: Latency histograms recorded by the test cases. The
+                    histograms are log bucketed with a fixed size, kept in a
+                    shared mapping with one slot per test execution process
+                    and updated without locks.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+
+#include "deviceDrvTestFW.h"
+#include "histogram.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+static sHistogramSlot_t *g_pSlot = MAP_FAILED;  /* Shared slots */
+static size_t g_uHistogramSize;                 /* Size of the mapping */
+static unsigned int g_uNumberOfSlots;
+
+static sHistogramSlot_t *g_pBoundSlot;          /* Slot of this test
+                                                   execution process */
+
+/*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
+
+static unsigned int getBucket(uint64_t uValue);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : getBucket
+    Description     : Function to get the bucket of a value. Values below
+    				  HISTOGRAM_SUB_BUCKETS are their own bucket, above the
+    				  bucket is given by the highest set bit and the
+    				  HISTOGRAM_SUB_BITS bits below it.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uValue			In		Value
+    Returns         : Bucket index
+
+  ============================================================================*/
+
+static unsigned int getBucket(uint64_t uValue)
+{
+	unsigned int uExponent = 0;
+
+	if (uValue < HISTOGRAM_SUB_BUCKETS)
+	{
+		return (unsigned int)uValue;
+	}
+
+	uExponent = 63 - __builtin_clzll(uValue);
+
+	return (uExponent - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS +
+		(unsigned int)(uValue >> (uExponent - HISTOGRAM_SUB_BITS)) -
+		HISTOGRAM_SUB_BUCKETS;
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramBucketValue
+    Description     : Function to get the lowest value recorded in a bucket.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uBucket			In		Bucket index
+    Returns         : Lowest value of the bucket
+
+  ============================================================================*/
+
+uint64_t histogramBucketValue(unsigned int uBucket)
+{
+	unsigned int uGroup = uBucket >> HISTOGRAM_SUB_BITS;
+
+	if (uGroup == 0)
+	{
+		return uBucket;
+	}
+
+	return (uint64_t)(HISTOGRAM_SUB_BUCKETS +
+		(uBucket & (HISTOGRAM_SUB_BUCKETS - 1))) << (uGroup - 1);
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramPercentile
+    Description     : Function to get a percentile of a histogram, as the
+    				  highest value of the bucket holding it (nearest rank),
+    				  limited to the range recorded.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pHistogram		In		Histogram
+                      @dPercentile		In		Percentile, 0 to 100
+    Returns         : Value of the percentile, 0 if nothing was recorded
+
+  ============================================================================*/
+
+uint64_t histogramPercentile(const sTestHistogram_t *pHistogram,
+	double dPercentile)
+{
+	uint64_t uRank = 0, uSeen = 0, uValue = 0;
+	unsigned int uBucket = 0;
+
+	if (pHistogram->uCount == 0)
+	{
+		return 0;
+	}
+
+	uRank = (uint64_t)(dPercentile * pHistogram->uCount / 100);
+	if ((double)uRank < dPercentile * pHistogram->uCount / 100)
+	{
+		uRank++;
+	}
+	if (uRank == 0)
+	{
+		return pHistogram->uMin;
+	}
+
+	for (uBucket = 0; uBucket < HISTOGRAM_BUCKETS; uBucket++)
+	{
+		uSeen += pHistogram->auBucket[uBucket];
+		if (uSeen >= uRank)
+		{
+			break;
+		}
+	}
+
+	uValue = (uBucket + 1 < HISTOGRAM_BUCKETS) ?
+		histogramBucketValue(uBucket + 1) - 1 : UINT64_MAX;
+	if (uValue > pHistogram->uMax)
+	{
+		uValue = pHistogram->uMax;
+	}
+	if (uValue < pHistogram->uMin)
+	{
+		uValue = pHistogram->uMin;
+	}
+
+	return uValue;
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramCreate
+    Description     : Function to map the histogram slots, one per test
+    				  execution process. It has to be called before the test
+    				  execution processes are forked. Pages of a slot are
+    				  only backed once a test case records in it.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlots			In		Number of slots
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int histogramCreate(unsigned int uSlots)
+{
+	histogramDestroy();
+
+	g_uNumberOfSlots = uSlots;
+	g_uHistogramSize = uSlots * sizeof(sHistogramSlot_t);
+
+	g_pSlot = mmap(NULL, g_uHistogramSize, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (g_pSlot == MAP_FAILED)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in mapping histograms\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramDestroy
+    Description     : Function to unmap the histogram slots.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void histogramDestroy(void)
+{
+	if (g_pSlot != MAP_FAILED)
+	{
+		munmap(g_pSlot, g_uHistogramSize);
+		g_pSlot = MAP_FAILED;
+	}
+
+	g_pBoundSlot = NULL;
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramBind
+    Description     : Function called by a test execution process to record
+    				  the histograms of its test cases in a slot.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot of the process
+    Returns         : None
+
+  ============================================================================*/
+
+void histogramBind(unsigned int uSlot)
+{
+	g_pBoundSlot = ((g_pSlot != MAP_FAILED) && (uSlot < g_uNumberOfSlots)) ?
+		&g_pSlot[uSlot] : NULL;
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramBegin
+    Description     : Function called by the test execution process before it
+    				  runs a test case, the histograms of the previous case
+    				  are dropped. A histogram is cleared when it is taken
+    				  again by histogramGet.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void histogramBegin(void)
+{
+	if (g_pBoundSlot != NULL)
+	{
+		__atomic_store_n(&g_pBoundSlot->uSeries, 0, __ATOMIC_RELEASE);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramSlot
+    Description     : Function called by the scheduler to read the histograms
+    				  recorded by the last test case of a test execution
+    				  process.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSlot			In		Slot of the process
+    Returns         : Slot, NULL if there is none
+
+  ============================================================================*/
+
+const sHistogramSlot_t *histogramSlot(unsigned int uSlot)
+{
+	if ((g_pSlot == MAP_FAILED) || (uSlot >= g_uNumberOfSlots))
+	{
+		return NULL;
+	}
+
+	return &g_pSlot[uSlot];
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramGet
+    Description     : Function exported to the test case shared objects to
+    				  get a histogram of the running test case by name. The
+    				  same name gives the same histogram within a test case.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszName			In		Histogram name
+    Returns         : Histogram, NULL if HISTOGRAM_MAX_SERIES are in use or
+    				  the caller is not a test execution process
+
+  ============================================================================*/
+
+sTestHistogram_t *histogramGet(const char *pszName)
+{
+	sTestHistogram_t *pHistogram = NULL;
+	unsigned int i = 0;
+
+	if ((g_pBoundSlot == NULL) || (pszName == NULL))
+	{
+		return NULL;
+	}
+
+	for (i = 0; i < g_pBoundSlot->uSeries; i++)
+	{
+		if (strncmp(g_pBoundSlot->aSeries[i].szName, pszName,
+			sizeof(g_pBoundSlot->aSeries[i].szName)) == 0)
+		{
+			return &g_pBoundSlot->aSeries[i];
+		}
+	}
+
+	if (g_pBoundSlot->uSeries == HISTOGRAM_MAX_SERIES)
+	{
+		return NULL;
+	}
+
+	pHistogram = &g_pBoundSlot->aSeries[g_pBoundSlot->uSeries];
+	memset(pHistogram, 0, sizeof(sTestHistogram_t));
+	strncpy(pHistogram->szName, pszName, sizeof(pHistogram->szName) - 1);
+	pHistogram->uMin = UINT64_MAX;
+
+	/* Scheduler reads the histograms up to uSeries */
+	__atomic_store_n(&g_pBoundSlot->uSeries, g_pBoundSlot->uSeries + 1,
+		__ATOMIC_RELEASE);
+
+	return pHistogram;
+}
+
+
+/**=============================================================================
+
+	Function Name   : histogramRecord
+    Description     : Function exported to the test case shared objects to
+    				  record a value in a histogram. It takes a few relaxed
+    				  atomic operations and never blocks.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pHistogram		In		Histogram from histogramGet
+                      @uValue			In		Value
+    Returns         : None
+
+  ============================================================================*/
+
+void histogramRecord(sTestHistogram_t *pHistogram, uint64_t uValue)
+{
+	uint64_t uSeen = 0;
+
+	if (pHistogram == NULL)
+	{
+		return;
+	}
+
+	__atomic_fetch_add(&pHistogram->auBucket[getBucket(uValue)], 1,
+		__ATOMIC_RELAXED);
+	__atomic_fetch_add(&pHistogram->uSum, uValue, __ATOMIC_RELAXED);
+
+	uSeen = __atomic_load_n(&pHistogram->uMin, __ATOMIC_RELAXED);
+	while ((uValue < uSeen) &&
+		!__atomic_compare_exchange_n(&pHistogram->uMin, &uSeen, uValue, true,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+	}
+
+	uSeen = __atomic_load_n(&pHistogram->uMax, __ATOMIC_RELAXED);
+	while ((uValue > uSeen) &&
+		!__atomic_compare_exchange_n(&pHistogram->uMax, &uSeen, uValue, true,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+	}
+
+	__atomic_fetch_add(&pHistogram->uCount, 1, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,635 @@
+/**=============================================================================
+  $Workfile: irqStat.c $
+
+  File Description: Kernel statistics taken around every test case. The test
+                    execution process reads /proc/interrupts, /proc/softirqs
+                    and /proc/net/dev before and after a case, keeping only
+                    the IRQs, softirqs and interfaces named in test_cfg.xml.
+                    The files are read line by line through a fixed buffer,
+                    nothing is allocated.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "deviceDrvTestFW.h"
+#include "config.h"
+#include "irqStat.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------------ D E F I N E S   S E C T I O N ---------------------*/
+
+/* Longest line kept, a /proc/interrupts line has 11 characters per CPU */
+#define IRQ_STAT_LINE_SIZE      8192
+
+/* Fields of an interface in /proc/net/dev */
+#define NET_DEV_FIELDS          16
+#define NET_DEV_RX_BYTES        0
+#define NET_DEV_RX_PACKETS      1
+#define NET_DEV_RX_DROPS        3
+#define NET_DEV_TX_BYTES        8
+#define NET_DEV_TX_PACKETS      9
+#define NET_DEV_TX_DROPS        11
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+/* Reader of a /proc file, lines are returned in place from the buffer */
+typedef struct line_reader
+{
+    int nFd;
+    size_t uStart;                          /* Next line */
+    size_t uEnd;                            /* End of the data read */
+    bool bEof;
+    bool bSkip;                             /* Dropping a line too long */
+    char acBuffer[IRQ_STAT_LINE_SIZE];
+}sLineReader_t;
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+static const char *g_apszStatKey[E_STAT_KINDS] =
+	{IRQ_STAT_IRQ_KEY, IRQ_STAT_SOFTIRQ_KEY, IRQ_STAT_NET_KEY};
+static const unsigned int g_auMaxNames[E_STAT_KINDS] =
+	{FW_MAX_IRQ_NAMES, FW_MAX_SOFTIRQ_NAMES, FW_MAX_NET_INTERFACES};
+
+/* Names configured, read before the test execution processes are forked */
+static char g_aszName[E_STAT_KINDS][FW_MAX_IRQ_NAMES][FW_STAT_NAME_SIZE];
+static unsigned int g_auNames[E_STAT_KINDS];
+static bool g_bEnabled;
+
+/*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
+
+static int openReader(sLineReader_t *pReader, const char *pszPath);
+static char *readLine(sLineReader_t *pReader);
+static char *splitLabel(char *pszLine, char **ppszRest);
+static bool matchDeviceName(const char *pszRest, const char *pszName);
+static void readIrqTable(const char *pszPath, E_STAT_KIND eKind,
+	uint64_t *pauCount);
+static void readNetDev(sNetStat_t *pNet);
+static void takeSnapshot(sIrqStat_t *pStat);
+static uint64_t getDelta(uint64_t uStart, uint64_t uEnd);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : openReader
+    Description     : Function to open a /proc file for reading line by line.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pReader			Out		Reader
+                      @pszPath			In		File
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+static int openReader(sLineReader_t *pReader, const char *pszPath)
+{
+	pReader->uStart = 0;
+	pReader->uEnd = 0;
+	pReader->bEof = false;
+	pReader->bSkip = false;
+	pReader->nFd = open(pszPath, O_RDONLY | O_CLOEXEC);
+
+	return (pReader->nFd == -1) ? -1 : 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : readLine
+    Description     : Function to get the next line of a file. The lines are
+    				  cut in the buffer and the part of a line not read yet is
+    				  moved to its start before the next read, a line longer
+    				  than the buffer is dropped. The file is closed at its
+    				  end.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pReader			In		Reader
+    Returns         : Line without the newline, NULL at the end of the file
+
+  ============================================================================*/
+
+static char *readLine(sLineReader_t *pReader)
+{
+	char *pszNewline = NULL, *pszLine = NULL;
+	ssize_t nRead = 0;
+
+	for (;;)
+	{
+		pszLine = pReader->acBuffer + pReader->uStart;
+		pszNewline = memchr(pszLine, '\n', pReader->uEnd - pReader->uStart);
+		if (pszNewline != NULL)
+		{
+			*pszNewline = '\0';
+			pReader->uStart = pszNewline + 1 - pReader->acBuffer;
+			if (!pReader->bSkip)
+			{
+				return pszLine;
+			}
+			pReader->bSkip = false;
+			continue;
+		}
+
+		if (pReader->bEof)
+		{
+			if ((pReader->uStart == pReader->uEnd) || pReader->bSkip)
+			{
+				close(pReader->nFd);
+				return NULL;
+			}
+			pReader->acBuffer[pReader->uEnd] = '\0';
+			pReader->uStart = pReader->uEnd;
+			return pszLine;
+		}
+
+		memmove(pReader->acBuffer, pszLine, pReader->uEnd - pReader->uStart);
+		pReader->uEnd -= pReader->uStart;
+		pReader->uStart = 0;
+		if (pReader->uEnd == IRQ_STAT_LINE_SIZE - 1)
+		{
+			pReader->uEnd = 0;
+			pReader->bSkip = true;
+		}
+
+		nRead = read(pReader->nFd, pReader->acBuffer + pReader->uEnd,
+			IRQ_STAT_LINE_SIZE - 1 - pReader->uEnd);
+		if (nRead <= 0)
+		{
+			pReader->bEof = true;
+		}
+		else
+		{
+			pReader->uEnd += nRead;
+		}
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : splitLabel
+    Description     : Function to split a line at the colon ending its label.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszLine			In		Line, cut at the colon
+                      @ppszRest			Out		Text after the colon
+    Returns         : Label without blanks, NULL if the line has no label
+
+  ============================================================================*/
+
+static char *splitLabel(char *pszLine, char **ppszRest)
+{
+	char *pszColon = strchr(pszLine, ':');
+
+	if (pszColon == NULL)
+	{
+		return NULL;
+	}
+
+	*pszColon = '\0';
+	*ppszRest = pszColon + 1;
+
+	return pszLine + strspn(pszLine, " \t");
+}
+
+
+/**=============================================================================
+
+	Function Name   : matchDeviceName
+    Description     : Function to find a device name in the text of a line of
+    				  /proc/interrupts after the counts. A name matches a whole
+    				  token separated by commas or spaces, or a queue of the
+    				  device, e.g. eth1 matches eth1 and eth1-rx-0 but not
+    				  eth10. A number is an IRQ and only matches the label,
+    				  not the chip or hardware IRQ text.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszRest			In		Text after the counts
+                      @pszName			In		Configured name
+    Returns         : true if the line is of the device
+
+  ============================================================================*/
+
+static bool matchDeviceName(const char *pszRest, const char *pszName)
+{
+	size_t uNameLen = strlen(pszName), uLength = 0;
+
+	if ((uNameLen == 0) || (strspn(pszName, "0123456789") == uNameLen))
+	{
+		return false;
+	}
+
+	while (*pszRest != '\0')
+	{
+		pszRest += strspn(pszRest, ", \t\n");
+		uLength = strcspn(pszRest, ", \t\n");
+
+		if ((uLength >= uNameLen) &&
+			(strncmp(pszRest, pszName, uNameLen) == 0) &&
+			((uLength == uNameLen) || (pszRest[uNameLen] == '-')))
+		{
+			return true;
+		}
+
+		pszRest += uLength;
+	}
+
+	return false;
+}
+
+
+/**=============================================================================
+
+	Function Name   : readIrqTable
+    Description     : Function to read /proc/interrupts or /proc/softirqs, a
+    				  table with a column per CPU. The counts of a line are
+    				  summed over the CPUs and added to every name it matches,
+    				  the label or a device name after the counts.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszPath			In		File
+                      @eKind			In		E_STAT_IRQ or E_STAT_SOFTIRQ
+                      @pauCount			Out		Count per name
+    Returns         : None
+
+  ============================================================================*/
+
+static void readIrqTable(const char *pszPath, E_STAT_KIND eKind,
+	uint64_t *pauCount)
+{
+	sLineReader_t Reader;
+	char *pszLine = NULL, *pszLabel = NULL, *pszRest = NULL, *pszEnd = NULL;
+	unsigned int uCpus = 0, uCpu = 0, uName = 0;
+	unsigned long long ullCount = 0;
+	uint64_t uSum = 0;
+
+	memset(pauCount, 0, g_auMaxNames[eKind] * sizeof(uint64_t));
+
+	if (openReader(&Reader, pszPath) == -1)
+	{
+		return;
+	}
+
+	/* Header, one CPUn per column */
+	pszLine = readLine(&Reader);
+	for (pszRest = pszLine; (pszRest != NULL) &&
+		((pszRest = strstr(pszRest, "CPU")) != NULL); pszRest += 3)
+	{
+		uCpus++;
+	}
+
+	while ((pszLine = readLine(&Reader)) != NULL)
+	{
+		pszLabel = splitLabel(pszLine, &pszRest);
+		if (pszLabel == NULL)
+		{
+			continue;
+		}
+
+		for (uCpu = 0, uSum = 0; uCpu < uCpus; uCpu++)
+		{
+			ullCount = strtoull(pszRest, &pszEnd, 10);
+			if (pszEnd == pszRest)
+			{
+				break;
+			}
+			uSum += ullCount;
+			pszRest = pszEnd;
+		}
+
+		for (uName = 0; uName < g_auNames[eKind]; uName++)
+		{
+			if ((strcmp(pszLabel, g_aszName[eKind][uName]) == 0) ||
+				matchDeviceName(pszRest, g_aszName[eKind][uName]))
+			{
+				pauCount[uName] += uSum;
+			}
+		}
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : readNetDev
+    Description     : Function to read the traffic of the interfaces from
+    				  /proc/net/dev.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pNet				Out		Traffic per interface
+    Returns         : None
+
+  ============================================================================*/
+
+static void readNetDev(sNetStat_t *pNet)
+{
+	sLineReader_t Reader;
+	char *pszLine = NULL, *pszLabel = NULL, *pszRest = NULL, *pszEnd = NULL;
+	unsigned long long aullField[NET_DEV_FIELDS];
+	unsigned int uField = 0, uName = 0;
+
+	memset(pNet, 0, FW_MAX_NET_INTERFACES * sizeof(sNetStat_t));
+
+	if (openReader(&Reader, "/proc/net/dev") == -1)
+	{
+		return;
+	}
+
+	while ((pszLine = readLine(&Reader)) != NULL)
+	{
+		pszLabel = splitLabel(pszLine, &pszRest);
+		if (pszLabel == NULL)
+		{
+			continue;
+		}
+
+		for (uName = 0; uName < g_auNames[E_STAT_NET]; uName++)
+		{
+			if (strcmp(pszLabel, g_aszName[E_STAT_NET][uName]) == 0)
+			{
+				break;
+			}
+		}
+		if (uName == g_auNames[E_STAT_NET])
+		{
+			continue;
+		}
+
+		memset(aullField, 0, sizeof(aullField));
+		for (uField = 0; uField < NET_DEV_FIELDS; uField++)
+		{
+			aullField[uField] = strtoull(pszRest, &pszEnd, 10);
+			if (pszEnd == pszRest)
+			{
+				break;
+			}
+			pszRest = pszEnd;
+		}
+
+		pNet[uName].uRxBytes = aullField[NET_DEV_RX_BYTES];
+		pNet[uName].uRxPackets = aullField[NET_DEV_RX_PACKETS];
+		pNet[uName].uRxDrops = aullField[NET_DEV_RX_DROPS];
+		pNet[uName].uTxBytes = aullField[NET_DEV_TX_BYTES];
+		pNet[uName].uTxPackets = aullField[NET_DEV_TX_PACKETS];
+		pNet[uName].uTxDrops = aullField[NET_DEV_TX_DROPS];
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : takeSnapshot
+    Description     : Function to read the totals of the names configured,
+    				  files without a name configured are not read.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pStat			Out		Totals
+    Returns         : None
+
+  ============================================================================*/
+
+static void takeSnapshot(sIrqStat_t *pStat)
+{
+	if (g_auNames[E_STAT_IRQ] > 0)
+	{
+		readIrqTable("/proc/interrupts", E_STAT_IRQ, pStat->auIrq);
+	}
+
+	if (g_auNames[E_STAT_SOFTIRQ] > 0)
+	{
+		readIrqTable("/proc/softirqs", E_STAT_SOFTIRQ, pStat->auSoftIrq);
+	}
+
+	if (g_auNames[E_STAT_NET] > 0)
+	{
+		readNetDev(pStat->aNet);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : getDelta
+    Description     : Function to get the increase of a counter, a counter
+    				  which went back, as when an interface was reset, gives 0.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uStart			In		Value at the start
+                      @uEnd				In		Value at the end
+    Returns         : Increase
+
+  ============================================================================*/
+
+static uint64_t getDelta(uint64_t uStart, uint64_t uEnd)
+{
+	return (uEnd > uStart) ? uEnd - uStart : 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : irqStatLoad
+    Description     : Function to read the names of the IRQs, softirqs and
+    				  interfaces from the configuration. It has to be called
+    				  before the test execution processes are forked, with no
+    				  name configured nothing is read around the cases.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void irqStatLoad(void)
+{
+	const char *pszList = NULL;
+	size_t uLength = 0;
+	unsigned int uKind = 0;
+
+	for (uKind = 0; uKind < E_STAT_KINDS; uKind++)
+	{
+		g_auNames[uKind] = 0;
+		pszList = configLookup(g_apszStatKey[uKind]);
+
+		while ((pszList != NULL) && (*pszList != '\0'))
+		{
+			pszList += strspn(pszList, ", \t");
+			uLength = strcspn(pszList, ", \t");
+			if (uLength == 0)
+			{
+				break;
+			}
+
+			if (g_auNames[uKind] == g_auMaxNames[uKind])
+			{
+				deviceDrvTstFWDebug(LOG_TO_USR,
+					"%s has more than %u names, %.*s ignored\n",
+					g_apszStatKey[uKind], g_auMaxNames[uKind],
+					(int)uLength, pszList);
+			}
+			else
+			{
+				if (uLength >= FW_STAT_NAME_SIZE)
+				{
+					uLength = FW_STAT_NAME_SIZE - 1;
+				}
+				memcpy(g_aszName[uKind][g_auNames[uKind]], pszList, uLength);
+				g_aszName[uKind][g_auNames[uKind]][uLength] = '\0';
+				g_auNames[uKind]++;
+			}
+
+			pszList += strcspn(pszList, ", \t");
+		}
+	}
+
+	g_bEnabled = (g_auNames[E_STAT_IRQ] + g_auNames[E_STAT_SOFTIRQ] +
+		g_auNames[E_STAT_NET]) > 0;
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tKernel statistics of %u IRQs, %u softirqs, %u interfaces "
+		"[%s:%d]\n", g_auNames[E_STAT_IRQ], g_auNames[E_STAT_SOFTIRQ],
+		g_auNames[E_STAT_NET], __FILENAME__, __LINE__);
+}
+
+
+/**=============================================================================
+
+	Function Name   : irqStatCount
+    Description     : Function to get the number of names configured.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @eKind			In		Kind of statistics
+    Returns         : Number of names
+
+  ============================================================================*/
+
+unsigned int irqStatCount(E_STAT_KIND eKind)
+{
+	return g_auNames[eKind];
+}
+
+
+/**=============================================================================
+
+	Function Name   : irqStatName
+    Description     : Function to get a name configured.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @eKind			In		Kind of statistics
+                      @uName			In		Position in the list
+    Returns         : Name
+
+  ============================================================================*/
+
+const char *irqStatName(E_STAT_KIND eKind, unsigned int uName)
+{
+	return g_aszName[eKind][uName];
+}
+
+
+/**=============================================================================
+
+	Function Name   : irqStatBegin
+    Description     : Function called by the test execution process when a
+    				  case starts, to take the totals at its start.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pStat			Out		Statistics of the case
+    Returns         : None
+
+  ============================================================================*/
+
+void irqStatBegin(sIrqStat_t *pStat)
+{
+	pStat->uState = E_USAGE_NONE;
+	if (!g_bEnabled)
+	{
+		return;
+	}
+
+	takeSnapshot(pStat);
+	pStat->uState = E_USAGE_STARTED;
+}
+
+
+/**=============================================================================
+
+	Function Name   : irqStatEnd
+    Description     : Function to turn the totals taken at the start of a
+    				  case into the increase since. It is called by the test
+    				  execution process when the case ends, and by the
+    				  scheduler when the process died in the middle of it.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pStat			In/Out	Statistics of the case
+    Returns         : None
+
+  ============================================================================*/
+
+void irqStatEnd(sIrqStat_t *pStat)
+{
+	sIrqStat_t Now;
+	unsigned int i = 0;
+
+	if (pStat->uState != E_USAGE_STARTED)
+	{
+		return;
+	}
+
+	takeSnapshot(&Now);
+
+	for (i = 0; i < g_auNames[E_STAT_IRQ]; i++)
+	{
+		pStat->auIrq[i] = getDelta(pStat->auIrq[i], Now.auIrq[i]);
+	}
+
+	for (i = 0; i < g_auNames[E_STAT_SOFTIRQ]; i++)
+	{
+		pStat->auSoftIrq[i] = getDelta(pStat->auSoftIrq[i],
+			Now.auSoftIrq[i]);
+	}
+
+	for (i = 0; i < g_auNames[E_STAT_NET]; i++)
+	{
+		pStat->aNet[i].uRxBytes = getDelta(pStat->aNet[i].uRxBytes,
+			Now.aNet[i].uRxBytes);
+		pStat->aNet[i].uRxPackets = getDelta(pStat->aNet[i].uRxPackets,
+			Now.aNet[i].uRxPackets);
+		pStat->aNet[i].uRxDrops = getDelta(pStat->aNet[i].uRxDrops,
+			Now.aNet[i].uRxDrops);
+		pStat->aNet[i].uTxBytes = getDelta(pStat->aNet[i].uTxBytes,
+			Now.aNet[i].uTxBytes);
+		pStat->aNet[i].uTxPackets = getDelta(pStat->aNet[i].uTxPackets,
+			Now.aNet[i].uTxPackets);
+		pStat->aNet[i].uTxDrops = getDelta(pStat->aNet[i].uTxDrops,
+			Now.aNet[i].uTxDrops);
+	}
+
+	pStat->uState = E_USAGE_DONE;
+}
@@ -0,0 +1,1140 @@
+/**=============================================================================
+  $Workfile: logger.c$
+
+  File Description: Asynchronous debug logger. Every thread logs into its own
+                    single producer ring: the call stores the format string,
+                    which identifies the call site, a raw CLOCK_MONOTONIC
+                    timestamp and the arguments. Formatting the time and the
+                    message and writing the output is done by a drainer
+                    thread, off the state machine loops. Forked children and
+                    calls made before loggerInit write synchronously.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
+#include "deviceDrvTestFW.h"
+#include "logger.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/* Output of a message */
+#define SINK_STDERR     0
+#define SINK_DEBUG_FILE 1
+#define SINK_COUNT      2
+
+/* Argument classes, decided from the conversion specification */
+#define ARG_NONE        0
+#define ARG_INT         1
+#define ARG_UINT        2
+#define ARG_DOUBLE      3
+#define ARG_STRING      4
+#define ARG_POINTER     5
+#define ARG_CHAR        6
+#define ARG_UNKNOWN     7
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+/* Conversion specification parsed from the format string */
+typedef struct log_spec
+{
+    const char *pszStart;                   /* '%' of the specification */
+    const char *pszEnd;                     /* Past the conversion char */
+    char szLength[3];                       /* Length modifier */
+    bool bStarWidth;                        /* Width passed as argument */
+    bool bStarPrecision;                    /* Precision passed as argument */
+    int nClass;                             /* ARG_xxx */
+}sLogSpec_t;
+
+/* Queued message. Integers, doubles and pointers are kept in aArgs, strings
+ * are copied into szText and aArgs holds their offset. A message which can
+ * not be captured is formatted by the caller into szText, pszFormat is NULL.
+ */
+typedef struct log_entry
+{
+    const char *pszFormat;                  /* Format string of the call */
+    uint64_t uTimestampNs;                  /* CLOCK_MONOTONIC of the call */
+    uint8_t uSink;                          /* SINK_xxx */
+    uint8_t uArgCount;                      /* Used entries of aArgs */
+    uint16_t uTextLen;                      /* Used bytes of szText */
+    uint64_t aArgs[LOGGER_MAX_ARGS];        /* Raw argument values */
+    char szText[LOGGER_ENTRY_LEN - 24 - 8 * LOGGER_MAX_ARGS];
+}sLogEntry_t;
+
+/* Single producer single consumer ring of a thread. Head is advanced by the
+ * owning thread, tail by the drainer, each on its own cache line.
+ */
+typedef struct log_ring
+{
+    uint32_t uHead __attribute__((aligned(64)));
+    uint32_t uTail __attribute__((aligned(64)));
+    struct log_ring *pNext;                 /* Next ring of the process */
+    sLogEntry_t Entries[LOGGER_RING_ENTRIES];
+}sLogRing_t;
+
+/* Formatted output waiting to be written */
+typedef struct log_output
+{
+    int nFd;                                /* Destination, -1 until opened */
+    unsigned int uLength;                   /* Buffered bytes */
+    char szBuffer[LOGGER_OUTPUT_LEN];
+}sLogOutput_t;
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+bool g_bDebugLogFlag;                       /* Debug log file in use */
+
+extern E_MODE_TYPE g_eMode;                 /* Names the debug log file */
+
+static sLogRing_t *g_pRingHead;             /* Rings of all the threads */
+static __thread sLogRing_t *t_pRing;        /* Ring of the calling thread */
+
+static pthread_t g_DrainerThread;           /* Formats and writes messages */
+static bool g_bDrainerRunning;              /* Messages queued when set */
+static bool g_bDrainerStop;                 /* Asks the drainer to exit */
+static bool g_bDrainerIdle;                 /* Drainer waits on g_nWakeFd */
+static int g_nWakeFd = -1;                  /* Wakes the idle drainer */
+static unsigned int g_uFlushRequest;        /* Incremented by loggerFlush */
+static unsigned int g_uFlushDone;           /* Last request written out */
+
+static sLogOutput_t g_Output[SINK_COUNT] =  /* Drainer output buffers */
+{
+	{ STDERR_FILENO, 0 },
+	{ -1, 0 }
+};
+
+static uint64_t g_uMonotonicBaseNs;         /* Clocks sampled at loggerInit */
+static time_t g_RealtimeBase;
+static uint64_t g_uRealtimeBaseNs;
+
+static time_t g_CachedSecond = -1;          /* Second of szCachedTime */
+static char g_szCachedTime[20];             /* Timestamp prefix of the file */
+
+/*------------------- F U N C T I O N   D E C L A R A T I O N S ---------------*/
+
+static void *loggerDrainerThread(void *pArg);
+static void loggerForkPrepare(void);
+static void loggerForkChild(void);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : loggerNow
+    Description     : Function to read the raw timestamp of a message.
+    Arguments       : None
+    Returns         : CLOCK_MONOTONIC time in nanoseconds
+
+  ============================================================================*/
+
+static inline uint64_t loggerNow(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (uint64_t)Now.tv_sec * 1000000000ULL + Now.tv_nsec;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerParseSpec
+    Description     : Function to parse the conversion specification starting
+    				  at a '%' of the format string.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszFormat		In		'%' of the specification
+                      @pSpec			Out		Parsed specification
+    Returns         : None
+
+  ============================================================================*/
+
+static void loggerParseSpec(const char *pszFormat, sLogSpec_t *pSpec)
+{
+	const char *p = pszFormat + 1;
+	int nLength = 0;
+
+	memset(pSpec, 0, sizeof(sLogSpec_t));
+	pSpec->pszStart = pszFormat;
+
+	while (*p && strchr("-+ #0'", *p))
+	{
+		p++;
+	}
+
+	if (*p == '*')
+	{
+		pSpec->bStarWidth = true;
+		p++;
+	}
+	while (*p >= '0' && *p <= '9')
+	{
+		p++;
+	}
+
+	if (*p == '.')
+	{
+		p++;
+		if (*p == '*')
+		{
+			pSpec->bStarPrecision = true;
+			p++;
+		}
+		while (*p >= '0' && *p <= '9')
+		{
+			p++;
+		}
+	}
+
+	while (*p && strchr("hlLqjzt", *p) && nLength < 2)
+	{
+		pSpec->szLength[nLength++] = *p++;
+	}
+
+	switch (*p)
+	{
+		case 'd': case 'i':
+			pSpec->nClass = ARG_INT;
+		break;
+
+		case 'u': case 'o': case 'x': case 'X':
+			pSpec->nClass = ARG_UINT;
+		break;
+
+		case 'f': case 'F': case 'e': case 'E':
+		case 'g': case 'G': case 'a': case 'A':
+			pSpec->nClass = ARG_DOUBLE;
+		break;
+
+		case 'c':
+			pSpec->nClass = (nLength == 0) ? ARG_CHAR : ARG_UNKNOWN;
+		break;
+
+		case 's':
+			pSpec->nClass = (nLength == 0) ? ARG_STRING : ARG_UNKNOWN;
+		break;
+
+		case 'p':
+			pSpec->nClass = ARG_POINTER;
+		break;
+
+		case '%':
+			pSpec->nClass = ARG_NONE;
+		break;
+
+		default:
+			pSpec->nClass = ARG_UNKNOWN;
+		break;
+	}
+
+	pSpec->pszEnd = (*p) ? p + 1 : p;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerCapture
+    Description     : Function to copy the arguments of a message into a ring
+    				  entry. Only the argument values are read, formatting is
+    				  left to the drainer.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pEntry			Out		Ring entry
+                      @pszMsg			In		Format string
+                      @Args				In		Arguments of the message
+    Returns         : true ON SUCCESS, false if the message has to be
+    				  formatted by the caller
+
+  ============================================================================*/
+
+static bool loggerCapture(sLogEntry_t *pEntry, const char *pszMsg,
+    va_list Args)
+{
+	sLogSpec_t Spec;
+	const char *p = pszMsg, *pszString = NULL;
+	unsigned int uArg = 0;
+	size_t uLen = 0;
+	uint64_t uValue = 0;
+	double dValue = 0;
+
+	pEntry->uTextLen = 0;
+
+	while ((p = strchr(p, '%')) != NULL)
+	{
+		loggerParseSpec(p, &Spec);
+		p = Spec.pszEnd;
+
+		if (Spec.nClass == ARG_NONE)
+		{
+			continue;
+		}
+		if (Spec.nClass == ARG_UNKNOWN ||
+			uArg + Spec.bStarWidth + Spec.bStarPrecision + 1 > LOGGER_MAX_ARGS)
+		{
+			return false;
+		}
+
+		if (Spec.bStarWidth)
+		{
+			pEntry->aArgs[uArg++] = (uint64_t)(int64_t)va_arg(Args, int);
+		}
+		if (Spec.bStarPrecision)
+		{
+			pEntry->aArgs[uArg++] = (uint64_t)(int64_t)va_arg(Args, int);
+		}
+
+		switch (Spec.nClass)
+		{
+			case ARG_INT:
+				if (!strcmp(Spec.szLength, "l"))
+					uValue = (int64_t)va_arg(Args, long);
+				else if (!strcmp(Spec.szLength, "ll") ||
+					!strcmp(Spec.szLength, "q"))
+					uValue = (int64_t)va_arg(Args, long long);
+				else if (!strcmp(Spec.szLength, "z"))
+					uValue = (int64_t)va_arg(Args, ssize_t);
+				else if (!strcmp(Spec.szLength, "j"))
+					uValue = (int64_t)va_arg(Args, intmax_t);
+				else if (!strcmp(Spec.szLength, "t"))
+					uValue = (int64_t)va_arg(Args, ptrdiff_t);
+				else if (!strcmp(Spec.szLength, "hh"))
+					uValue = (int64_t)(signed char)va_arg(Args, int);
+				else if (!strcmp(Spec.szLength, "h"))
+					uValue = (int64_t)(short)va_arg(Args, int);
+				else
+					uValue = (int64_t)va_arg(Args, int);
+				pEntry->aArgs[uArg++] = uValue;
+			break;
+
+			case ARG_UINT:
+				if (!strcmp(Spec.szLength, "l"))
+					uValue = va_arg(Args, unsigned long);
+				else if (!strcmp(Spec.szLength, "ll") ||
+					!strcmp(Spec.szLength, "q"))
+					uValue = va_arg(Args, unsigned long long);
+				else if (!strcmp(Spec.szLength, "z"))
+					uValue = va_arg(Args, size_t);
+				else if (!strcmp(Spec.szLength, "j"))
+					uValue = va_arg(Args, uintmax_t);
+				else if (!strcmp(Spec.szLength, "t"))
+					uValue = (uint64_t)va_arg(Args, ptrdiff_t);
+				else if (!strcmp(Spec.szLength, "hh"))
+					uValue = (unsigned char)va_arg(Args, unsigned int);
+				else if (!strcmp(Spec.szLength, "h"))
+					uValue = (unsigned short)va_arg(Args, unsigned int);
+				else
+					uValue = va_arg(Args, unsigned int);
+				pEntry->aArgs[uArg++] = uValue;
+			break;
+
+			case ARG_DOUBLE:
+				if (!strcmp(Spec.szLength, "L"))
+					dValue = (double)va_arg(Args, long double);
+				else
+					dValue = va_arg(Args, double);
+				memcpy(&pEntry->aArgs[uArg++], &dValue, sizeof(double));
+			break;
+
+			case ARG_CHAR:
+				pEntry->aArgs[uArg++] = (uint64_t)(int64_t)va_arg(Args, int);
+			break;
+
+			case ARG_POINTER:
+				pEntry->aArgs[uArg++] = (uintptr_t)va_arg(Args, void *);
+			break;
+
+			case ARG_STRING:
+				pszString = va_arg(Args, const char *);
+				if (pszString == NULL)
+				{
+					pszString = "(null)";
+				}
+
+				/* Strings longer than the entry are truncated, with no
+				 * room left the caller formats the whole message
+				 */
+				if (pEntry->uTextLen >= sizeof(pEntry->szText))
+				{
+					return false;
+				}
+				uLen = strlen(pszString);
+				if (uLen > sizeof(pEntry->szText) - pEntry->uTextLen - 1)
+				{
+					uLen = sizeof(pEntry->szText) - pEntry->uTextLen - 1;
+				}
+				memcpy(pEntry->szText + pEntry->uTextLen, pszString, uLen);
+				pEntry->szText[pEntry->uTextLen + uLen] = '\0';
+
+				pEntry->aArgs[uArg++] = pEntry->uTextLen;
+				pEntry->uTextLen += uLen + 1;
+			break;
+		}
+	}
+
+	pEntry->uArgCount = uArg;
+	pEntry->pszFormat = pszMsg;
+
+	return true;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerFormat
+    Description     : Function to format a captured message.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pEntry			In		Ring entry
+                      @pszOut			Out		Formatted message
+                      @uSize			In		Size of pszOut
+    Returns         : Length of the formatted message
+
+  ============================================================================*/
+
+static unsigned int loggerFormat(const sLogEntry_t *pEntry, char *pszOut,
+    unsigned int uSize)
+{
+	sLogSpec_t Spec;
+	const char *p = NULL, *pszPercent = NULL;
+	char szSpec[32], szLength[4];
+	unsigned int uLen = 0, uArg = 0;
+	size_t uSpecLen = 0, uPrefix = 0;
+	int nWidth = 0, nPrecision = 0, n = 0;
+	double dValue = 0;
+
+	if (pEntry->pszFormat == NULL)
+	{
+		uLen = snprintf(pszOut, uSize, "%s", pEntry->szText);
+		return (uLen < uSize) ? uLen : uSize - 1;
+	}
+
+	for (p = pEntry->pszFormat; *p && uLen < uSize - 1; p = Spec.pszEnd)
+	{
+		/* Copy the literal text up to the next specification */
+		pszPercent = strchr(p, '%');
+		if (pszPercent == NULL)
+		{
+			pszPercent = p + strlen(p);
+		}
+		while (p < pszPercent && uLen < uSize - 1)
+		{
+			pszOut[uLen++] = *p++;
+		}
+		if (*p == '\0' || uLen >= uSize - 1)
+		{
+			break;
+		}
+
+		loggerParseSpec(p, &Spec);
+		if (Spec.nClass == ARG_NONE)
+		{
+			pszOut[uLen++] = '%';
+			continue;
+		}
+
+		nWidth = Spec.bStarWidth ? (int)pEntry->aArgs[uArg++] : 0;
+		nPrecision = Spec.bStarPrecision ? (int)pEntry->aArgs[uArg++] : 0;
+
+		/* Specification without the length modifier, integers are printed
+		 * from the 64 bit value they were widened to.
+		 */
+		uSpecLen = Spec.pszEnd - Spec.pszStart;
+		uPrefix = uSpecLen - 1 - strlen(Spec.szLength);
+		if (uSpecLen >= sizeof(szSpec) - 2)
+		{
+			break;
+		}
+		strcpy(szLength, (Spec.nClass == ARG_INT || Spec.nClass == ARG_UINT) ?
+			"ll" : "");
+		memcpy(szSpec, Spec.pszStart, uPrefix);
+		szSpec[uPrefix] = '\0';
+		strcat(szSpec, szLength);
+		strncat(szSpec, Spec.pszEnd - 1, 1);
+
+#define LOGGER_PRINT(Value) \
+		(Spec.bStarWidth && Spec.bStarPrecision) ? \
+			snprintf(pszOut + uLen, uSize - uLen, szSpec, nWidth, nPrecision, \
+				Value) : \
+		(Spec.bStarWidth) ? \
+			snprintf(pszOut + uLen, uSize - uLen, szSpec, nWidth, Value) : \
+		(Spec.bStarPrecision) ? \
+			snprintf(pszOut + uLen, uSize - uLen, szSpec, nPrecision, Value) : \
+			snprintf(pszOut + uLen, uSize - uLen, szSpec, Value)
+
+		switch (Spec.nClass)
+		{
+			case ARG_INT:
+				n = LOGGER_PRINT((long long)pEntry->aArgs[uArg]);
+			break;
+
+			case ARG_UINT:
+				n = LOGGER_PRINT((unsigned long long)pEntry->aArgs[uArg]);
+			break;
+
+			case ARG_DOUBLE:
+				memcpy(&dValue, &pEntry->aArgs[uArg], sizeof(double));
+				n = LOGGER_PRINT(dValue);
+			break;
+
+			case ARG_CHAR:
+				n = LOGGER_PRINT((int)pEntry->aArgs[uArg]);
+			break;
+
+			case ARG_POINTER:
+				n = LOGGER_PRINT((void *)(uintptr_t)pEntry->aArgs[uArg]);
+			break;
+
+			case ARG_STRING:
+				n = LOGGER_PRINT(pEntry->szText + pEntry->aArgs[uArg]);
+			break;
+
+			default:
+				n = 0;
+			break;
+		}
+#undef LOGGER_PRINT
+
+		uArg++;
+		if (n > 0)
+		{
+			uLen += ((unsigned int)n < uSize - uLen) ? (unsigned int)n :
+				uSize - uLen - 1;
+		}
+	}
+
+	pszOut[uLen] = '\0';
+
+	return uLen;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerOpenFile
+    Description     : Function to open the debug log file of the mode.
+    Arguments       : None
+    Returns         : File descriptor, -1 ON FAILURE
+
+  ============================================================================*/
+
+static int loggerOpenFile(void)
+{
+	char szDbgFileName[30] = "debug_fw_";
+
+	if (g_eMode == E_SLAVE)
+		strcat(szDbgFileName, SLAVE);
+	else if (g_eMode == E_MASTER)
+		strcat(szDbgFileName, MASTER);
+	else if (g_eMode == E_STANDALONE)
+		strcat(szDbgFileName, STANDALONE);
+
+	strcat(szDbgFileName, ".txt");
+
+	return open(szDbgFileName, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+		0644);
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerWriteOut
+    Description     : Function to write a buffer completely to a file
+    				  descriptor.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd				In		File descriptor
+                      @pBuffer			In		Data to write
+                      @uLength			In		Length of the data
+    Returns         : None
+
+  ============================================================================*/
+
+static void loggerWriteOut(int nFd, const char *pBuffer, size_t uLength)
+{
+	ssize_t nWritten = 0;
+
+	while (uLength > 0)
+	{
+		nWritten = write(nFd, pBuffer, uLength);
+		if (nWritten < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (nWritten <= 0)
+		{
+			return;
+		}
+		pBuffer += nWritten;
+		uLength -= nWritten;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerRender
+    Description     : Function to format a message for its sink. Messages of
+    				  the debug log file are prefixed with the wall clock time
+    				  of the call.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pEntry			In		Ring entry
+                      @pszLog			Out		Formatted message
+                      @uSize			In		Size of pszLog
+    Returns         : Length of the formatted message
+
+  ============================================================================*/
+
+static unsigned int loggerRender(const sLogEntry_t *pEntry, char *pszLog,
+    unsigned int uSize)
+{
+	unsigned int uLen = 0;
+	uint64_t uWallNs = 0;
+	time_t Second;
+	struct tm TimeInfo;
+
+	if (pEntry->uSink == SINK_DEBUG_FILE)
+	{
+		/* Wall clock of the call from the monotonic timestamp */
+		uWallNs = g_uRealtimeBaseNs + (pEntry->uTimestampNs -
+			g_uMonotonicBaseNs);
+		Second = g_RealtimeBase + (time_t)(uWallNs / 1000000000ULL);
+		if (Second != g_CachedSecond)
+		{
+			localtime_r(&Second, &TimeInfo);
+			strftime(g_szCachedTime, sizeof(g_szCachedTime),
+				"%m/%d/%Y_%H:%M:%S", &TimeInfo);
+			g_CachedSecond = Second;
+		}
+		uLen = snprintf(pszLog, uSize, "%s", g_szCachedTime);
+	}
+
+	return uLen + loggerFormat(pEntry, pszLog + uLen, uSize - uLen);
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerSinkFd
+    Description     : Function to get the file descriptor of a sink, the
+    				  debug log file is opened on its first message.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uSink			In		SINK_xxx
+    Returns         : File descriptor, -1 ON FAILURE
+
+  ============================================================================*/
+
+static int loggerSinkFd(uint8_t uSink)
+{
+	if (g_Output[uSink].nFd == -1 && uSink == SINK_DEBUG_FILE)
+	{
+		g_Output[uSink].nFd = loggerOpenFile();
+	}
+
+	return g_Output[uSink].nFd;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerEmit
+    Description     : Function to format a drained message into the output
+    				  buffer of its sink.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pEntry			In		Ring entry
+    Returns         : None
+
+  ============================================================================*/
+
+static void loggerEmit(const sLogEntry_t *pEntry)
+{
+	sLogOutput_t *pOutput = &g_Output[pEntry->uSink];
+	char szLog[LOGGER_ENTRY_LEN * 2];
+	unsigned int uLen = 0;
+
+	if (loggerSinkFd(pEntry->uSink) == -1)
+	{
+		return;
+	}
+
+	uLen = loggerRender(pEntry, szLog, sizeof(szLog));
+
+	if (pOutput->uLength + uLen > sizeof(pOutput->szBuffer))
+	{
+		loggerWriteOut(pOutput->nFd, pOutput->szBuffer, pOutput->uLength);
+		pOutput->uLength = 0;
+	}
+	memcpy(pOutput->szBuffer + pOutput->uLength, szLog, uLen);
+	pOutput->uLength += uLen;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerRing
+    Description     : Function to get the ring of the calling thread, the ring
+    				  is created and linked on the first message of a thread.
+    Arguments       : None
+    Returns         : Ring, NULL ON FAILURE
+
+  ============================================================================*/
+
+static sLogRing_t *loggerRing(void)
+{
+	sLogRing_t *pRing = t_pRing;
+
+	if (pRing != NULL)
+	{
+		return pRing;
+	}
+
+	if (posix_memalign((void **)&pRing, 64, sizeof(sLogRing_t)) != 0)
+	{
+		return NULL;
+	}
+	memset(pRing, 0, offsetof(sLogRing_t, Entries));
+
+	pRing->pNext = __atomic_load_n(&g_pRingHead, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&g_pRingHead, &pRing->pNext, pRing,
+		false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+	{
+	}
+
+	t_pRing = pRing;
+
+	return pRing;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerWake
+    Description     : Function to wake the drainer if it is waiting for
+    				  messages.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+static void loggerWake(void)
+{
+	uint64_t uOne = 1;
+
+	if (__atomic_load_n(&g_bDrainerIdle, __ATOMIC_SEQ_CST) &&
+		__atomic_exchange_n(&g_bDrainerIdle, false, __ATOMIC_SEQ_CST))
+	{
+		if (write(g_nWakeFd, &uOne, sizeof(uOne)) < 0)
+		{
+			/* Drainer notices the message on its next pass */
+		}
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerWrite
+    Description     : Function to log a message. User messages on the console
+    				  UI are written directly, the other messages are queued
+    				  for the drainer, or written directly when it is not
+    				  running.
+    Arguments       :
+                      Name              Dir         Description
+                      @nType            In          Log type
+                      @pszMsg			In			Message to be logged
+                      @variable argument list
+    Returns         : None
+
+  ============================================================================*/
+
+void loggerWrite(int nType, const char *pszMsg, ...)
+{
+	sLogEntry_t LocalEntry, *pEntry = NULL;
+	sLogRing_t *pRing = NULL;
+	char szLog[LOGGER_ENTRY_LEN * 2];
+	unsigned int uLen = 0;
+	uint32_t uHead = 0;
+	int nFd = -1;
+	uint8_t uSink = SINK_STDERR;
+	va_list Args;
+
+	va_start(Args, pszMsg);
+
+	if (g_bConsoleInitialized)
+	{
+		if (nType == LOG_TO_USR)
+		{
+			writeDbgMessage((char *)pszMsg, Args);
+			va_end(Args);
+			return;
+		}
+
+		uSink = SINK_DEBUG_FILE;
+		g_bDebugLogFlag = true;
+	}
+
+	pRing = __atomic_load_n(&g_bDrainerRunning, __ATOMIC_ACQUIRE) ?
+		loggerRing() : NULL;
+
+	if (pRing != NULL)
+	{
+		/* Wait for the drainer if the ring is full */
+		uHead = pRing->uHead;
+		while (uHead - __atomic_load_n(&pRing->uTail, __ATOMIC_ACQUIRE) >=
+			LOGGER_RING_ENTRIES)
+		{
+			loggerWake();
+			sched_yield();
+		}
+		pEntry = &pRing->Entries[uHead & (LOGGER_RING_ENTRIES - 1)];
+	}
+	else
+	{
+		pEntry = &LocalEntry;
+	}
+
+	pEntry->uTimestampNs = loggerNow();
+	pEntry->uSink = uSink;
+	if (!loggerCapture(pEntry, pszMsg, Args))
+	{
+		va_end(Args);
+		va_start(Args, pszMsg);
+		vsnprintf(pEntry->szText, sizeof(pEntry->szText), pszMsg, Args);
+		pEntry->pszFormat = NULL;
+		pEntry->uArgCount = 0;
+	}
+	va_end(Args);
+
+	if (pRing != NULL)
+	{
+		__atomic_store_n(&pRing->uHead, uHead + 1, __ATOMIC_SEQ_CST);
+		loggerWake();
+	}
+	else
+	{
+		/* Synchronous, before loggerInit or in a forked child */
+		nFd = loggerSinkFd(uSink);
+		if (nFd != -1)
+		{
+			uLen = loggerRender(pEntry, szLog, sizeof(szLog));
+			loggerWriteOut(nFd, szLog, uLen);
+		}
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerDrain
+    Description     : Function to move the queued messages of all the rings
+    				  into the output buffers, oldest first.
+    Arguments       : None
+    Returns         : Number of messages drained
+
+  ============================================================================*/
+
+static unsigned int loggerDrain(void)
+{
+	sLogRing_t *pRing = NULL, *pOldest = NULL;
+	sLogEntry_t *pEntry = NULL, *pOldestEntry = NULL;
+	uint32_t uTail = 0;
+	unsigned int uCount = 0;
+
+	for (;;)
+	{
+		/* Rings are merged on the timestamp of their next message */
+		pOldest = NULL;
+		for (pRing = __atomic_load_n(&g_pRingHead, __ATOMIC_ACQUIRE);
+			pRing != NULL; pRing = pRing->pNext)
+		{
+			uTail = pRing->uTail;
+			if (__atomic_load_n(&pRing->uHead, __ATOMIC_ACQUIRE) == uTail)
+			{
+				continue;
+			}
+			pEntry = &pRing->Entries[uTail & (LOGGER_RING_ENTRIES - 1)];
+			if (pOldest == NULL ||
+				pEntry->uTimestampNs < pOldestEntry->uTimestampNs)
+			{
+				pOldest = pRing;
+				pOldestEntry = pEntry;
+			}
+		}
+
+		if (pOldest == NULL)
+		{
+			return uCount;
+		}
+
+		loggerEmit(pOldestEntry);
+		__atomic_store_n(&pOldest->uTail, pOldest->uTail + 1,
+			__ATOMIC_RELEASE);
+		uCount++;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerDrainerThread
+    Description     : Drainer thread, formats the queued messages and writes
+    				  them once the rings are empty. It waits on the wake
+    				  eventfd while there is nothing to do.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pArg				In		Not used
+    Returns         : NULL
+
+  ============================================================================*/
+
+static void *loggerDrainerThread(void *pArg)
+{
+	unsigned int uFlushRequest = 0;
+	uint64_t uValue = 0;
+	int i = 0;
+
+	for (;;)
+	{
+		uFlushRequest = __atomic_load_n(&g_uFlushRequest, __ATOMIC_SEQ_CST);
+
+		loggerDrain();
+
+		for (i = 0; i < SINK_COUNT; i++)
+		{
+			if (g_Output[i].uLength > 0)
+			{
+				loggerWriteOut(g_Output[i].nFd, g_Output[i].szBuffer,
+					g_Output[i].uLength);
+				g_Output[i].uLength = 0;
+			}
+		}
+		__atomic_store_n(&g_uFlushDone, uFlushRequest, __ATOMIC_RELEASE);
+
+		if (__atomic_load_n(&g_bDrainerStop, __ATOMIC_ACQUIRE))
+		{
+			loggerDrain();
+			for (i = 0; i < SINK_COUNT; i++)
+			{
+				loggerWriteOut(g_Output[i].nFd, g_Output[i].szBuffer,
+					g_Output[i].uLength);
+				g_Output[i].uLength = 0;
+			}
+			return NULL;
+		}
+
+		/* Go idle, a message queued meanwhile is drained first */
+		__atomic_store_n(&g_bDrainerIdle, true, __ATOMIC_SEQ_CST);
+		if (uFlushRequest != __atomic_load_n(&g_uFlushRequest,
+			__ATOMIC_SEQ_CST) || loggerDrain() > 0)
+		{
+			__atomic_store_n(&g_bDrainerIdle, false, __ATOMIC_SEQ_CST);
+			continue;
+		}
+
+		while (read(g_nWakeFd, &uValue, sizeof(uValue)) < 0 &&
+			errno == EINTR)
+		{
+		}
+		__atomic_store_n(&g_bDrainerIdle, false, __ATOMIC_SEQ_CST);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerInit
+    Description     : Function to start the drainer thread. Messages logged
+    				  before are written synchronously.
+    Arguments       : None
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int loggerInit(void)
+{
+	struct timespec Now;
+
+	if (g_bDrainerRunning)
+	{
+		return 0;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &Now);
+	g_RealtimeBase = Now.tv_sec;
+	g_uRealtimeBaseNs = Now.tv_nsec;
+	g_uMonotonicBaseNs = loggerNow();
+
+	g_nWakeFd = eventfd(0, EFD_CLOEXEC);
+	if (g_nWakeFd == -1)
+	{
+		return -1;
+	}
+
+	g_bDrainerStop = false;
+	if (pthread_create(&g_DrainerThread, NULL, loggerDrainerThread, NULL))
+	{
+		close(g_nWakeFd);
+		g_nWakeFd = -1;
+		return -1;
+	}
+
+	pthread_atfork(loggerForkPrepare, NULL, loggerForkChild);
+	atexit(loggerClose);
+
+	__atomic_store_n(&g_bDrainerRunning, true, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerFlush
+    Description     : Function to wait till the messages queued so far are
+    				  written.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void loggerFlush(void)
+{
+	unsigned int uRequest = 0;
+
+	if (!__atomic_load_n(&g_bDrainerRunning, __ATOMIC_ACQUIRE))
+	{
+		return;
+	}
+
+	uRequest = __atomic_add_fetch(&g_uFlushRequest, 1, __ATOMIC_SEQ_CST);
+	while ((int)(__atomic_load_n(&g_uFlushDone, __ATOMIC_ACQUIRE) -
+		uRequest) < 0)
+	{
+		loggerWake();
+		sched_yield();
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerClose
+    Description     : Function to write the queued messages, stop the drainer
+    				  and close the debug log file. Later messages are written
+    				  synchronously.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void loggerClose(void)
+{
+	uint64_t uOne = 1;
+
+	if (__atomic_exchange_n(&g_bDrainerRunning, false, __ATOMIC_ACQ_REL))
+	{
+		__atomic_store_n(&g_bDrainerStop, true, __ATOMIC_RELEASE);
+		if (write(g_nWakeFd, &uOne, sizeof(uOne)) < 0)
+		{
+			/* Drainer is not idle, it sees the stop request */
+		}
+		pthread_join(g_DrainerThread, NULL);
+
+		close(g_nWakeFd);
+		g_nWakeFd = -1;
+	}
+
+	if (g_Output[SINK_DEBUG_FILE].nFd != -1)
+	{
+		close(g_Output[SINK_DEBUG_FILE].nFd);
+		g_Output[SINK_DEBUG_FILE].nFd = -1;
+	}
+	g_bDebugLogFlag = false;
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerForkPrepare
+    Description     : Fork handler, writes the queued messages so that they
+    				  are not reordered with the output of the child.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+static void loggerForkPrepare(void)
+{
+	loggerFlush();
+}
+
+
+/**=============================================================================
+
+	Function Name   : loggerForkChild
+    Description     : Fork handler of the child. The drainer thread is not
+    				  duplicated, the child drops the inherited queues and
+    				  writes its messages synchronously.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+static void loggerForkChild(void)
+{
+	sLogRing_t *pRing = NULL;
+
+	g_bDrainerRunning = false;
+	g_bDrainerIdle = false;
+
+	for (pRing = g_pRingHead; pRing != NULL; pRing = pRing->pNext)
+	{
+		pRing->uTail = pRing->uHead;
+	}
+	g_Output[SINK_STDERR].uLength = 0;
+	g_Output[SINK_DEBUG_FILE].uLength = 0;
+
+	if (g_nWakeFd != -1)
+	{
+		close(g_nWakeFd);
+		g_nWakeFd = -1;
+	}
+}
@@ -3,7 +3,9 @@
 
   File Description: Test framework Master mode of operation. This file
                     includes the functionalities required to operate the test
-                    framework in master mode.
+                    framework in master mode. Every slave connected to the
+                    master is served by its own session, with its own state
+                    machine and test execution process.
 
   Author: Johnnie Alan
 
@@ -34,6 +36,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <errno.h>
@@ -47,6 +50,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "deviceDrvTestFW.h"
 #include "testStruct.h"
 #include "console.h"
+#include "reactor.h"
+#include "watchdog.h"
+#include "arena.h"
+#include "nameIndex.h"
+#include "schedule.h"
+#include "shard.h"
+#include "clockSync.h"
 
 
 #define LOG_TO_USR 		1
@@ -55,8 +65,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define RET_SUCCESS		0
 #define RET_FAILURE	    -1
 
-#define SIG SIGRTMIN
-
 /*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
 
 typedef enum{
@@ -64,197 +72,540 @@ typedef enum{
     E_HELLO_RCVD,
     E_SEND_STATUS,
     E_FRAMEWORK_INITIALIZED,
-    E_MSG_SUIT_NAME_RCVD,
-    E_MSG_TST_NAME_RCVD,
     E_MSG_TST_RUN_RCVD,
     E_CLOSE_FRAMEWOERK
 }E_MASTER_STATE_MACHINE;
 
-E_MASTER_STATE_MACHINE eMasterStateMachine = E_NONE;
-
-/* Execution status */
-E_TST_STATUS g_eExecutionStatus;
-E_MSG_TYPE eReceivedMsgType = 0;
+/* Session of a slave connected to master. The result set of its test
+ * execution process in the arena is given by the index of the session.
+ */
+typedef struct slave_session
+{
+    bool bInUse;                            /* Slave connected */
+    unsigned int uSlot;                     /* Index of the session */
+    unsigned int uSlaveId;                  /* Id given at hello, 0 before */
+    unsigned int uShard;                    /* Shard run, coordinator only */
+    sLink_t Link;                           /* Control connection */
+    E_MASTER_STATE_MACHINE eState;          /* State machine of the slave */
+    E_TST_STATUS eExecutionStatus;          /* Execution status */
+    bool bStatusPending;                    /* Status reply deferred */
+    unsigned short uStatusSeqNo;            /* Deferred status request */
+    bool bExecutorStarted;                  /* Watchdog and channel created */
+    sTestChannel_t Channel;                 /* Scheduled case, result */
+    sWatchdog_t Watchdog;                   /* Child process and test timer */
+    unsigned int uRunningCase;              /* Case index being executed */
+    uint64_t uStartedNs;                    /* Start of the case run at the
+                                               time scheduled by slave, 0
+                                               if it was not scheduled */
+    int nScreenCol;                         /* Console row of the case */
+
+    /* Test id sent by slave in E_MSG_TST_RUN is the number of the case
+     * record in the manifest, mapped here to the case index in the list,
+     * -1 if not found.
+     */
+    int *pnTestIdCase;
+    unsigned int uTestIds, uTestIdCapacity;
+}sSlaveSession_t;
+
+static sSlaveSession_t aSession[FW_MAX_SLAVES];
+static unsigned int uSessionsOpen;          /* Slaves connected */
+static unsigned int uSessionsDone;          /* Slaves served and closed */
+static bool bSessionLost = false;           /* Slave closed abruptly */
+static unsigned int uShardsDealt;           /* Shards given to the slaves */
+
+/* Framework is initialized by the first slave, the others get its result */
+static bool bFrameworkLoaded = false;
+static E_TST_STATUS eFrameworkStatus;
 
 pthread_t g_masterMainThread;
-sTestCase_t *pTestcase = NULL;
-sTestSuite_t *pSuite = NULL;
 
-extern pid_t cpid;
+extern int g_nMasterSockfd;
 sigset_t mask;
 
-int nCommChannel[2];						/* Socket Pair */
-
-sHandshakeMsg_t ReceivedMsg;
+unsigned char szManifestResult[FW_MAX_PAYLOAD_LEN / 16 + 1];
 
 /*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
 
-void *pMasterWorkerThread(void *pFd);
 void *pMasterMainThread(void *pFd);
-static void createTimer(void);
-static void initialHandshake(void);
-static void childProcess(void);
+static void forkChildProcess(sSlaveSession_t *pSession);
+static void acceptHandler(int nFd, uint32_t uEvents, void *pArg);
+static void socketHandler(int nFd, uint32_t uEvents, void *pArg);
+static void serveRequests(sSlaveSession_t *pSession);
+static void processRequest(sSlaveSession_t *pSession,
+    sHandshakeMsg_t *pReceived);
+static void completeTestCase(sSlaveSession_t *pSession);
+static void doneHandler(int nFd, uint32_t uEvents, void *pArg);
+static void exitHandler(sWatchdog_t *pWatchdog, int nStatus);
+static void sendStatus(sSlaveSession_t *pSession, unsigned short uSeqNo);
+static void flushSessions(void);
+static void closeSession(sSlaveSession_t *pSession, bool bAbrupt);
+static unsigned int assignSlaveId(unsigned int uRequestedId);
+static void initializeSession(sSlaveSession_t *pSession);
+static void addTestId(sSlaveSession_t *pSession, int nCase);
+static void recordTestResult(sSlaveSession_t *pSession,
+    sHandshakeMsg_t *pReceived);
+static unsigned int resolveManifest(sSlaveSession_t *pSession,
+    unsigned char *pRecords, unsigned int uLength);
 
 /*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
 
 /**=============================================================================
 
-	Function Name   : timerHandler
-    Description     : This is the signal handler. It is called when the timer
-    				  expires and it also sends the SIGKILL to child process
-    				  created in slave thread.
+	Function Name   : sendStatus
+    Description     : Function to send the execution status to slave machine,
+    				  with the start time of a case run at a scheduled time.
     Arguments       :
     				  Name            	Dir    	Description
-                      @sig  			In		Signal number
-                      @si				In		Signal information
-                      @uc				In		Pointer to ucontext_t
+                      @pSession			In		Session of the slave
+                      @uSeqNo  			In		Sequence number of the status
+                      					 		request
     Returns         : None
 
   ============================================================================*/
 
-static void timerHandler(int sig, siginfo_t *si, void *uc)
+static void sendStatus(sSlaveSession_t *pSession, unsigned short uSeqNo)
 {
-	kill(cpid, SIGUSR1);
+	sHandshakeMsg_t Send;
+	unsigned char szStarted[FW_START_TIME_LEN];
+	uint64_t uStartedNs = pSession->uStartedNs;
+	int i = 0;
+
+	memset(&Send, 0, sizeof(Send));
+	Send.uSeqNo = uSeqNo;
+	Send.uSlaveId = pSession->uSlaveId;
+
+	/* Slave measures the skew of the starts from it */
+	if (uStartedNs != 0)
+	{
+		for (i = 0; i < FW_START_TIME_LEN; i++)
+		{
+			szStarted[i] = (unsigned char)(uStartedNs & 0xff);
+			uStartedNs >>= 8;
+		}
+		Send.pPayload = szStarted;
+		Send.uPayloadLength = FW_START_TIME_LEN;
+	}
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tSlave %d: Send >> E_MSG_STATUS [%s:%d]\n",
+		pSession->uSlaveId, __FILENAME__, __LINE__);
+	Send.eMsgType = E_MSG_STATUS;
+	Send.Msg.eStatus = pSession->eExecutionStatus;
+	sendMessage(&pSession->Link, &Send);
 }
 
 
 /**=============================================================================
 
-    Function Name   : initializeMasterDevice
-    Description     : Function to create master thread and also to receive the
-    			      messages sent by the slave machine.
-    Arguments       : None
+	Function Name   : acceptHandler
+    Description     : This is the listening socket event handler. It accepts
+    				  the connection of a slave and opens a free session for
+    				  it. The connection is refused when all the sessions are
+    				  in use or when the slaves to be served are connected.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		Listening socket
+                      @uEvents			In		Epoll events
+                      @pArg				In		Not used
     Returns         : None
 
   ============================================================================*/
 
-void initializeMasterDevice(void)
+static void acceptHandler(int nFd, uint32_t uEvents, void *pArg)
 {
-	int nDataAvailable = 0, nRet = 0;
-	sHandshakeMsg_t Receive, Send;
+	sSlaveSession_t *pSession = NULL;
+	int nSockfd = -1, nNoDelay = 1;
+	unsigned int uSlot = 0;
 
-	if (socketpair(AF_UNIX, SOCK_STREAM, 0, nCommChannel) == -1)
+	nSockfd = accept(nFd, NULL, NULL);
+	if (nSockfd < 0)
 	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating socketpair\n");
-		freeMemory(1);
+		fprintf(stderr, "Client connection failed\n");
+		return;
 	}
 
-	/* Create a thread in parent process */
-	pthread_create(&g_masterMainThread, NULL, pMasterMainThread, NULL);
+	for (uSlot = 0; uSlot < FW_MAX_SLAVES; uSlot++)
+	{
+		if (!aSession[uSlot].bInUse)
+		{
+			pSession = &aSession[uSlot];
+			break;
+		}
+	}
 
-	memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
+	if ((pSession == NULL) || ((g_uMasterSlaves != 0) &&
+		((uSessionsOpen + uSessionsDone) >= g_uMasterSlaves)))
+	{
+		fprintf(stderr, "Client connection refused, no free session\n");
+		close(nSockfd);
+		return;
+	}
 
-	while(1)
+	fprintf(stderr, "Client connected successfully\n");
+
+	/* Frames are batched by sendMessage, do not delay them further */
+	setsockopt(nSockfd, IPPROTO_TCP, TCP_NODELAY, &nNoDelay,
+		sizeof(nNoDelay));
+
+	memset(pSession, 0, sizeof(sSlaveSession_t));
+	pSession->bInUse = true;
+	pSession->uSlot = uSlot;
+	pSession->Link.nSockfd = nSockfd;
+	pSession->eState = E_NONE;
+
+	if (reactorAdd(nSockfd, EPOLLIN | EPOLLRDHUP, socketHandler,
+		pSession) == -1)
 	{
-		memset(&Receive,0,sizeof(Receive));
-		memset(&Send,0,sizeof(Send));
+		close(nSockfd);
+		pSession->bInUse = false;
+		return;
+	}
+
+	uSessionsOpen++;
+}
+
+
+/**=============================================================================
+
+	Function Name   : socketHandler
+    Description     : This is the control socket event handler of a session.
+    				  It receives the messages sent by the slave machine and
+    				  processes them in the order they are received. The
+    				  socket is not read while a status reply is deferred.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		Control socket
+                      @uEvents			In		Epoll events
+                      @pArg				In		Session of the slave
+    Returns         : None
 
-		nDataAvailable = 0;
+  ============================================================================*/
+
+static void socketHandler(int nFd, uint32_t uEvents, void *pArg)
+{
+	sSlaveSession_t *pSession = (sSlaveSession_t *)pArg;
+	sHandshakeMsg_t Receive;
+	int nRet = 0;
 
-		/* Check if data available */
-		nDataAvailable = peek();
-		if (nDataAvailable == -1)
+	/* Only the close of the slave is watched while the reply is deferred */
+	if (pSession->bStatusPending)
+	{
+		if (uEvents & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
 		{
-			deviceDrvTstFWDebug(LOG_TO_USR, "Socket closed\n");
-			freeMemory(1);
+			closeSession(pSession, true);
 		}
+		return;
+	}
 
-		/* Receive data if avaialble */
-		if ((nDataAvailable > 0) && (eMasterStateMachine != E_CLOSE_FRAMEWOERK))
-		{
-			nRet = receiveMessage(&Receive);
+	memset(&Receive, 0, sizeof(Receive));
 
-			/* if socket is closed abruptly */
-			if(nRet == 0)
-			{
-				freeMemory(1);
-			}
+	nRet = receiveMessage(&pSession->Link, &Receive);
+
+	/* if socket is closed abruptly */
+	if (nRet == 0)
+	{
+		closeSession(pSession, true);
+		return;
+	}
+
+	/* Rest of the request is not received yet */
+	if (nRet < 0)
+	{
+		return;
+	}
+
+	processRequest(pSession, &Receive);
+	serveRequests(pSession);
+}
 
-			if(g_eExecutionStatus != E_RUNNING)
-			{
-				memcpy(&ReceivedMsg, &Receive, sizeof(sHandshakeMsg_t));
-			}
-		}
 
-		if (Receive.eMsgType == E_MSG_STATUS)
+/**=============================================================================
+
+	Function Name   : serveRequests
+    Description     : Function to process the requests already in the receive
+    				  buffer of a session. They do not make the socket readable
+    				  again, so they are taken here unless a status reply is
+    				  deferred.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pSession			In		Session of the slave
+    Returns         : None
+
+  ============================================================================*/
+
+static void serveRequests(sSlaveSession_t *pSession)
+{
+	sHandshakeMsg_t Receive;
+
+	while (pSession->bInUse && !pSession->bStatusPending &&
+		isMessageBuffered(&pSession->Link))
+	{
+		memset(&Receive, 0, sizeof(Receive));
+		if (receiveMessage(&pSession->Link, &Receive) <= 0)
 		{
-			deviceDrvTstFWDebug(LOG_TO_DBG,
-				"\tReceived << E_MSG_STATUS [%s:%d]\n",
-				__FILENAME__, __LINE__);
+			closeSession(pSession, true);
+			return;
+		}
+		processRequest(pSession, &Receive);
+	}
+}
 
-			deviceDrvTstFWDebug(LOG_TO_DBG,
-				"\tSend >> E_MSG_STATUS [%s:%d]\n",
-				__FILENAME__, __LINE__);
-			Send.eMsgType = E_MSG_STATUS;
-			Send.Msg.eStatus = g_eExecutionStatus;
-			sendMessage(&Send);
+
+/**=============================================================================
+
+	Function Name   : completeTestCase
+    Description     : Function to stop the watchdog, to read the result of the
+    				  executed test case from the arena, to update the console
+    				  and to answer the deferred status request. A case without
+    				  result was ended by the termination of the child process,
+    				  it timed out if the watchdog expired, else it failed.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pSession			In		Session of the slave
+    Returns         : None
+
+  ============================================================================*/
+
+static void completeTestCase(sSlaveSession_t *pSession)
+{
+	E_TST_STATUS eStatus;
+	uint64_t uElapsedNs = 0;
+	unsigned int uCase = pSession->uRunningCase;
+
+	pSession->eState = E_FRAMEWORK_INITIALIZED;
+	watchdogStop(&pSession->Watchdog);
+
+	pSession->uStartedNs =
+		arenaStarted(pSession->Channel.uResultBase + uCase);
+	if (!arenaCollect(pSession->Channel.uResultBase + uCase, &eStatus,
+		&uElapsedNs, -1))
+	{
+		eStatus = pSession->Watchdog.bExpired ? E_TIMEOUT : E_FAILED;
+	}
+
+	g_Registry.peStatus[uCase] = eStatus;
+	g_Registry.pdElapsedTime[uCase] =
+		(double)uElapsedNs / WATCHDOG_NSEC_PER_SEC;
+
+	pSession->eExecutionStatus = eStatus;
+
+	if(eStatus == E_PASSED)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tSlave %d: Test case %s passed [%s:%d]\n", pSession->uSlaveId,
+			g_Registry.pszCaseName[uCase], __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(pSession->nScreenCol,
+				g_Registry.pdElapsedTime[uCase], TST_PASSED);
+	}
+	else if(eStatus == E_FAILED)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tSlave %d: Test case %s failed [%s:%d]\n", pSession->uSlaveId,
+			g_Registry.pszCaseName[uCase], __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(pSession->nScreenCol,
+				g_Registry.pdElapsedTime[uCase], TST_FAILED);
+	}
+	else if(eStatus == E_TIMEOUT)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tSlave %d: Test case %s Timeout [%s:%d]\n", pSession->uSlaveId,
+			g_Registry.pszCaseName[uCase], __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(pSession->nScreenCol, 0,
+				TST_TIMEOUT);
+	}
+
+	if (pSession->bStatusPending)
+	{
+		pSession->bStatusPending = false;
+		sendStatus(pSession, pSession->uStatusSeqNo);
+		reactorModify(pSession->Link.nSockfd, EPOLLIN | EPOLLRDHUP);
+
+		/* Requests received while the reply was deferred */
+		serveRequests(pSession);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : doneHandler
+    Description     : This is the done eventfd handler. It is called when the
+    				  child process of a session published the result of its
+    				  test case in the arena.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		Done eventfd
+                      @uEvents			In		Epoll events
+                      @pArg				In		Session of the slave
+    Returns         : None
+
+  ============================================================================*/
+
+static void doneHandler(int nFd, uint32_t uEvents, void *pArg)
+{
+	sSlaveSession_t *pSession = (sSlaveSession_t *)pArg;
+
+	if (channelDrain(&pSession->Channel) && pSession->Watchdog.bRunning)
+	{
+		completeTestCase(pSession);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : exitHandler
+    Description     : This is the watchdog exit handler. It is called when the
+    				  child process of a session terminated, the test case it
+    				  was running is completed from the arena and a new child
+    				  process is forked.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog of the child process
+                      @nStatus			In		Exit status of the process
+    Returns         : None
+
+  ============================================================================*/
+
+static void exitHandler(sWatchdog_t *pWatchdog, int nStatus)
+{
+	sSlaveSession_t *pSession = (sSlaveSession_t *)pWatchdog->pArg;
+
+	deviceDrvTstFWDebug(LOG_TO_USR,
+		"Test execution process of slave %d terminated, restarting it\n",
+		pSession->uSlaveId);
+
+	if (pWatchdog->bRunning)
+	{
+		completeTestCase(pSession);
+	}
+
+	reactorRemove(pSession->Channel.nDoneFd);
+	channelClose(&pSession->Channel);
+
+	forkChildProcess(pSession);
+}
+
+
+/**=============================================================================
+
+	Function Name   : flushSessions
+    Description     : Function to send the replies queued in every session. A
+    				  session whose slave is gone is closed.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+static void flushSessions(void)
+{
+	unsigned int uSlot = 0;
+
+	for (uSlot = 0; uSlot < FW_MAX_SLAVES; uSlot++)
+	{
+		if (aSession[uSlot].bInUse &&
+			(flushMessages(&aSession[uSlot].Link) == -1))
+		{
+			closeSession(&aSession[uSlot], true);
 		}
+	}
+}
+
 
-		if(eMasterStateMachine == E_CLOSE_FRAMEWOERK)
+/**=============================================================================
+
+	Function Name   : closeSession
+    Description     : Function to kill the test execution process of a
+    				  session, to close the connection of its slave and to
+    				  release the session.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pSession			In		Session of the slave
+                      @bAbrupt			In		Slave closed without
+                      							E_MSG_CLOSE
+    Returns         : None
+
+  ============================================================================*/
+
+static void closeSession(sSlaveSession_t *pSession, bool bAbrupt)
+{
+	if (bAbrupt)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Socket closed, slave %d\n",
+			pSession->uSlaveId);
+
+		/* A connection which never said hello was not a slave */
+		if (pSession->uSlaveId != 0)
 		{
-			break;
+			bSessionLost = true;
 		}
 	}
-	pthread_join(g_masterMainThread, NULL);
+
+	if (pSession->bExecutorStarted)
+	{
+		watchdogClose(&pSession->Watchdog);
+		reactorRemove(pSession->Channel.nDoneFd);
+		channelClose(&pSession->Channel);
+	}
+
+	reactorRemove(pSession->Link.nSockfd);
+	close(pSession->Link.nSockfd);
+
+	free(pSession->pnTestIdCase);
+	pSession->pnTestIdCase = NULL;
+
+	/* Refused slaves are not counted as served */
+	if (pSession->uSlaveId != 0)
+	{
+		uSessionsDone++;
+	}
+
+	pSession->bInUse = false;
+	uSessionsOpen--;
 }
 
 
 /**=============================================================================
 
-	Function Name   : childProcess
-    Description     : This function is used to execute the testcases scheduled
-    				  by the master thread and send back the execution status to
-    				  master thread.
+    Function Name   : initializeMasterDevice
+    Description     : Function to create master thread, the slaves are
+    				  accepted and served by the master thread.
     Arguments       : None
     Returns         : None
 
   ============================================================================*/
 
-static void childProcess(void)
+void initializeMasterDevice(void)
 {
-    int nScreenCol = 0, nRet=0;
-    int nErr = 0;
-    fd_set readset;
-    sInterProcessMsg_t ToParent;
-
-    E_TST_STATUS testStatus;
-
-	/* Initialize time out struct for select() */
-    struct timeval Tv;
-    Tv.tv_sec = 0;
-    Tv.tv_usec = 10000;
-
-    while (1)
-    {
-		/* Initialize the set */
-        FD_ZERO(&readset);
-        FD_SET(nCommChannel[1], &readset);
-
-        /* Now, check for readability */
-        nErr = select(nCommChannel[1]+1, &readset, NULL, NULL, &Tv);
-        if (nErr > 0 && FD_ISSET(nCommChannel[1], &readset))
-        {
-            /* Clear flags */
-            FD_CLR(nCommChannel[1], &readset);
-
-            /* Do a simple read on data */
-            memset(&ToParent,0,sizeof(ToParent));
-            read(nCommChannel[1], &ToParent, sizeof(ToParent));
-
-			switch (ToParent.nType)
-			{
-				/* Execute test case */
-				case 0x01:
-					pTestcase = ToParent.pTestcase;
-					pTestcase->eStatus = pTestcase->fnPtrTestCase();
-
-					memset(&ToParent,0,sizeof(ToParent));
-					ToParent.nType = E_MSG_SUIT_NAME_RCVD;
-					ToParent.eStatus = pTestcase->eStatus;
-					send(nCommChannel[1], &ToParent, sizeof(ToParent), 0);
-				break;
-			}
-		}
+	memset(aSession, 0, sizeof(aSession));
+
+	if ((reactorInit() == -1) ||
+		(reactorAdd(g_nMasterSockfd, EPOLLIN, acceptHandler, NULL) == -1))
+	{
+		freeMemory(1);
+	}
+
+	/* Create a thread in parent process */
+	pthread_create(&g_masterMainThread, NULL, pMasterMainThread, NULL);
+
+	pthread_join(g_masterMainThread, NULL);
+
+	/* Results of all the shards, also when a slave was lost */
+	if (g_bCoordinator && (eFrameworkStatus == E_PASSED))
+	{
+		scheduleFinish(g_uMasterSlaves);
+		shardWriteReport();
+	}
+
+	if (bSessionLost)
+	{
+		freeMemory(1);
 	}
 }
 
@@ -262,10 +613,10 @@ static void childProcess(void)
 /**=============================================================================
 
     Function Name   : pMasterMainThread
-    Description     : This is a thread function. It is used to find the test
-    				  suite and test case sent by the slave machine in the list
-    				  and send the status. If found, same test case will be
-    				  scheduled to execute in child process.
+    Description     : This is a thread function. It waits for the slaves,
+    				  their requests, the child processes and the timers, and
+    				  sends the queued replies, till the slaves to be served
+    				  have closed their sessions.
     Arguments       : None
     Returns         : None
 
@@ -273,470 +624,624 @@ static void childProcess(void)
 
 void *pMasterMainThread(void *pFd)
 {
-	int nScreenCol = 0, nDataAvailable =0, nRet = 0, nErr = 0;
-	fd_set readset;
-	sInterProcessMsg_t ToChild;
+	while ((g_uMasterSlaves == 0) || (uSessionsDone < g_uMasterSlaves))
+	{
+		reactorDispatch(REACTOR_WAIT_FOREVER, 1);
+		flushSessions();
+	}
+
+	pthread_exit(NULL);
+}
+
+
+/**=============================================================================
+
+	Function Name   : processRequest
+    Description     : Function to process a request received from the slave
+    				  of a session and to queue its reply. Status request is
+    				  answered here unless a test case is running, then the
+    				  reply is deferred till the test case completes.
+    Arguments       :
+                      Name              Dir     Description
+                      @pSession         In      Session of the slave
+                      @pReceived        In      Request received
+
+    Returns         : None
+
+  ============================================================================*/
+
+static void processRequest(sSlaveSession_t *pSession,
+    sHandshakeMsg_t *pReceived)
+{
 	sHandshakeMsg_t Send;
+	unsigned char szClockSync[FW_CLOCK_SYNC_LEN];
+	uint64_t uReceivedNs = 0, uStartAtNs = 0;
+	int nCase = -1, i = 0;
+
+	memset(&Send,0,sizeof(Send));
 
-	/* Initialize time out struct for select() */
-    struct timeval Tv;
-    Tv.tv_sec = 0;
-    Tv.tv_usec = 10000;
+	/* Reply carries the sequence number of the request */
+	Send.uSeqNo = pReceived->uSeqNo;
+	Send.uSlaveId = pSession->uSlaveId;
 
-	/* Send hello message and initialize test framework */
-	initialHandshake();
-	if (eMasterStateMachine == E_FRAMEWORK_INITIALIZED)
+	switch (pReceived->eMsgType)
 	{
-		createTimer();
+		case E_MSG_HELLO:
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tReceived << E_MSG_HELLO, slave id %d [%s:%d]\n",
+				pReceived->uSlaveId, __FILENAME__, __LINE__);
 
-		/* Create a child process */
-		cpid = fork();
-		if(cpid == 0)
-		{
-			childProcess();
-		}
-		else
-		{
-			while (1)
+			Send.uSlaveId = (pSession->eState != E_NONE) ? 0 :
+				assignSlaveId(pReceived->uSlaveId);
+			if (Send.uSlaveId == 0)
 			{
-				memset(&Send,0,sizeof(Send));
-				memset(&ToChild,0,sizeof(ToChild));
+				deviceDrvTstFWDebug(LOG_TO_USR,
+					"Slave id %d is in use, slave refused\n",
+					pReceived->uSlaveId);
+				Send.eMsgType = E_MSG_NACK;
+			}
+			else
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_ACK [%s:%d]\n",
+					Send.uSlaveId, __FILENAME__, __LINE__);
 
-				switch (ReceivedMsg.eMsgType)
-				{
-					case E_MSG_TST_SUITE_NAME:
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tReceived << E_MSG_TST_SUITE_NAME [%s:%d]\n",
-							__FILENAME__, __LINE__);
-
-						g_eExecutionStatus = E_RUNNING;
-
-						if (eMasterStateMachine != E_FRAMEWORK_INITIALIZED)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_NACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_NACK;
-							sendMessage(&Send);
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_ACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_ACK;
-							sendMessage(&Send);
-
-							eMasterStateMachine = E_MSG_SUIT_NAME_RCVD;
-
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tReceived Test suite name: %s [%s:%d]\n",
-								ReceivedMsg.Msg.szName, __FILENAME__, __LINE__);
-
-							HASH_FIND_STR(g_pSuiteHead, ReceivedMsg.Msg.szName,
-								pSuite);
-							if (pSuite)
-							{
-								deviceDrvTstFWDebug(LOG_TO_DBG,
-									"\tTest suite %s found [%s:%d]\n",
-									ReceivedMsg.Msg.szName, __FILENAME__,
-									__LINE__);
-
-								g_eExecutionStatus = E_FOUND;
-							}
-							else
-							{
-								deviceDrvTstFWDebug(LOG_TO_DBG,
-									"\tTest suite %s Not-found [%s:%d]\n",
-									ReceivedMsg.Msg.szName, __FILENAME__,
-									__LINE__);
-
-								g_eExecutionStatus = E_NOT_FOUND;
-								eMasterStateMachine = E_FRAMEWORK_INITIALIZED;
-							}
-						}
-						memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
-					break;
+				pSession->uSlaveId = Send.uSlaveId;
+				pSession->uShard = uShardsDealt++;
+				pSession->eState = E_HELLO_RCVD;
+				Send.eMsgType = E_MSG_ACK;
+			}
+			sendMessage(&pSession->Link, &Send);
+		break;
 
-					case E_MSG_TST_SUITE_LIST_COMPLETED:
-						if (eMasterStateMachine != E_FRAMEWORK_INITIALIZED)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_NACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-
-							Send.eMsgType = E_MSG_NACK;
-							sendMessage(&Send);
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tReceived << E_MSG_TST_SUITE_LIST_COMPLETED [%s:%d]\n",
-								__FILENAME__, __LINE__);
-
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_ACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-
-							Send.eMsgType = E_MSG_ACK;
-							sendMessage(&Send);
-						}
-						memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
-					break;
+		case E_MSG_FRAMEWORK_INIT:
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tSlave %d: Received << E_MSG_FRAMEWORK_INIT [%s:%d]\n",
+				pSession->uSlaveId, __FILENAME__, __LINE__);
 
-					case E_MSG_TST_CASE_NAME:
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tReceived << E_MSG_TST_CASE_NAME [%s:%d]\n",
-							__FILENAME__, __LINE__);
-
-						g_eExecutionStatus = E_RUNNING;
-
-						if (eMasterStateMachine != E_MSG_SUIT_NAME_RCVD)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_NACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_NACK;
-							sendMessage(&Send);
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_ACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_ACK;
-							sendMessage(&Send);
-
-							eMasterStateMachine = E_MSG_TST_NAME_RCVD;
-
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tReceived Test case name: %s [%s:%d]\n",
-								ReceivedMsg.Msg.szName, __FILENAME__, __LINE__);
-
-							HASH_FIND(hh,pSuite->sTestCaseList,
-								ReceivedMsg.Msg.szName,
-								strlen(ReceivedMsg.Msg.szName),
-								pTestcase);
-
-							if (g_bConsoleInitialized)
-								nScreenCol =
-									fnAddTestNameToScreen(
-										ReceivedMsg.Msg.szName, 0, TST_RUNNING);
-
-							if (pTestcase != NULL)
-							{
-								deviceDrvTstFWDebug(LOG_TO_DBG,
-									"\tTest case %s found [%s:%d]\n",
-									ReceivedMsg.Msg.szName, __FILENAME__,
-									__LINE__);
-
-								g_eExecutionStatus = E_FOUND;
-							}
-							else
-							{
-								deviceDrvTstFWDebug(LOG_TO_DBG,
-									"\tTest case %s not found [%s:%d]\n",
-									ReceivedMsg.Msg.szName, __FILENAME__,
-									__LINE__);
-
-								g_eExecutionStatus = E_NOT_FOUND;
-								eMasterStateMachine = E_MSG_SUIT_NAME_RCVD;
-
-								if (g_bConsoleInitialized)
-									fnUpdateTstStatusToScreen(nScreenCol, 0,
-										TST_ERROR);
-							}
-						}
-						memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
-					break;
+			if (pSession->eState != E_HELLO_RCVD)
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_NACK [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
+				Send.eMsgType = E_MSG_NACK;
+				sendMessage(&pSession->Link, &Send);
+			}
+			else
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_ACK [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
+				Send.eMsgType = E_MSG_ACK;
+				sendMessage(&pSession->Link, &Send);
 
-					case E_MSG_TST_RUN:
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tReceived << E_MSG_TST_RUN [%s:%d]\n",
-							__FILENAME__, __LINE__);
-						g_eExecutionStatus  = E_RUNNING;
-
-						if (eMasterStateMachine != E_MSG_TST_NAME_RCVD)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_NACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-
-							Send.eMsgType = E_MSG_NACK;
-							sendMessage(&Send);
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_ACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-
-							Send.eMsgType = E_MSG_ACK;
-							sendMessage(&Send);
-
-							eMasterStateMachine = E_MSG_TST_RUN_RCVD;
-
-							ToChild.nType = 0x01;
-							ToChild.pTestcase = pTestcase;
-							send(nCommChannel[0], &ToChild,
-								sizeof(ToChild), 0);
-							checkTimer(&g_timerId, pTestcase->uTimeout, true);
-
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tTest case is running... [%s:%d]\n",
-								__FILENAME__, __LINE__);
-						}
-						memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
-					break;
+				/* Slave initializes its framework on this ACK */
+				flushMessages(&pSession->Link);
 
-					case E_MSG_TST_CASE_LIST_COMPLETED:
-						if (eMasterStateMachine != E_MSG_SUIT_NAME_RCVD)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_NACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_NACK;
-							sendMessage(&Send);
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tReceived << E_MSG_TST_CASE_LIST_COMPLETED [%s:%d]\n",
-								__FILENAME__, __LINE__);
-
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> E_MSG_ACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-
-							Send.eMsgType = E_MSG_ACK;
-							sendMessage(&Send);
-
-							eMasterStateMachine = E_FRAMEWORK_INITIALIZED;
-						}
-						memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
-					break;
+				initializeSession(pSession);
+			}
+		break;
 
-					case E_MSG_CLOSE:
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tReceived << E_MSG_CLOSE [%s:%d]\n",
-							__FILENAME__, __LINE__);
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tSend >> E_MSG_ACK [%s:%d]\n",
-							__FILENAME__, __LINE__);
-						Send.eMsgType = E_MSG_ACK;
-						sendMessage(&Send);
-
-						eMasterStateMachine = E_CLOSE_FRAMEWOERK;
-						memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
-					break;
-				}
+		case E_MSG_STATUS:
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tSlave %d: Received << E_MSG_STATUS [%s:%d]\n",
+				pSession->uSlaveId, __FILENAME__, __LINE__);
+
+			if (pSession->eExecutionStatus == E_RUNNING)
+			{
+				pSession->uStatusSeqNo = pReceived->uSeqNo;
+				pSession->bStatusPending = true;
+				reactorModify(pSession->Link.nSockfd, EPOLLRDHUP);
+			}
+			else
+			{
+				sendStatus(pSession, pReceived->uSeqNo);
+			}
+		break;
+
+		case E_MSG_TST_MANIFEST:
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tSlave %d: Received << E_MSG_TST_MANIFEST %d bytes [%s:%d]\n",
+				pSession->uSlaveId, pReceived->uPayloadLength,
+				__FILENAME__, __LINE__);
+
+			if (pSession->eState != E_FRAMEWORK_INITIALIZED)
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_NACK [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
+				Send.eMsgType = E_MSG_NACK;
+				sendMessage(&pSession->Link, &Send);
+			}
+			else
+			{
+				Send.eMsgType = E_MSG_TST_MANIFEST_RSLT;
+				Send.pPayload = szManifestResult;
+				Send.uPayloadLength = resolveManifest(pSession,
+					pReceived->pPayload, pReceived->uPayloadLength);
+
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_TST_MANIFEST_RSLT [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
+				sendMessage(&pSession->Link, &Send);
+			}
+		break;
+
+		case E_MSG_TST_SUITE_LIST_COMPLETED:
+			if (pSession->eState != E_FRAMEWORK_INITIALIZED)
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_NACK [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
+
+				Send.eMsgType = E_MSG_NACK;
+				sendMessage(&pSession->Link, &Send);
+			}
+			else
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Received << E_MSG_TST_SUITE_LIST_COMPLETED "
+					"[%s:%d]\n", pSession->uSlaveId, __FILENAME__, __LINE__);
+
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_ACK [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
+
+				Send.eMsgType = E_MSG_ACK;
+				sendMessage(&pSession->Link, &Send);
+			}
+		break;
+
+		case E_MSG_TST_RUN:
+			nCase = (pReceived->Msg.uTestId < pSession->uTestIds) ?
+				pSession->pnTestIdCase[pReceived->Msg.uTestId] : -1;
 
-				if(eMasterStateMachine == E_CLOSE_FRAMEWOERK)
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tSlave %d: Received << E_MSG_TST_RUN %u %s [%s:%d]\n",
+				pSession->uSlaveId, pReceived->Msg.uTestId,
+				(nCase != -1) ? g_Registry.pszCaseName[nCase] :
+				(unsigned char *)"-", __FILENAME__, __LINE__);
+			pSession->eExecutionStatus = E_RUNNING;
+
+			if ((pSession->eState != E_FRAMEWORK_INITIALIZED) ||
+				(nCase == -1))
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_NACK [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
+
+				pSession->eExecutionStatus = E_NOT_FOUND;
+				Send.eMsgType = E_MSG_NACK;
+				sendMessage(&pSession->Link, &Send);
+			}
+			else
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Send >> E_MSG_ACK [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
+
+				Send.eMsgType = E_MSG_ACK;
+				sendMessage(&pSession->Link, &Send);
+
+				/* Coordinator has no counterpart test, slave result counts */
+				if (g_bCoordinator)
 				{
+					pSession->eExecutionStatus = E_PASSED;
 					break;
 				}
 
-				/* Initialize the set */
-				FD_ZERO(&readset);
-				FD_SET(nCommChannel[0], &readset);
+				pSession->eState = E_MSG_TST_RUN_RCVD;
+				pSession->uRunningCase = nCase;
+				pSession->uStartedNs = 0;
 
-				/* Now, check for readability */
-				nErr = select(nCommChannel[0]+1, &readset, NULL, NULL, &Tv);
-				if (nErr > 0 && FD_ISSET(nCommChannel[0], &readset))
+				/* Start time proposed by slave on the clock of master */
+				if (pReceived->uPayloadLength >= FW_START_TIME_LEN)
 				{
-					/* Clear flags */
-					FD_CLR(nCommChannel[0], &readset);
-
-					memset(&ToChild, 0, sizeof(ToChild));
-
-					/* Do a simple read on data */
-					read(nCommChannel[0], &ToChild,
-						sizeof(ToChild));
-
-					eMasterStateMachine = ToChild.nType;
-					pTestcase->eStatus = ToChild.eStatus;
-					pTestcase->dElapsedTime = (pTestcase->uTimeout/1000) -
-							checkTimer(&g_timerId, pTestcase->uTimeout, false);
-
-					g_eExecutionStatus = pTestcase->eStatus;
-
-                    if(pTestcase->eStatus == E_PASSED)
-                    {
-                        deviceDrvTstFWDebug(LOG_TO_DBG,
-                        	"\tTest case %s passed [%s:%d]\n",
-                            pTestcase->szName, __FILENAME__, __LINE__);
-
-                        if (g_bConsoleInitialized)
-							fnUpdateTstStatusToScreen(nScreenCol,
-								pTestcase->dElapsedTime, TST_PASSED);
-                    }
-                    else if(pTestcase->eStatus == E_FAILED)
-                    {
-                        deviceDrvTstFWDebug(LOG_TO_DBG,
-                        	"\tTest case %s failed [%s:%d]\n",
-                            pTestcase->szName, __FILENAME__, __LINE__);
-
-                        if (g_bConsoleInitialized)
-							fnUpdateTstStatusToScreen(nScreenCol,
-								pTestcase->dElapsedTime, TST_FAILED);
-                    }
-                    else if(pTestcase->eStatus == E_TIMEOUT)
-                    {
-                        deviceDrvTstFWDebug(LOG_TO_DBG,
-                        	"\tTest case %s Timeout [%s:%d]\n",
-                            pTestcase->szName, __FILENAME__, __LINE__);
-
-                        if (g_bConsoleInitialized)
-							fnUpdateTstStatusToScreen(nScreenCol, 0,
-								TST_TIMEOUT);
-                    }
+					for (i = FW_START_TIME_LEN - 1; i >= 0; i--)
+					{
+						uStartAtNs = (uStartAtNs << 8) |
+							pReceived->pPayload[i];
+					}
 				}
+
+				if (g_bConsoleInitialized)
+					pSession->nScreenCol =
+						fnAddTestNameToScreen(
+							g_Registry.pszCaseName[nCase], 0,
+							TST_RUNNING);
+
+				watchdogStart(&pSession->Watchdog,
+					g_Registry.puTimeout[nCase]);
+				arenaSchedule(pSession->Channel.uResultBase + nCase,
+					uStartAtNs);
+				channelPost(&pSession->Channel, nCase);
+
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSlave %d: Test case is running... [%s:%d]\n",
+					pSession->uSlaveId, __FILENAME__, __LINE__);
 			}
-		}
+		break;
+
+		/* Times are stamped as close to the socket as possible, the
+		 * reply is sent right away
+		 */
+		case E_MSG_CLOCK_SYNC:
+			uReceivedNs = clockSyncNow();
+
+			Send.eMsgType = E_MSG_CLOCK_SYNC;
+			Send.pPayload = szClockSync;
+			Send.uPayloadLength = clockSyncReply(uReceivedNs, szClockSync);
+			sendMessage(&pSession->Link, &Send);
+			flushMessages(&pSession->Link);
+		break;
+
+		/* Not a request, nothing is sent back */
+		case E_MSG_TST_RESULT:
+			recordTestResult(pSession, pReceived);
+		break;
+
+		case E_MSG_CLOCK_ESTIMATE:
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tSlave %d: Received << E_MSG_CLOCK_ESTIMATE [%s:%d]\n",
+				pSession->uSlaveId, __FILENAME__, __LINE__);
+			clockSyncApply(pSession->uSlot, pReceived->pPayload,
+				pReceived->uPayloadLength);
+		break;
+
+		case E_MSG_CLOSE:
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tSlave %d: Received << E_MSG_CLOSE [%s:%d]\n",
+				pSession->uSlaveId, __FILENAME__, __LINE__);
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tSlave %d: Send >> E_MSG_ACK [%s:%d]\n",
+				pSession->uSlaveId, __FILENAME__, __LINE__);
+			Send.eMsgType = E_MSG_ACK;
+			sendMessage(&pSession->Link, &Send);
+			flushMessages(&pSession->Link);
+
+			pSession->eState = E_CLOSE_FRAMEWOERK;
+			closeSession(pSession, false);
+		break;
 	}
-	else
+}
+
+
+/**=============================================================================
+
+	Function Name   : assignSlaveId
+    Description     : Function to give an id to a slave saying hello. The id
+    				  asked by the slave is given if no other slave has it,
+    				  a slave asking 0 gets the lowest free id.
+    Arguments       :
+                      Name              Dir     Description
+                      @uRequestedId     In      Id asked by the slave
+
+    Returns         : Id of the slave, 0 if the id is in use
+
+  ============================================================================*/
+
+static unsigned int assignSlaveId(unsigned int uRequestedId)
+{
+	unsigned int uSlaveId = 0, uSlot = 0;
+	bool bInUse = false;
+
+	for (uSlaveId = (uRequestedId != 0) ? uRequestedId : 1;
+		uSlaveId <= FW_MAX_SLAVE_ID; uSlaveId++)
 	{
-		pthread_exit(NULL);
+		bInUse = false;
+		for (uSlot = 0; uSlot < FW_MAX_SLAVES; uSlot++)
+		{
+			if (aSession[uSlot].bInUse &&
+				(aSession[uSlot].uSlaveId == uSlaveId))
+			{
+				bInUse = true;
+				break;
+			}
+		}
+
+		if (!bInUse)
+		{
+			return uSlaveId;
+		}
+
+		if (uRequestedId != 0)
+		{
+			break;
+		}
 	}
+
+	return 0;
 }
 
 
 /**=============================================================================
 
-	Function Name   : initialHandshake
-    Description     : This function is used to do initial handshaking with
-    				  slave machine and also to initialize the test framework
+	Function Name   : initializeSession
+    Description     : This function is used to initialize the test framework
     				  (loading shared object, adding test suites and test cases
-    				  to list, allocating memory to store test summary).
-    Arguments       : None
+    				  to list, allocating memory to store test summary) for the
+    				  first slave and to start the test execution process of
+    				  the session. Later slaves share the framework. The
+    				  coordinator splits the cases in shards instead.
+    Arguments       :
+                      Name              Dir     Description
+                      @pSession         In      Session of the slave
+
     Returns         : None
 
   ============================================================================*/
 
-static void initialHandshake(void)
+static void initializeSession(sSlaveSession_t *pSession)
 {
-	int nDataAvailable = 0, nRet = 0;
-	sHandshakeMsg_t Send;
+	if (!bFrameworkLoaded)
+	{
+		bFrameworkLoaded = true;
+		eFrameworkStatus = ((initializeTestFramework() == 0) &&
+			(!g_bCoordinator || (shardPlan(g_uMasterSlaves) == 0))) ?
+			E_PASSED : E_FAILED;
+
+		/* Makespan of the shards starts with the first slave */
+		if (g_bCoordinator && (eFrameworkStatus == E_PASSED))
+		{
+			scheduleStart();
+		}
+	}
 
-	while(1)
+	pSession->eExecutionStatus = eFrameworkStatus;
+	if (eFrameworkStatus != E_PASSED)
 	{
-		memset(&Send, 0, sizeof(Send));
+		return;
+	}
+
+	/* Coordinator only hands out the cases, nothing is executed here */
+	if (g_bCoordinator)
+	{
+		pSession->eState = E_FRAMEWORK_INITIALIZED;
+		return;
+	}
+
+	/* Test execution process and its test timer */
+	if (watchdogInit(&pSession->Watchdog, exitHandler, pSession) == -1)
+	{
+		freeMemory(1);
+	}
+
+	pSession->Channel.uResultBase =
+		pSession->uSlot * g_Registry.uNumberOfCases;
+	pSession->Channel.uSlot = pSession->uSlot;
+	clockSyncReset(pSession->uSlot);
+	pSession->bExecutorStarted = true;
+	pSession->eState = E_FRAMEWORK_INITIALIZED;
+
+	forkChildProcess(pSession);
+}
+
+
+/**=============================================================================
+
+	Function Name   : recordTestResult
+    Description     : Function to take the result of a test case settled by
+    				  the slave. The coordinator keeps it for the merged
+    				  report, a master only logs it.
+    Arguments       :
+                      Name              Dir     Description
+                      @pSession         In      Session of the slave
+                      @pReceived        In      Test result received
+
+    Returns         : None
+
+  ============================================================================*/
+
+static void recordTestResult(sSlaveSession_t *pSession,
+    sHandshakeMsg_t *pReceived)
+{
+	unsigned char *pPayload = pReceived->pPayload;
+	uint64_t uElapsedNs = 0;
+	int nCase = -1, i = 0;
+
+	nCase = (pReceived->Msg.uTestId < pSession->uTestIds) ?
+		pSession->pnTestIdCase[pReceived->Msg.uTestId] : -1;
+	if ((nCase == -1) || (pReceived->uPayloadLength < FW_TST_RESULT_LEN))
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tSlave %d: Received << E_MSG_TST_RESULT %u unknown [%s:%d]\n",
+			pSession->uSlaveId, pReceived->Msg.uTestId,
+			__FILENAME__, __LINE__);
+		return;
+	}
+
+	for (i = FW_TST_RESULT_LEN - 1; i > 0; i--)
+	{
+		uElapsedNs = (uElapsedNs << 8) | pPayload[i];
+	}
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tSlave %d: Received << E_MSG_TST_RESULT %s %d [%s:%d]\n",
+		pSession->uSlaveId, g_Registry.pszCaseName[nCase], pPayload[0],
+		__FILENAME__, __LINE__);
+
+	if (g_bCoordinator)
+	{
+		g_Registry.peStatus[nCase] = pPayload[0];
+		g_Registry.pdElapsedTime[nCase] =
+			(double)uElapsedNs / WATCHDOG_NSEC_PER_SEC;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : addTestId
+    Description     : Function to give the next test id to a case record of
+    				  the manifest.
+    Arguments       :
+                      Name              Dir     Description
+                      @pSession         In      Session of the slave
+                      @nCase            In      Case index, -1 if not found
+
+    Returns         : None
+
+  ============================================================================*/
+
+static void addTestId(sSlaveSession_t *pSession, int nCase)
+{
+	int *pnGrown = NULL;
 
-		switch(ReceivedMsg.eMsgType)
+	if (pSession->uTestIds == pSession->uTestIdCapacity)
+	{
+		pSession->uTestIdCapacity = (pSession->uTestIdCapacity == 0) ?
+			g_Registry.uNumberOfCases + 1 : pSession->uTestIdCapacity * 2;
+		pnGrown = realloc(pSession->pnTestIdCase,
+			pSession->uTestIdCapacity * sizeof(int));
+		if (pnGrown == NULL)
 		{
-			case E_MSG_HELLO:
+			deviceDrvTstFWDebug(LOG_TO_USR,
+				"No memory to map the test ids of slave %d\n",
+				pSession->uSlaveId);
+			freeMemory(1);
+		}
+		pSession->pnTestIdCase = pnGrown;
+	}
 
-				deviceDrvTstFWDebug(LOG_TO_DBG,
-					"\tReceived << E_MSG_HELLO [%s:%d]\n",
-					__FILENAME__, __LINE__);
+	pSession->pnTestIdCase[pSession->uTestIds++] = nCase;
+}
 
-				deviceDrvTstFWDebug(LOG_TO_DBG,
-					"\tSend >> E_MSG_ACK [%s:%d]\n",
-					__FILENAME__, __LINE__);
 
-				Send.eMsgType = E_MSG_ACK;
-				eMasterStateMachine = E_HELLO_RCVD;
-				sendMessage(&Send);
-				memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
-			break;
+/**=============================================================================
 
-			case E_MSG_FRAMEWORK_INIT:
-				deviceDrvTstFWDebug(LOG_TO_DBG,
-					"\tReceived << E_MSG_FRAMEWORK_INIT [%s:%d]\n",
-					__FILENAME__, __LINE__);
-				if (eMasterStateMachine != E_HELLO_RCVD)
-				{
-					deviceDrvTstFWDebug(LOG_TO_DBG,
-						"\tSend >> E_MSG_NACK [%s:%d]\n",
-						__FILENAME__, __LINE__);
-					Send.eMsgType = E_MSG_NACK;
-					sendMessage(&Send);
-				}
-				else
-				{
-					g_eExecutionStatus = E_RUNNING;
-					deviceDrvTstFWDebug(LOG_TO_DBG,
-						"\tSend >> E_MSG_ACK [%s:%d]\n",
-						__FILENAME__, __LINE__);
-					Send.eMsgType = E_MSG_ACK;
-					sendMessage(&Send);
-
-					nRet = initializeTestFramework();
-					if (nRet==0)
-                    {
-                        g_eExecutionStatus = E_PASSED;
-                        eMasterStateMachine = E_FRAMEWORK_INITIALIZED;
-                    }
-                    else
-                    {
-                        g_eExecutionStatus = E_FAILED;
-                    }
-				}
-				memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
-			break;
+	Function Name   : resolveManifest
+    Description     : Function to look up every suite and case record of a
+    				  manifest chunk in the list and to build the found/not-found
+    				  bitmap in szManifestResult. Bit n belongs to record n, a
+    				  case record is looked up in the last suite record and
+    				  gets the next test id of the session. A case of another
+    				  shard is not found for the slave of a coordinator.
+    Arguments       :
+                      Name              Dir     Description
+                      @pSession         In      Session of the slave
+                      @pRecords         In      Manifest records
+                      @uLength          In      Length of the records
 
-			case E_MSG_CLOSE:
-		        deviceDrvTstFWDebug(LOG_TO_USR,
-		        	"\tReceived << E_MSG_CLOSE [%s:%d]\n",
-		        	__FILENAME__, __LINE__);
+    Returns         : Length of the bitmap
 
-				deviceDrvTstFWDebug(LOG_TO_DBG, "\tSend >> E_MSG_ACK [%s:%d]\n",
-					__FILENAME__, __LINE__);
+  ============================================================================*/
 
-				Send.eMsgType = E_MSG_ACK;
-				sendMessage(&Send);
+static unsigned int resolveManifest(sSlaveSession_t *pSession,
+    unsigned char *pRecords, unsigned int uLength)
+{
+	unsigned char szName[30];
+	unsigned int uOffset = 0, uRecord = 0, uNameLength = 0;
+	int nRecordSuite = -1, nRecordCase = -1;
+	bool bFound = false;
 
-				eMasterStateMachine = E_CLOSE_FRAMEWOERK;
-				memset(&ReceivedMsg, 0, sizeof(ReceivedMsg));
+	memset(szManifestResult, 0, sizeof(szManifestResult));
+
+	while ((uOffset + 2) <= uLength)
+	{
+		uNameLength = pRecords[uOffset + 1];
+		if ((uNameLength >= sizeof(szName)) ||
+			((uOffset + 2 + uNameLength) > uLength))
+		{
 			break;
 		}
 
-		if((eMasterStateMachine == E_FRAMEWORK_INITIALIZED) ||
-			(eMasterStateMachine == E_CLOSE_FRAMEWOERK))
+		memset(szName, 0, sizeof(szName));
+		memcpy(szName, &pRecords[uOffset + 2], uNameLength);
+
+		if (pRecords[uOffset] == MANIFEST_SUITE_RECORD)
 		{
-			break;
+			nRecordSuite = findTestSuite(szName, uNameLength);
+			bFound = (nRecordSuite != -1);
+		}
+		else
+		{
+			nRecordCase = (nRecordSuite == -1) ? -1 :
+				findTestCase(nRecordSuite, szName, uNameLength);
+
+			/* Slave of the coordinator runs only the cases of its shard */
+			if (g_bCoordinator && (nRecordCase != -1) &&
+				(shardOfCase(nRecordCase) != pSession->uShard))
+			{
+				nRecordCase = -1;
+			}
+			bFound = (nRecordCase != -1);
+			addTestId(pSession, nRecordCase);
 		}
+
+		if (bFound)
+		{
+			szManifestResult[uRecord / 8] |= (1 << (uRecord % 8));
+		}
+
+		deviceDrvTstFWDebug(LOG_TO_DBG, "\t%s %s %s [%s:%d]\n",
+			(pRecords[uOffset] == MANIFEST_SUITE_RECORD) ? "Test suite" :
+			"Test case", szName, bFound ? "found" : "Not-found",
+			__FILENAME__, __LINE__);
+
+		uOffset += 2 + uNameLength;
+		uRecord++;
 	}
+
+	return (uRecord + 7) / 8;
 }
 
 
 /**=============================================================================
 
-	Function Name   : createTimer
-    Description     : This function is used to create a realtime timer and also
-    				  to register the realtime signal, which will be called when
-    				  timer expires.
-    Arguments       : None
+	Function Name   : forkChildProcess
+    Description     : This function is used to fork the child process which
+    				  executes the test cases of a session, connected to the
+    				  master thread through a new channel and tracked by the
+    				  watchdog of the session.
+    Arguments       :
+                      Name              Dir     Description
+                      @pSession         In      Session of the slave
     Returns         : None
 
   ============================================================================*/
 
-static void createTimer(void)
+static void forkChildProcess(sSlaveSession_t *pSession)
 {
-	struct sigevent sev;
-	struct sigaction sa;
-
-	memset(&sev, 0, sizeof(struct sigevent));
-	memset(&sa, 0, sizeof(struct sigaction));
-	/* Establish handler for timer signal */
-	sa.sa_flags = SA_SIGINFO;
-	sa.sa_sigaction = timerHandler;
-	sigemptyset(&sa.sa_mask);
-	if (sigaction(SIG, &sa, NULL) == -1)
-	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Error in registering signal\n");
+	pid_t nPid = 0;
+	unsigned int uSlot = 0;
+
+	if (channelCreate(&pSession->Channel) == -1)
+	{
 		freeMemory(1);
 	}
 
-    /* Create the timer */
-    sev.sigev_notify = SIGEV_SIGNAL;
-	sev.sigev_signo = SIG;
-	sev.sigev_value.sival_ptr = &g_timerId;
-	if(timer_create(CLOCK_REALTIME, &sev, &g_timerId) == -1)
+	/* Buffered output must not be inherited by the child */
+	fflush(NULL);
+
+	/* Create a child process */
+	nPid = fork();
+	if (nPid == 0)
 	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating timer\n");
+		/* A connection kept open by a child would hide the close from its
+		 * slave
+		 */
+		close(g_nMasterSockfd);
+		for (uSlot = 0; uSlot < FW_MAX_SLAVES; uSlot++)
+		{
+			if (aSession[uSlot].bInUse)
+			{
+				close(aSession[uSlot].Link.nSockfd);
+			}
+		}
+
+		executeTestCases(&pSession->Channel);
+	}
+	else if (nPid == -1)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"Error in creating test execution process\n");
 		freeMemory(1);
 	}
 
-	g_bTimerCreationFlag = true;
+	if ((watchdogAttach(&pSession->Watchdog, nPid) == -1) ||
+		(reactorAdd(pSession->Channel.nDoneFd, EPOLLIN, doneHandler,
+			pSession) == -1))
+	{
+		freeMemory(1);
+	}
 }
@@ -0,0 +1,485 @@
+/**=============================================================================
+  $Workfile: nameIndex.c$
+
+  File Description: Test name index. Suite and case names are fixed once the
+                    shared object is loaded, so a minimal perfect hash is
+                    built over them (hash and displace): the names are
+                    spread over buckets, and every bucket, largest first,
+                    gets the first seed which places all its names in free
+                    slots. A lookup hashes the name twice and compares one
+                    registry name. The tables are read-only once built and
+                    are shared with the forked test execution processes.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "deviceDrvTestFW.h"
+#include "nameIndex.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+/* Entry n < suites is suite n, else case n - suites. The scope of a suite
+ * is 0 and the scope of a case is its suite index + 1, so that the same
+ * case name in two suites gives two keys.
+ */
+static unsigned int g_uEntries;             /* Suites and cases indexed */
+static uint32_t *g_puSeed;                  /* Seed of a bucket */
+static uint32_t *g_puSlot;                  /* Entry of a slot */
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : nameHash
+    Description     : Function to hash a name and its scope with a seed, FNV-1a
+    				  followed by a final mix so that every bit of the result
+    				  depends on the seed.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uScope			In		Scope of the name
+                      @pszName			In		Name
+                      @uLength			In		Length of the name
+                      @uSeed			In		Seed
+    Returns         : Hash value
+
+  ============================================================================*/
+
+static uint32_t nameHash(uint32_t uScope, const unsigned char *pszName,
+    unsigned int uLength, uint32_t uSeed)
+{
+	uint32_t uHash = 2166136261U ^ (uSeed * 0x9E3779B9U);
+	unsigned int i = 0;
+
+	uHash = (uHash ^ uScope) * 16777619U;
+	for (i = 0; i < uLength; i++)
+	{
+		uHash = (uHash ^ pszName[i]) * 16777619U;
+	}
+
+	uHash ^= uHash >> 16;
+	uHash *= 0x85EBCA6BU;
+	uHash ^= uHash >> 13;
+	uHash *= 0xC2B2AE35U;
+	uHash ^= uHash >> 16;
+
+	return uHash;
+}
+
+
+/**=============================================================================
+
+	Function Name   : nameReduce
+    Description     : Function to map a hash value to [0, entries) with a
+    				  multiply instead of a division.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uHash			In		Hash value
+    Returns         : Bucket or slot
+
+  ============================================================================*/
+
+static inline uint32_t nameReduce(uint32_t uHash)
+{
+	return (uint32_t)(((uint64_t)uHash * g_uEntries) >> 32);
+}
+
+
+/**=============================================================================
+
+	Function Name   : nameText
+    Description     : Function to pass a registry name to the string
+    				  functions of the C library.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszName			In		Registry name
+    Returns         : Same name as char
+
+  ============================================================================*/
+
+static inline const char *nameText(const unsigned char *pszName)
+{
+	return (const char *)pszName;
+}
+
+
+/**=============================================================================
+
+	Function Name   : nameEntry
+    Description     : Function to get the scope and the registry name of an
+    				  entry.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uEntry			In		Entry
+                      @puScope			Out		Scope of the name
+    Returns         : Registry name
+
+  ============================================================================*/
+
+static const unsigned char *nameEntry(unsigned int uEntry, uint32_t *puScope)
+{
+	unsigned int uCase = 0;
+
+	if (uEntry < g_Registry.uNumberOfSuites)
+	{
+		*puScope = 0;
+		return g_Registry.pszSuiteName[uEntry];
+	}
+
+	uCase = uEntry - g_Registry.uNumberOfSuites;
+	*puScope = g_Registry.puSuite[uCase] + 1;
+	return g_Registry.pszCaseName[uCase];
+}
+
+
+/**=============================================================================
+
+	Function Name   : nameEntryHash
+    Description     : Function to hash the name of an entry with a seed.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uEntry			In		Entry
+                      @uSeed			In		Seed
+    Returns         : Hash value
+
+  ============================================================================*/
+
+static uint32_t nameEntryHash(unsigned int uEntry, uint32_t uSeed)
+{
+	const unsigned char *pszName = NULL;
+	uint32_t uScope = 0;
+
+	pszName = nameEntry(uEntry, &uScope);
+
+	return nameHash(uScope, pszName, strlen(nameText(pszName)), uSeed);
+}
+
+
+/**=============================================================================
+
+	Function Name   : nameEqual
+    Description     : Function to compare the names of two entries.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uEntry1			In		First entry
+                      @uEntry2			In		Second entry
+    Returns         : true if the scope and the name are the same
+
+  ============================================================================*/
+
+static bool nameEqual(unsigned int uEntry1, unsigned int uEntry2)
+{
+	const unsigned char *pszName1 = NULL, *pszName2 = NULL;
+	uint32_t uScope1 = 0, uScope2 = 0;
+
+	pszName1 = nameEntry(uEntry1, &uScope1);
+	pszName2 = nameEntry(uEntry2, &uScope2);
+
+	return (uScope1 == uScope2) &&
+		(strcmp(nameText(pszName1), nameText(pszName2)) == 0);
+}
+
+
+/**=============================================================================
+
+	Function Name   : namePlaceBucket
+    Description     : Function to find the seed which places all the entries
+    				  of a bucket in free slots, and to take the slots. A name
+    				  already in the bucket is left out, the first one keeps
+    				  the slot.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @puEntry			In		Entries of the bucket
+                      @uCount			In		Number of entries
+    Returns         : Seed, 0 if no seed was found
+
+  ============================================================================*/
+
+static uint32_t namePlaceBucket(uint32_t *puEntry, unsigned int uCount)
+{
+	uint32_t uSeed = 0, uSlot = 0;
+	unsigned int i = 0, j = 0;
+
+	/* Same names hash to the same bucket */
+	for (i = 1; i < uCount; i++)
+	{
+		for (j = 0; j < i; j++)
+		{
+			if ((puEntry[j] != NAME_INDEX_FREE) &&
+				nameEqual(puEntry[i], puEntry[j]))
+			{
+				deviceDrvTstFWDebug(LOG_TO_USR,
+					"Duplicate test name %s, only the first one is found\n",
+					nameEntry(puEntry[i], &uSlot));
+				puEntry[i] = NAME_INDEX_FREE;
+				break;
+			}
+		}
+	}
+
+	for (uSeed = 1; uSeed < NAME_INDEX_MAX_SEED; uSeed++)
+	{
+		for (i = 0; i < uCount; i++)
+		{
+			if (puEntry[i] == NAME_INDEX_FREE)
+			{
+				continue;
+			}
+
+			uSlot = nameReduce(nameEntryHash(puEntry[i], uSeed));
+			if (g_puSlot[uSlot] != NAME_INDEX_FREE)
+			{
+				break;
+			}
+			g_puSlot[uSlot] = puEntry[i];
+		}
+
+		if (i == uCount)
+		{
+			return uSeed;
+		}
+
+		/* Give back the slots taken with this seed */
+		while (i-- > 0)
+		{
+			if (puEntry[i] != NAME_INDEX_FREE)
+			{
+				g_puSlot[nameReduce(nameEntryHash(puEntry[i], uSeed))] =
+					NAME_INDEX_FREE;
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : nameIndexBuild
+    Description     : Function to build the perfect hash over the suite and
+    				  case names of the registry. Buckets are placed largest
+    				  first, while most of the slots are still free.
+    Arguments       : None
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int nameIndexBuild(void)
+{
+	uint32_t *puBucket = NULL, *puStart = NULL, *puOrder = NULL;
+	unsigned int uEntry = 0, uBucket = 0, uSize = 0, uMaxSize = 0;
+
+	g_uEntries = g_Registry.uNumberOfSuites + g_Registry.uNumberOfCases;
+	if (g_uEntries == 0)
+	{
+		return 0;
+	}
+
+	g_puSeed = calloc(2 * g_uEntries, sizeof(uint32_t));
+	puBucket = malloc((3 * g_uEntries + 1) * sizeof(uint32_t));
+	if ((g_puSeed == NULL) || (puBucket == NULL))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "No memory to index test names\n");
+		free(puBucket);
+		nameIndexFree();
+		return -1;
+	}
+
+	g_puSlot = g_puSeed + g_uEntries;
+	memset(g_puSlot, 0xFF, g_uEntries * sizeof(uint32_t));
+
+	puOrder = puBucket + g_uEntries;
+	puStart = puOrder + g_uEntries;
+	memset(puStart, 0, (g_uEntries + 1) * sizeof(uint32_t));
+
+	/* Entries grouped by bucket, puStart[b] is the first entry of bucket b
+	 * once every entry is placed from the end of its bucket.
+	 */
+	for (uEntry = 0; uEntry < g_uEntries; uEntry++)
+	{
+		puBucket[uEntry] = nameReduce(nameEntryHash(uEntry, 0));
+		puStart[puBucket[uEntry]]++;
+	}
+
+	for (uBucket = 0; uBucket < g_uEntries; uBucket++)
+	{
+		uMaxSize = (puStart[uBucket] > uMaxSize) ? puStart[uBucket] : uMaxSize;
+		puStart[uBucket] += (uBucket > 0) ? puStart[uBucket - 1] : 0;
+	}
+	puStart[g_uEntries] = g_uEntries;
+
+	for (uEntry = g_uEntries; uEntry-- > 0; )
+	{
+		puOrder[--puStart[puBucket[uEntry]]] = uEntry;
+	}
+
+	for (uSize = uMaxSize; uSize > 0; uSize--)
+	{
+		for (uBucket = 0; uBucket < g_uEntries; uBucket++)
+		{
+			if ((puStart[uBucket + 1] - puStart[uBucket]) != uSize)
+			{
+				continue;
+			}
+
+			g_puSeed[uBucket] = namePlaceBucket(&puOrder[puStart[uBucket]],
+				uSize);
+			if (g_puSeed[uBucket] == 0)
+			{
+				deviceDrvTstFWDebug(LOG_TO_USR,
+					"Test name index could not be built\n");
+				free(puBucket);
+				nameIndexFree();
+				return -1;
+			}
+		}
+	}
+
+	free(puBucket);
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tTest name index, %u names, largest bucket %u [%s:%d]\n",
+		g_uEntries, uMaxSize, __FILENAME__, __LINE__);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : nameIndexFind
+    Description     : Function to look a name up in the index.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uScope			In		Scope of the name
+                      @pszName			In		Name
+                      @uLength			In		Length of the name
+    Returns         : Entry, -1 if not found
+
+  ============================================================================*/
+
+static int nameIndexFind(uint32_t uScope, const unsigned char *pszName,
+    unsigned int uLength)
+{
+	const unsigned char *pszEntryName = NULL;
+	uint32_t uEntry = 0, uEntryScope = 0, uSeed = 0;
+
+	if ((g_uEntries == 0) || (uLength >= sizeof(g_Registry.pszCaseName[0])))
+	{
+		return -1;
+	}
+
+	uSeed = g_puSeed[nameReduce(nameHash(uScope, pszName, uLength, 0))];
+	uEntry = g_puSlot[nameReduce(nameHash(uScope, pszName, uLength, uSeed))];
+	if (uEntry == NAME_INDEX_FREE)
+	{
+		return -1;
+	}
+
+	/* Any name lands in a slot, the slot tells if it is the one */
+	pszEntryName = nameEntry(uEntry, &uEntryScope);
+	if ((uEntryScope != uScope) ||
+		(strncmp(nameText(pszEntryName), nameText(pszName), uLength) != 0) ||
+		(pszEntryName[uLength] != '\0'))
+	{
+		return -1;
+	}
+
+	return (int)uEntry;
+}
+
+
+/**=============================================================================
+
+    Function Name   : findTestSuite
+    Description     : Function to look a test suite up by name.
+    Arguments       :
+                      Name              Dir         Description
+                      @pszName          In          Test suite name
+                      @uNameLength      In          Length of the name
+
+    Returns         : Suite index, -1 if not found
+
+  ============================================================================*/
+
+int findTestSuite(const unsigned char *pszName, unsigned int uNameLength)
+{
+    return nameIndexFind(0, pszName, uNameLength);
+}
+
+
+/**=============================================================================
+
+    Function Name   : findTestCase
+    Description     : Function to look a test case of a suite up by name.
+    Arguments       :
+                      Name              Dir         Description
+                      @uSuite           In          Suite index
+                      @pszName          In          Test case name
+                      @uNameLength      In          Length of the name
+
+    Returns         : Case index, -1 if not found
+
+  ============================================================================*/
+
+int findTestCase(unsigned int uSuite, const unsigned char *pszName,
+    unsigned int uNameLength)
+{
+    int nEntry = -1;
+
+    if (uSuite >= g_Registry.uNumberOfSuites)
+    {
+        return -1;
+    }
+
+    nEntry = nameIndexFind(uSuite + 1, pszName, uNameLength);
+
+    return (nEntry == -1) ? -1 :
+        (nEntry - (int)g_Registry.uNumberOfSuites);
+}
+
+
+/**=============================================================================
+
+	Function Name   : nameIndexFree
+    Description     : Function to release the name index.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void nameIndexFree(void)
+{
+	free(g_puSeed);
+	g_puSeed = NULL;
+	g_puSlot = NULL;
+	g_uEntries = 0;
+}
@@ -0,0 +1,307 @@
+/**=============================================================================
+  $Workfile: reactor.c$
+
+  File Description: Epoll based event reactor. The mode state machines
+                    register the file descriptors they wait on along with a
+                    handler and block in reactorDispatch till one of them is
+                    ready, instead of polling with a select() timeout.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+
+#include "deviceDrvTestFW.h"
+#include "reactor.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*----------------- D A T A  S T R U C T U R E S  &  E N U M S ---------------*/
+
+/* Registered file descriptor */
+typedef struct event_handler
+{
+    int nFd;                                /* File descriptor - key */
+    pEventHandlerFuncPtr fnPtrHandler;      /* Handler called when ready */
+    void *pArg;                             /* Argument passed to handler */
+    bool bRemoved;                          /* Removed during dispatch */
+    UT_hash_handle hh;                      /* Hash table handle */
+}sEventHandler_t;
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+static int g_nEpollFd = -1;                 /* Epoll instance */
+static sEventHandler_t *g_pHandlerHead;     /* Registered handlers */
+static bool g_bDispatching;                 /* Set while handlers are called */
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : reactorInit
+    Description     : Function to create the epoll instance.
+    Arguments       : None
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int reactorInit(void)
+{
+	if (g_nEpollFd != -1)
+	{
+		return 0;
+	}
+
+	g_nEpollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (g_nEpollFd == -1)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating epoll instance\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : reactorAdd
+    Description     : Function to register a file descriptor and the handler
+    				  to be called when it is ready. Registration is level
+    				  triggered, a handler which does not consume the event is
+    				  called again on the next dispatch.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		File descriptor
+                      @uEvents			In		Epoll events to wait for
+                      @fnPtrHandler		In		Handler function
+                      @pArg				In		Argument passed to handler
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int reactorAdd(int nFd, uint32_t uEvents, pEventHandlerFuncPtr fnPtrHandler,
+    void *pArg)
+{
+	struct epoll_event Event;
+	sEventHandler_t *pHandler = NULL;
+
+	pHandler = malloc(sizeof(sEventHandler_t));
+	if (!pHandler)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "No memory to add event handler\n");
+		return -1;
+	}
+
+	memset(pHandler, 0, sizeof(sEventHandler_t));
+	pHandler->nFd = nFd;
+	pHandler->fnPtrHandler = fnPtrHandler;
+	pHandler->pArg = pArg;
+
+	memset(&Event, 0, sizeof(Event));
+	Event.events = uEvents;
+	Event.data.ptr = pHandler;
+
+	if (epoll_ctl(g_nEpollFd, EPOLL_CTL_ADD, nFd, &Event) == -1)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in adding fd %d to epoll\n",
+			nFd);
+		free(pHandler);
+		return -1;
+	}
+
+	HASH_ADD_INT(g_pHandlerHead, nFd, pHandler);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : reactorModify
+    Description     : Function to change the events a registered file
+    				  descriptor is waited for. With no events the handler is
+    				  only called on hang up or error.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		File descriptor
+                      @uEvents			In		Epoll events to wait for
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int reactorModify(int nFd, uint32_t uEvents)
+{
+	struct epoll_event Event;
+	sEventHandler_t *pHandler = NULL;
+
+	HASH_FIND_INT(g_pHandlerHead, &nFd, pHandler);
+	if (pHandler == NULL)
+	{
+		return -1;
+	}
+
+	memset(&Event, 0, sizeof(Event));
+	Event.events = uEvents;
+	Event.data.ptr = pHandler;
+
+	return epoll_ctl(g_nEpollFd, EPOLL_CTL_MOD, nFd, &Event);
+}
+
+
+/**=============================================================================
+
+	Function Name   : reactorRemove
+    Description     : Function to unregister a file descriptor. It has to be
+    				  called before the file descriptor is closed.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		File descriptor
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int reactorRemove(int nFd)
+{
+	sEventHandler_t *pHandler = NULL;
+
+	HASH_FIND_INT(g_pHandlerHead, &nFd, pHandler);
+	if (pHandler == NULL)
+	{
+		return -1;
+	}
+
+	epoll_ctl(g_nEpollFd, EPOLL_CTL_DEL, nFd, NULL);
+	HASH_DEL(g_pHandlerHead, pHandler);
+
+	/* Events of this dispatch may still point to the handler */
+	if (g_bDispatching)
+	{
+		pHandler->bRemoved = true;
+		pHandler->nFd = -1;
+	}
+	else
+	{
+		free(pHandler);
+	}
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : reactorDispatch
+    Description     : Function to wait till one of the registered file
+    				  descriptors is ready and to call its handler.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nTimeoutMs		In		Timeout, REACTOR_WAIT_FOREVER
+                      					 		to block till an event arrives
+                      @nMaxEvents		In		Maximum number of events to
+                      							handle in this call
+    Returns         : Number of events handled, -1 ON FAILURE
+
+  ============================================================================*/
+
+int reactorDispatch(int nTimeoutMs, int nMaxEvents)
+{
+	struct epoll_event Events[REACTOR_MAX_EVENTS];
+	sEventHandler_t *pHandler = NULL;
+	int nReady = 0, i = 0;
+
+	if (nMaxEvents > REACTOR_MAX_EVENTS)
+	{
+		nMaxEvents = REACTOR_MAX_EVENTS;
+	}
+
+	nReady = epoll_wait(g_nEpollFd, Events, nMaxEvents, nTimeoutMs);
+	if (nReady == -1)
+	{
+		/* Interrupted by a signal, caller will dispatch again */
+		return (errno == EINTR) ? 0 : -1;
+	}
+
+	g_bDispatching = true;
+	for (i = 0; i < nReady; i++)
+	{
+		pHandler = Events[i].data.ptr;
+		if (!pHandler->bRemoved)
+		{
+			pHandler->fnPtrHandler(pHandler->nFd, Events[i].events,
+				pHandler->pArg);
+		}
+	}
+	g_bDispatching = false;
+
+	/* Release the handlers removed by the called handlers */
+	for (i = 0; i < nReady; i++)
+	{
+		pHandler = Events[i].data.ptr;
+		if (pHandler != NULL && pHandler->bRemoved)
+		{
+			free(pHandler);
+
+			/* Same handler may be reported only once per epoll_wait */
+			Events[i].data.ptr = NULL;
+		}
+	}
+
+	return nReady;
+}
+
+
+/**=============================================================================
+
+	Function Name   : reactorClose
+    Description     : Function to unregister all the file descriptors and to
+    				  close the epoll instance. Forked child processes call it
+    				  to drop the inherited instance.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void reactorClose(void)
+{
+	sEventHandler_t *pHandler = NULL, *pTemp = NULL;
+
+	HASH_ITER(hh, g_pHandlerHead, pHandler, pTemp)
+	{
+		HASH_DEL(g_pHandlerHead, pHandler);
+		free(pHandler);
+	}
+
+	if (g_nEpollFd != -1)
+	{
+		close(g_nEpollFd);
+		g_nEpollFd = -1;
+	}
+}
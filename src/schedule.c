@@ -0,0 +1,641 @@
+/**=============================================================================
+  $Workfile: schedule.c $
+
+  File Description: Duration aware scheduling. The durations of the test cases
+                    are kept in a small history file next to the reports, the
+                    cases of a parallel suite are ordered by the configured
+                    policy and the achieved makespan is compared with the
+                    ideal one.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "deviceDrvTestFW.h"
+#include "config.h"
+#include "nameIndex.h"
+#include "schedule.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+/* qsort comparator of case indexes */
+typedef int (*pCompareFuncPtr)(const void *, const void *);
+
+/* Scheduling order of the cases of a parallel suite (SCHEDULE_ORDER) */
+typedef struct schedule_policy
+{
+    const char *pszName;                    /* Configured name */
+    pCompareFuncPtr pfnCompare;             /* NULL keeps the registry order */
+}sSchedulePolicy_t;
+
+static int compareLongestFirst(const void *pLeft, const void *pRight);
+static int compareShortestFirst(const void *pLeft, const void *pRight);
+
+static const sSchedulePolicy_t aPolicy[] =
+{
+    { "LONGEST_FIRST",  compareLongestFirst },
+    { "SHORTEST_FIRST", compareShortestFirst },
+    { "REGISTRY",       NULL }
+};
+
+static double (*g_pdSample)[SCHEDULE_HISTORY_SAMPLES];
+                                            /* Durations of the last runs of
+                                               a case, oldest first */
+static unsigned char *g_puSamples;          /* Durations kept for a case */
+static double *g_pdEstimate;                /* Estimated seconds of a case */
+static unsigned int *g_puOrder;             /* Case at a scheduling position */
+
+static char *g_pszForeign;                  /* History lines of the cases of
+                                               other shared objects */
+static size_t g_uForeignLength;
+
+static struct timespec StartTime;           /* First case scheduled */
+static bool g_bStarted;
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : compareLongestFirst
+    Description     : qsort comparator, orders case indexes by estimated
+    				  duration, longest first, then by case index.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pLeft			In		Case index
+                      @pRight			In		Case index
+    Returns         : <0, 0, >0 as qsort expects
+
+  ============================================================================*/
+
+static int compareLongestFirst(const void *pLeft, const void *pRight)
+{
+	unsigned int uLeft = *(const unsigned int *)pLeft;
+	unsigned int uRight = *(const unsigned int *)pRight;
+
+	if (g_pdEstimate[uLeft] != g_pdEstimate[uRight])
+	{
+		return (g_pdEstimate[uLeft] < g_pdEstimate[uRight]) ? 1 : -1;
+	}
+
+	return (uLeft > uRight) - (uLeft < uRight);
+}
+
+
+/**=============================================================================
+
+	Function Name   : compareShortestFirst
+    Description     : qsort comparator, orders case indexes by estimated
+    				  duration, shortest first, then by case index.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pLeft			In		Case index
+                      @pRight			In		Case index
+    Returns         : <0, 0, >0 as qsort expects
+
+  ============================================================================*/
+
+static int compareShortestFirst(const void *pLeft, const void *pRight)
+{
+	unsigned int uLeft = *(const unsigned int *)pLeft;
+	unsigned int uRight = *(const unsigned int *)pRight;
+
+	if (g_pdEstimate[uLeft] != g_pdEstimate[uRight])
+	{
+		return (g_pdEstimate[uLeft] > g_pdEstimate[uRight]) ? 1 : -1;
+	}
+
+	return (uLeft > uRight) - (uLeft < uRight);
+}
+
+
+/**=============================================================================
+
+	Function Name   : keepForeignLine
+    Description     : Function to keep a history line of a test case not in
+    				  the registry, it is written back unchanged by
+    				  scheduleSave. The last line of the file may miss its
+    				  newline.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszLine			In		History line with its newline
+    Returns         : None
+
+  ============================================================================*/
+
+static void keepForeignLine(const char *pszLine)
+{
+	size_t uLength = strlen(pszLine);
+	char *pszForeign = realloc(g_pszForeign, g_uForeignLength + uLength + 2);
+
+	if (pszForeign == NULL)
+	{
+		return;
+	}
+
+	memcpy(pszForeign + g_uForeignLength, pszLine, uLength + 1);
+	g_pszForeign = pszForeign;
+	g_uForeignLength += uLength;
+
+	if ((uLength == 0) || (pszLine[uLength - 1] != '\n'))
+	{
+		g_pszForeign[g_uForeignLength++] = '\n';
+		g_pszForeign[g_uForeignLength] = '\0';
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : readHistoryLine
+    Description     : Function to take the durations of one history line for
+    				  its test case. Lines of the cases not in the registry are
+    				  kept for scheduleSave.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pszLine			In		History line
+    Returns         : None
+
+  ============================================================================*/
+
+static void readHistoryLine(char *pszLine)
+{
+	char *pszCase = NULL, *pszDuration = NULL, *pszEnd = NULL;
+	int nSuite = -1, nCase = -1;
+	double dDuration = 0;
+
+	if (pszLine[0] == '#')
+	{
+		return;
+	}
+
+	pszCase = strchr(pszLine, '\t');
+	pszDuration = (pszCase != NULL) ? strchr(pszCase + 1, '\t') : NULL;
+	if (pszDuration == NULL)
+	{
+		return;
+	}
+
+	nSuite = findTestSuite((unsigned char *)pszLine, pszCase - pszLine);
+	if (nSuite != -1)
+	{
+		nCase = findTestCase(nSuite, (unsigned char *)pszCase + 1,
+			pszDuration - pszCase - 1);
+	}
+
+	if (nCase == -1)
+	{
+		keepForeignLine(pszLine);
+		return;
+	}
+
+	g_puSamples[nCase] = 0;
+	for (pszDuration++; g_puSamples[nCase] < SCHEDULE_HISTORY_SAMPLES;
+		pszDuration = pszEnd)
+	{
+		dDuration = strtod(pszDuration, &pszEnd);
+		if ((pszEnd == pszDuration) || (dDuration < 0))
+		{
+			break;
+		}
+
+		g_pdSample[nCase][g_puSamples[nCase]++] = dDuration;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : getCaseDuration
+    Description     : Function to get how long a settled test case of this run
+    				  took. A case that timed out took its timeout, a case not
+    				  run has no duration.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uCase			In		Case index
+                      @pdDuration		Out		Duration in seconds
+    Returns         : true if the case has a duration
+
+  ============================================================================*/
+
+static bool getCaseDuration(unsigned int uCase, double *pdDuration)
+{
+	switch (g_Registry.peStatus[uCase])
+	{
+		case E_PASSED:
+		case E_FAILED:
+			*pdDuration = g_Registry.pdElapsedTime[uCase];
+		return true;
+
+		/* Timeout is in milliseconds */
+		case E_TIMEOUT:
+			*pdDuration = (double)g_Registry.puTimeout[uCase] / 1000;
+		return true;
+
+		default:
+		return false;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : scheduleLoad
+    Description     : Function to read the duration history, to estimate the
+    				  duration of every test case of the registry and to order
+    				  the cases of the parallel suites by the policy of
+    				  SCHEDULE_ORDER. The estimate is the mean of the kept
+    				  durations, else the timeout of the case. Serial suites
+    				  keep the order of the registry, their cases may depend on
+    				  it and their makespan does not.
+    Arguments       : None
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int scheduleLoad(void)
+{
+	unsigned int uCases = g_Registry.uNumberOfCases;
+	const sSchedulePolicy_t *pPolicy = &aPolicy[0];
+	const char *pszOrder = NULL;
+	unsigned int i = 0, uSample = 0, uSuite = 0, uKnown = 0;
+	FILE *pHistory = NULL;
+	char *pszLine = NULL;
+	size_t uLineSize = 0;
+
+	scheduleFree();
+
+	g_pdSample = calloc(uCases + 1, sizeof(*g_pdSample));
+	g_puSamples = calloc(uCases + 1, sizeof(unsigned char));
+	g_pdEstimate = calloc(uCases + 1, sizeof(double));
+	g_puOrder = calloc(uCases + 1, sizeof(unsigned int));
+
+	if ((g_pdSample == NULL) || (g_puSamples == NULL) ||
+		(g_pdEstimate == NULL) || (g_puOrder == NULL))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "No memory to schedule test cases\n");
+		scheduleFree();
+		return -1;
+	}
+
+	pHistory = fopen(SCHEDULE_HISTORY_FILE, "r");
+	if (pHistory != NULL)
+	{
+		while (getline(&pszLine, &uLineSize, pHistory) != -1)
+		{
+			readHistoryLine(pszLine);
+		}
+
+		free(pszLine);
+		fclose(pHistory);
+	}
+
+	for (i = 0; i < uCases; i++)
+	{
+		if (g_puSamples[i] > 0)
+		{
+			for (uSample = 0; uSample < g_puSamples[i]; uSample++)
+			{
+				g_pdEstimate[i] += g_pdSample[i][uSample];
+			}
+			g_pdEstimate[i] /= g_puSamples[i];
+			uKnown++;
+		}
+		/* Timeout is in milliseconds */
+		else
+		{
+			g_pdEstimate[i] = (double)g_Registry.puTimeout[i] / 1000;
+		}
+
+		g_puOrder[i] = i;
+	}
+	g_puOrder[uCases] = uCases;
+
+	pszOrder = configLookup("SCHEDULE_ORDER");
+	if (pszOrder == NULL)
+	{
+		pszOrder = SCHEDULE_DEFAULT_ORDER;
+	}
+
+	for (i = 0; i < sizeof(aPolicy) / sizeof(aPolicy[0]); i++)
+	{
+		if (strcmp(pszOrder, aPolicy[i].pszName) == 0)
+		{
+			pPolicy = &aPolicy[i];
+			break;
+		}
+	}
+
+	if (i == sizeof(aPolicy) / sizeof(aPolicy[0]))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"Unknown schedule order %s, using %s\n", pszOrder,
+			pPolicy->pszName);
+	}
+
+	for (uSuite = 0; uSuite < g_Registry.uNumberOfSuites; uSuite++)
+	{
+		if (g_Registry.pbParallel[uSuite] && (pPolicy->pfnCompare != NULL))
+		{
+			qsort(&g_puOrder[g_Registry.puFirstCase[uSuite]],
+				g_Registry.puCaseCount[uSuite], sizeof(unsigned int),
+				pPolicy->pfnCompare);
+		}
+	}
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tSchedule order %s, %d of %d durations from %s [%s:%d]\n",
+		pPolicy->pszName, uKnown, uCases, SCHEDULE_HISTORY_FILE,
+		__FILENAME__, __LINE__);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : scheduleEstimate
+    Description     : Function to get the estimated duration of a test case.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uCase			In		Case index
+    Returns         : Estimated duration in seconds
+
+  ============================================================================*/
+
+double scheduleEstimate(unsigned int uCase)
+{
+	return g_pdEstimate[uCase];
+}
+
+
+/**=============================================================================
+
+	Function Name   : scheduleHasHistory
+    Description     : Function to check if the estimate of a test case comes
+    				  from the duration history.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uCase			In		Case index
+    Returns         : true if the case ran before
+
+  ============================================================================*/
+
+bool scheduleHasHistory(unsigned int uCase)
+{
+	return (g_puSamples[uCase] > 0);
+}
+
+
+/**=============================================================================
+
+	Function Name   : scheduleCase
+    Description     : Function to get the test case to be run at a scheduling
+    				  position. Positions of a suite are the case indexes of
+    				  the suite, from puFirstCase to REGISTRY_SUITE_END.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uPosition		In		Scheduling position
+    Returns         : Case index
+
+  ============================================================================*/
+
+unsigned int scheduleCase(unsigned int uPosition)
+{
+	if ((g_puOrder == NULL) || (uPosition > g_Registry.uNumberOfCases))
+	{
+		return uPosition;
+	}
+
+	return g_puOrder[uPosition];
+}
+
+
+/**=============================================================================
+
+	Function Name   : scheduleStart
+    Description     : Function to mark the start of the test case execution,
+    				  the makespan is measured from here.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void scheduleStart(void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &StartTime);
+	g_bStarted = true;
+}
+
+
+/**=============================================================================
+
+	Function Name   : scheduleFinish
+    Description     : Function to compare the makespan, the time from
+    				  scheduleStart till all the cases are settled, with the
+    				  ideal one for the durations of this run. No order does
+    				  better than the serial cases one after the other followed
+    				  by the parallel cases spread evenly over the lanes, but
+    				  not shorter than the longest of them. Both are written in
+    				  the summary of the report.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uLanes			In		Cases run at the same time,
+                      						test execution processes or
+                      						slaves of the coordinator
+    Returns         : None
+
+  ============================================================================*/
+
+void scheduleFinish(unsigned int uLanes)
+{
+	struct timespec EndTime;
+	unsigned int uCase = 0;
+	double dDuration = 0, dSerial = 0, dParallel = 0, dLongest = 0;
+	double dMakespan = 0, dIdeal = 0;
+
+	if (!g_bStarted || (uLanes == 0))
+	{
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &EndTime);
+	dMakespan = (double)(EndTime.tv_sec - StartTime.tv_sec) +
+		(double)(EndTime.tv_nsec - StartTime.tv_nsec) / 1e9;
+
+	for (uCase = 0; uCase < g_Registry.uNumberOfCases; uCase++)
+	{
+		if (!getCaseDuration(uCase, &dDuration))
+		{
+			continue;
+		}
+
+		/* Shards run the cases of a serial suite on different slaves */
+		if (!g_bCoordinator &&
+			!g_Registry.pbParallel[g_Registry.puSuite[uCase]])
+		{
+			dSerial += dDuration;
+		}
+		else
+		{
+			dParallel += dDuration;
+			if (dDuration > dLongest)
+			{
+				dLongest = dDuration;
+			}
+		}
+	}
+
+	dIdeal = dSerial + ((dParallel / uLanes > dLongest) ?
+		dParallel / uLanes : dLongest);
+
+	deviceDrvTstFWDebug(LOG_TO_USR,
+		"Makespan %.3f s, ideal %.3f s on %d lanes\n", dMakespan, dIdeal,
+		uLanes);
+
+	if (g_pSummary != NULL)
+	{
+		g_pSummary->dMakespan = dMakespan;
+		g_pSummary->dIdealMakespan = dIdeal;
+	}
+
+	g_bStarted = false;
+}
+
+
+/**=============================================================================
+
+	Function Name   : scheduleSave
+    Description     : Function to add the durations of this run to the history
+    				  and to write it. The oldest duration of a case is dropped
+    				  once SCHEDULE_HISTORY_SAMPLES are kept. The history is
+    				  written to a file of the process and renamed, so a reader
+    				  never sees it half written.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void scheduleSave(void)
+{
+	char szTempFile[64];
+	FILE *pHistory = NULL;
+	unsigned int uCase = 0, uSample = 0;
+	double dDuration = 0;
+
+	if (g_pdSample == NULL)
+	{
+		return;
+	}
+
+	snprintf(szTempFile, sizeof(szTempFile), "%s.%d", SCHEDULE_HISTORY_FILE,
+		(int)getpid());
+
+	pHistory = fopen(szTempFile, "w");
+	if (pHistory == NULL)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in writing %s\n",
+			SCHEDULE_HISTORY_FILE);
+		return;
+	}
+
+	fprintf(pHistory, "# Suite\tCase\tDurations in seconds, newest last\n");
+	if (g_pszForeign != NULL)
+	{
+		fputs(g_pszForeign, pHistory);
+	}
+
+	for (uCase = 0; uCase < g_Registry.uNumberOfCases; uCase++)
+	{
+		if (getCaseDuration(uCase, &dDuration))
+		{
+			if (g_puSamples[uCase] == SCHEDULE_HISTORY_SAMPLES)
+			{
+				memmove(&g_pdSample[uCase][0], &g_pdSample[uCase][1],
+					(SCHEDULE_HISTORY_SAMPLES - 1) * sizeof(double));
+				g_puSamples[uCase]--;
+			}
+
+			g_pdSample[uCase][g_puSamples[uCase]++] = dDuration;
+		}
+
+		if (g_puSamples[uCase] == 0)
+		{
+			continue;
+		}
+
+		fprintf(pHistory, "%s\t%s\t",
+			g_Registry.pszSuiteName[g_Registry.puSuite[uCase]],
+			g_Registry.pszCaseName[uCase]);
+		for (uSample = 0; uSample < g_puSamples[uCase]; uSample++)
+		{
+			fprintf(pHistory, (uSample == 0) ? "%.6f" : " %.6f",
+				g_pdSample[uCase][uSample]);
+		}
+		fputc('\n', pHistory);
+	}
+
+	if ((fclose(pHistory) != 0) ||
+		(rename(szTempFile, SCHEDULE_HISTORY_FILE) != 0))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in writing %s\n",
+			SCHEDULE_HISTORY_FILE);
+		unlink(szTempFile);
+	}
+
+	/* Durations of this run are added once */
+	scheduleFree();
+}
+
+
+/**=============================================================================
+
+	Function Name   : scheduleFree
+    Description     : Function to release the duration history and the
+    				  scheduling order.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void scheduleFree(void)
+{
+	free(g_pdSample);
+	g_pdSample = NULL;
+	free(g_puSamples);
+	g_puSamples = NULL;
+	free(g_pdEstimate);
+	g_pdEstimate = NULL;
+	free(g_puOrder);
+	g_puOrder = NULL;
+	free(g_pszForeign);
+	g_pszForeign = NULL;
+	g_uForeignLength = 0;
+}
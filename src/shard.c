@@ -0,0 +1,253 @@
+/**=============================================================================
+  $Workfile: shard.c $
+
+  File Description: Coordinator test case sharding. The durations of the test
+                    cases are taken from the duration history, the cases are
+                    split in shards of about the same duration and the
+                    results reported by the slaves are merged in one report.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "deviceDrvTestFW.h"
+#include "schedule.h"
+#include "shard.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+static unsigned int *g_puCaseShard;         /* Shard of a case */
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : compareEstimate
+    Description     : qsort comparator, orders case indexes by estimated
+    				  duration, longest first, then by case index.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pLeft			In		Case index
+                      @pRight			In		Case index
+    Returns         : <0, 0, >0 as qsort expects
+
+  ============================================================================*/
+
+static int compareEstimate(const void *pLeft, const void *pRight)
+{
+	unsigned int uLeft = *(const unsigned int *)pLeft;
+	unsigned int uRight = *(const unsigned int *)pRight;
+
+	double dLeft = scheduleEstimate(uLeft);
+	double dRight = scheduleEstimate(uRight);
+
+	if (dLeft != dRight)
+	{
+		return (dLeft < dRight) ? 1 : -1;
+	}
+
+	return (uLeft > uRight) - (uLeft < uRight);
+}
+
+
+/**=============================================================================
+
+	Function Name   : shardPlan
+    Description     : Function to split the test cases of the registry in
+    				  shards of about the same duration, as estimated by
+    				  scheduleEstimate. The longest case is given first to the
+    				  shard with the least work (longest processing time
+    				  first).
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uShards			In		Number of shards
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int shardPlan(unsigned int uShards)
+{
+	unsigned int uCases = g_Registry.uNumberOfCases;
+	unsigned int *puOrder = NULL, *puShardCases = NULL;
+	unsigned int i = 0, uShard = 0, uLightest = 0, uKnown = 0;
+	double *pdLoad = NULL;
+	double dTotal = 0, dLongest = 0, dEstimate = 0;
+
+	shardFree();
+
+	g_puCaseShard = calloc(uCases + 1, sizeof(unsigned int));
+	puOrder = calloc(uCases + 1, sizeof(unsigned int));
+	pdLoad = calloc(uShards, sizeof(double));
+	puShardCases = calloc(uShards, sizeof(unsigned int));
+
+	if ((g_puCaseShard == NULL) || (puOrder == NULL) || (pdLoad == NULL) ||
+		(puShardCases == NULL))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "No memory to split the test cases\n");
+		free(puOrder);
+		free(pdLoad);
+		free(puShardCases);
+		shardFree();
+		return -1;
+	}
+
+	for (i = 0; i < uCases; i++)
+	{
+		if (scheduleHasHistory(i))
+		{
+			uKnown++;
+		}
+
+		/* Cases are not run till a slave reports their result */
+		g_Registry.peStatus[i] = E_NOT_FOUND;
+		g_Registry.pdElapsedTime[i] = 0;
+		puOrder[i] = i;
+	}
+
+	qsort(puOrder, uCases, sizeof(unsigned int), compareEstimate);
+
+	for (i = 0; i < uCases; i++)
+	{
+		uLightest = 0;
+		for (uShard = 1; uShard < uShards; uShard++)
+		{
+			if (pdLoad[uShard] < pdLoad[uLightest])
+			{
+				uLightest = uShard;
+			}
+		}
+
+		dEstimate = scheduleEstimate(puOrder[i]);
+		g_puCaseShard[puOrder[i]] = uLightest;
+		pdLoad[uLightest] += dEstimate;
+		puShardCases[uLightest]++;
+		dTotal += dEstimate;
+	}
+
+	for (uShard = 0; uShard < uShards; uShard++)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tShard %d, %d cases, estimated %.3f s [%s:%d]\n", uShard,
+			puShardCases[uShard], pdLoad[uShard], __FILENAME__, __LINE__);
+
+		if (pdLoad[uShard] > dLongest)
+		{
+			dLongest = pdLoad[uShard];
+		}
+	}
+
+	deviceDrvTstFWDebug(LOG_TO_USR,
+		"Test cases split in %d shards, %d of %d durations from history, "
+		"longest shard %.3f s of %.3f s\n", uShards, uKnown, uCases,
+		dLongest, dTotal);
+
+	free(puOrder);
+	free(pdLoad);
+	free(puShardCases);
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : shardOfCase
+    Description     : Function to get the shard a test case is given to.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uCase			In		Case index
+    Returns         : Shard of the case
+
+  ============================================================================*/
+
+unsigned int shardOfCase(unsigned int uCase)
+{
+	return g_puCaseShard[uCase];
+}
+
+
+/**=============================================================================
+
+	Function Name   : shardWriteReport
+    Description     : Function to write the results reported by the slaves of
+    				  all the shards in one report, in the order of the
+    				  registry. A case whose result was not reported, because
+    				  its slave was lost, is reported not found.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void shardWriteReport(void)
+{
+	unsigned int uCase = 0;
+
+	openXMLReport();
+
+	for (uCase = 0; uCase < g_Registry.uNumberOfCases; uCase++)
+	{
+		switch (g_Registry.peStatus[uCase])
+		{
+			case E_PASSED:
+				g_pSummary->uNumberOfTestsPassed++;
+			break;
+
+			case E_FAILED:
+				g_pSummary->uNumberOfTestsFailed++;
+			break;
+
+			case E_TIMEOUT:
+				g_pSummary->uNumberOfTestsTimeout++;
+			break;
+
+			default:
+				g_Registry.peStatus[uCase] = E_NOT_FOUND;
+				g_pSummary->uNumberOfTestsNotFound++;
+			break;
+		}
+
+		reportTestCase(uCase);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : shardFree
+    Description     : Function to release the shard plan.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void shardFree(void)
+{
+	free(g_puCaseShard);
+	g_puCaseShard = NULL;
+}
@@ -47,6 +47,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "deviceDrvTestFW.h"
 #include "testStruct.h"
 #include "console.h"
+#include "reactor.h"
+#include "watchdog.h"
+#include "arena.h"
+#include "schedule.h"
+#include "clockSync.h"
 
 #define LOG_TO_USR 		1
 #define LOG_TO_DBG  	2
@@ -54,28 +59,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define RET_SUCCESS		0
 #define RET_FAILURE	    -1
 
-#define SIG SIGRTMIN
-
 /*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
 
 typedef enum{
     E_NONE = 1,
     E_MSG_HELLO_SENT,
-    E_MSG_HELLO_ACK,
     E_MSG_FRAMEWORK_INIT_SENT,
-    E_MSG_FRAMEWORK_INIT_ACK,
     E_FRAMEWORK_INITIALIZED,
     E_FRAMEWORK_INIT_FAILED,
-    E_MSG_TST_SUITE_NAME_SENT,
-    E_MSG_TST_SUITE_NAME_ACK,
+    E_MSG_TST_MANIFEST_SENT,
+    E_TST_MANIFEST_RESOLVED,
     E_TST_SUITE_FOUND,
     E_MSG_TST_SUITE_LIST_COMPLETED_SENT,
-    E_MSG_TST_SUITE_LIST_COMPLETED_ACK,
-    E_MSG_TST_CASE_NAME_SENT,
-    E_MSG_TST_CASE_NAME_ACK,
     E_TST_CASE_FOUND,
-    E_MSG_TST_CASE_LIST_COMPLETED_SENT,
-    E_MSG_TST_CASE_LIST_COMPLETED_ACK,
     E_MSG_TST_RUN_SENT,
     E_MSG_TST_RUN_ACK,
     E_TST_CASE_EXECUTE,
@@ -89,629 +85,478 @@ typedef enum{
 E_SLAVE_STATE_MACHINE eSlaveStateMachine = E_NONE;
 E_SLAVE_STATE_MACHINE eCurrentStatus;
 
-sTestCase_t *pTestcase;
-sTestSuite_t *pSuite;
+static unsigned int uCurrentSuite;		/* Suite index being executed */
+static unsigned int uCurrentCase;		/* Case index being executed */
+static unsigned int uCurrentPosition;	/* Scheduling position of the case */
+
+/* Manifest cursor, next case to be sent and first case of last chunk */
+static unsigned int uManifestCase, uChunkCase;
+unsigned char szManifest[FW_MAX_PAYLOAD_LEN];
+
+/* Request sent to master, waiting for its reply */
+typedef struct pending_request
+{
+    E_MSG_TYPE eMsgType;                /* Type of the request */
+    unsigned short uSeqNo;              /* Sequence number of the request */
+    unsigned int uFirstCase;            /* Manifest chunk, first case */
+    unsigned int uEndCase;              /* Manifest chunk, case after last */
+    uint64_t uSentNs;                   /* Clock request, time it was sent */
+}sPendingRequest_t;
+
+/* Requests in flight, replies of master arrive in the same order */
+sPendingRequest_t aPendingRequest[FW_MAX_PIPELINE_WINDOW];
+unsigned int uPendingHead, uPendingCount;
+unsigned short uNextSeqNo = 1;
+sPendingRequest_t RepliedRequest;       /* Request answered by Receive */
+
+/* Test case result of both the machines */
+bool bStatusRequested, bLocalResult, bMasterResult;
+E_TST_STATUS eMasterStatus;
+
+/* Scheduled start of the current case, local, and start of master on its
+ * clock, 0 if the case is not scheduled
+ */
+static uint64_t uStartAtNs, uMasterStartedNs;
 
 pthread_t g_slaveMainThread;
 unsigned char szCurrentTestSuite[30];
 unsigned char szCurrentTestCase[30];
 
-extern pid_t cpid;
+extern sLink_t g_SlaveLink;
 sigset_t mask;
 
-int nCommChannel[2]; 				/* Socket Pair */
+static sTestChannel_t TestChannel;	/* Scheduled case, result */
+static sWatchdog_t TestWatchdog;	/* Child process and test timer */
 int nScreenCol = 0;
 
+static sHandshakeMsg_t Receive;		/* Message received from master */
+static uint64_t uReceivedNs;		/* Time Receive was taken */
+
 /*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
 
-static void timerHandler(int sig, siginfo_t *si, void *uc);
-static void childProcess(void);
+static void socketHandler(int nFd, uint32_t uEvents, void *pArg);
+static void completeTestCase(void);
+static void doneHandler(int nFd, uint32_t uEvents, void *pArg);
+static void exitHandler(sWatchdog_t *pWatchdog, int nStatus);
+static bool isWaitingForEvent(void);
+static bool isWindowOpen(void);
+static bool isClosing(void);
+static sPendingRequest_t *postRequest(sHandshakeMsg_t *pMsg);
+static void sendTestResult(unsigned int uCase);
+static void processReply(void);
 void *pSlaveMainThread(void *pFd);
 void defineSlaveStatus(E_TST_STATUS eReceivedStatus);
+static unsigned int buildManifest(void);
+static void applyManifestResult(sPendingRequest_t *pChunk,
+    unsigned char *pBitmap, unsigned int uLength);
 static void initialHandshake(void);
-static void createTimer(void);
+static void forkChildProcess(void);
+static void synchronizeClock(void);
+static unsigned int proposeStartTime(unsigned char *pPayload);
+static void measureStartSkew(void);
 
 
 /*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
 
 /**=============================================================================
 
-	Function Name   : timerHandler
-    Description     : This is the signal handler. It is called when the timer
-    				  expires and it also sends the SIGKILL to child process
-    				  created in slave thread.
+	Function Name   : socketHandler
+    Description     : This is the control socket event handler. It receives
+    				  the reply sent by master and matches it against the
+    				  oldest request in flight, the reply is consumed by the
+    				  state machine.
     Arguments       :
     				  Name            	Dir    	Description
-                      @sig  			In		Signal number
-                      @si				In		Signal information
-                      @uc				In		Pointer to ucontext_t
+                      @nFd  			In		Control socket
+                      @uEvents			In		Epoll events
+                      @pArg				In		Not used
     Returns         : None
 
   ============================================================================*/
 
-static void timerHandler(int sig, siginfo_t *si, void *uc)
+static void socketHandler(int nFd, uint32_t uEvents, void *pArg)
 {
-	kill(cpid, SIGUSR1);
-}
-
-
-/**=============================================================================
+	int nRet = 0;
 
-	Function Name   : initializeSlaveDevice
-    Description     : This function is used to create slave thread and to wait
-    				  on thread till it completes the execution.
-    Arguments       : None
-    Returns         : None
+	memset(&Receive, 0, sizeof(Receive));
 
-  ============================================================================*/
+	nRet = receiveMessage(&g_SlaveLink, &Receive);
 
-void initializeSlaveDevice(void)
-{
-	if (socketpair(AF_UNIX, SOCK_STREAM, 0, nCommChannel) == -1)
+	/* if socket is closed abruptly */
+	if (nRet == 0)
 	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating socketpair\n");
+		deviceDrvTstFWDebug(LOG_TO_USR, "Socket closed\n");
 		freeMemory(1);
 	}
 
-	/* Create a thread in parent process */
-	pthread_create(&g_slaveMainThread, NULL, pSlaveMainThread, NULL);
+	/* Rest of the reply is not received yet */
+	if (nRet < 0)
+	{
+		return;
+	}
 
-	pthread_join(g_slaveMainThread, NULL);
+	uReceivedNs = clockSyncNow();
+
+	/* Master answers the requests in order */
+	if ((uPendingCount == 0) ||
+		(Receive.uSeqNo != aPendingRequest[uPendingHead].uSeqNo))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"Unexpected reply, sequence number %d\n", Receive.uSeqNo);
+		freeMemory(1);
+	}
 
+	memcpy(&RepliedRequest, &aPendingRequest[uPendingHead],
+		sizeof(sPendingRequest_t));
+	uPendingHead = (uPendingHead + 1) % FW_MAX_PIPELINE_WINDOW;
+	uPendingCount--;
 }
 
 
 /**=============================================================================
 
-	Function Name   : childProcess
-    Description     : This function is used to execute the testcases scheduled
-    				  by the slave thread and send back the execution status to
-    				  slave thread.
+	Function Name   : completeTestCase
+    Description     : Function to stop the watchdog and to read the result of
+    				  the executed test case from the arena. A case without
+    				  result was ended by the termination of the child process,
+    				  it timed out if the watchdog expired, else it failed. The
+    				  test case is executed once the status of master is also
+    				  received.
     Arguments       : None
     Returns         : None
 
   ============================================================================*/
 
-static void childProcess(void)
+static void completeTestCase(void)
 {
-    int nRet=0, nErr = 0;
-    fd_set readset;
-    sInterProcessMsg_t ToParent;
+	E_TST_STATUS eStatus;
+	uint64_t uElapsedNs = 0;
 
-    E_TST_STATUS testStatus;
+	watchdogStop(&TestWatchdog);
 
-	/* Initialize time out struct for select() */
-    struct timeval Tv;
-    Tv.tv_sec = 0;
-    Tv.tv_usec = 10000;
+	if (!arenaCollect(uCurrentCase, &eStatus, &uElapsedNs, uCurrentCase))
+	{
+		eStatus = TestWatchdog.bExpired ? E_TIMEOUT : E_FAILED;
+	}
+	g_Registry.puHistogramSlot[uCurrentCase] = TestChannel.uSlot + 1;
 
-    while (1)
-    {
-		/* Initialize the set */
-        FD_ZERO(&readset);
-        FD_SET(nCommChannel[1], &readset);
-
-        /* Now, check for readability */
-        nErr = select(nCommChannel[1]+1, &readset, NULL, NULL, &Tv);
-        if (nErr > 0 && FD_ISSET(nCommChannel[1], &readset))
-        {
-        	/* Clear flags */
-            FD_CLR(nCommChannel[1], &readset);
-
-            /* Do a simple read on data */
-            memset(&ToParent,0,sizeof(ToParent));
-            read(nCommChannel[1], &ToParent, sizeof(ToParent));
-
-            switch (ToParent.nType)
-			{
-				/* Execute test case */
-				case 0x01:
-					pTestcase = ToParent.pTestcase;
-					pTestcase->eStatus = pTestcase->fnPtrTestCase();
-					memset(&ToParent,0,sizeof(ToParent));
-					ToParent.nType = E_TST_CASE_EXECUTED;
-					ToParent.eStatus = pTestcase->eStatus;
-					send(nCommChannel[1], &ToParent, sizeof(ToParent), 0);
-				break;
-			}
-		}
+	g_Registry.peStatus[uCurrentCase] = eStatus;
+	g_Registry.pdElapsedTime[uCurrentCase] =
+		(double)uElapsedNs / WATCHDOG_NSEC_PER_SEC;
+	bLocalResult = true;
+
+	if ((eSlaveStateMachine == E_TST_CASE_EXECUTE) && bMasterResult)
+	{
+		eSlaveStateMachine = E_TST_CASE_EXECUTED;
 	}
 }
 
 
 /**=============================================================================
 
-	Function Name   : pSlaveMainThread
-    Description     : This is a thread function. It is used to traverse over the
-    				  test suite and test case list and if the same test suite
-    				  and test case is found on master machine, it will be
-    				  scheduled to execute in child process.
-    Arguments       : None
+	Function Name   : doneHandler
+    Description     : This is the done eventfd handler. It is called when the
+    				  child process published the result of its test case in
+    				  the arena.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		Done eventfd
+                      @uEvents			In		Epoll events
+                      @pArg				In		Not used
     Returns         : None
 
   ============================================================================*/
 
-void *pSlaveMainThread(void *pFd)
+static void doneHandler(int nFd, uint32_t uEvents, void *pArg)
 {
-    int nDataAvailable =0, nRet = 0, nErr = 0;
-    bool bSend = false;
-    fd_set readset;
-	sInterProcessMsg_t ToChild;
-	sHandshakeMsg_t Receive, Send;
-
-	/* Initialize time out struct for select() */
-    struct timeval Tv;
-    Tv.tv_sec = 0;
-    Tv.tv_usec = 10000;
-
-	/* Send hello message and initialize test framework */
-	initialHandshake();
-
-	if (eSlaveStateMachine == E_FRAMEWORK_INITIALIZED)
+	if (channelDrain(&TestChannel) && TestWatchdog.bRunning)
 	{
-		createTimer();
-
-		bGenerateReport = true;
-
-		/* Create a child process */
-		cpid = fork();
-		if(cpid == 0)
-		{
-			childProcess();
-		}
-		else
-		{
-			while (1)
-			{
-				memset(&Receive, 0, sizeof(Receive));
-				memset(&Send, 0, sizeof(Send));
-				memset(&ToChild, 0, sizeof(ToChild));
+		completeTestCase();
+	}
+}
 
-				nDataAvailable = 0;
-				bSend = false;
 
-				/* Check if data available */
-				nDataAvailable = peek();
-				if (nDataAvailable == -1)
-				{
-					deviceDrvTstFWDebug(LOG_TO_USR, "Socket closed\n");
-					freeMemory(1);
-				}
+/**=============================================================================
 
-				/* Receive data if avaialble */
-				if ((nDataAvailable > 0) &&
-					(eSlaveStateMachine != E_MSG_CLOSE_ACK))
-				{
-					nRet = receiveMessage(&Receive);
+	Function Name   : exitHandler
+    Description     : This is the watchdog exit handler. It is called when the
+    				  child process terminated, the test case it was running is
+    				  completed from the arena and a new child process is
+    				  forked.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog of the child process
+                      @nStatus			In		Exit status of the process
+    Returns         : None
 
-					/* if socket is closed abruptly */
-					if(nRet == 0)
-					{
-						freeMemory(1);
-					}
-				}
+  ============================================================================*/
 
-				switch (eSlaveStateMachine)
-				{
-					case E_MSG_TST_SUITE_NAME_ACK:
-					case E_MSG_TST_CASE_NAME_ACK:
-					case E_TST_CASE_EXECUTED:
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tSend >> E_MSG_STATUS [%s:%d]\n",
-							__FILENAME__, __LINE__);
-						Send.eMsgType = E_MSG_STATUS;
-						eCurrentStatus = eSlaveStateMachine;
-						eSlaveStateMachine = E_MSG_STATUS_SENT;
-						bSend = true;
-					break;
+static void exitHandler(sWatchdog_t *pWatchdog, int nStatus)
+{
+	deviceDrvTstFWDebug(LOG_TO_USR,
+		"Test execution process terminated, restarting it\n");
 
-					case E_MSG_STATUS_SENT:
-						defineSlaveStatus(Receive.Msg.eStatus);
-					break;
+	if (pWatchdog->bRunning)
+	{
+		arenaSettle(uCurrentCase, &pWatchdog->ExitUsage);
+		completeTestCase();
+	}
 
-					case E_FRAMEWORK_INITIALIZED:
-						if (pSuite != NULL)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> Test suite name: %s [%s:%d]\n",
-								pSuite->szName, __FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_TST_SUITE_NAME;
-							strcpy(Send.Msg.szName, pSuite->szName);
-							strcpy(szCurrentTestSuite, pSuite->szName);
-							pTestcase = pSuite->sTestCaseList;
-							eSlaveStateMachine = E_MSG_TST_SUITE_NAME_SENT;
-							bSend = true;
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tSend >> E_MSG_TST_SUITE_LIST_COMPLETED [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_TST_SUITE_LIST_COMPLETED;
-							eSlaveStateMachine =
-								E_MSG_TST_SUITE_LIST_COMPLETED_SENT;
-							bSend = true;
-						}
-					break;
+	reactorRemove(TestChannel.nDoneFd);
+	channelClose(&TestChannel);
 
-					case E_TST_SUITE_FOUND:
-						if (pTestcase != NULL)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tSend >> Test case name: %s [%s:%d]\n",
-								pTestcase->szName, __FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_TST_CASE_NAME;
-							strcpy(Send.Msg.szName, pTestcase->szName);
-							strcpy(szCurrentTestCase, pTestcase->szName);
+	forkChildProcess();
+}
 
-							if (g_bConsoleInitialized)
-							nScreenCol =
-                            	fnAddTestNameToScreen(pTestcase->szName, 0,
-                            		TST_RUNNING);
 
-							eSlaveStateMachine = E_MSG_TST_CASE_NAME_SENT;
-							bSend = true;
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tSend >> E_MSG_TST_CASE_LIST_COMPLETED [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							Send.eMsgType = E_MSG_TST_CASE_LIST_COMPLETED;
-							eSlaveStateMachine =
-								E_MSG_TST_CASE_LIST_COMPLETED_SENT;
-							pSuite = pSuite->hh.next;
-							bSend = true;
-						}
-					break;
+/**=============================================================================
 
-					case E_TST_CASE_FOUND:
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tSend >> E_MSG_TST_RUN [%s:%d]\n",
-							__FILENAME__, __LINE__);
-						Send.eMsgType = E_MSG_TST_RUN;
-						eSlaveStateMachine = E_MSG_TST_RUN_SENT;
-						bSend = true;
-					break;
+	Function Name   : isWindowOpen
+    Description     : Function to check whether one more request can be sent
+    				  to master without waiting for a reply.
+    Arguments       : None
+    Returns         : true if the number of requests in flight is below the
+    				  pipeline window
 
-					case E_MSG_TST_RUN_ACK:
-						ToChild.nType = 0x01;
-						ToChild.pTestcase = pTestcase;
-						eSlaveStateMachine = E_TST_CASE_EXECUTE;
+  ============================================================================*/
 
-						send(nCommChannel[0], &ToChild,
-							sizeof(ToChild), 0);
-						checkTimer(&g_timerId, pTestcase->uTimeout, true);
+static bool isWindowOpen(void)
+{
+	return (uPendingCount < g_uPipelineWindow);
+}
 
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tTest case is running... [%s:%d]\n",
-							__FILENAME__, __LINE__);
 
-					break;
+/**=============================================================================
 
-					case E_MSG_TST_SUITE_NAME_SENT:
-					case E_MSG_TST_CASE_NAME_SENT:
-					case E_MSG_TST_SUITE_LIST_COMPLETED_SENT:
-					case E_MSG_TST_CASE_LIST_COMPLETED_SENT:
-					case E_MSG_TST_RUN_SENT:
-					case E_MSG_CLOSE_SENT:
-						if (Receive.eMsgType == E_MSG_ACK)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tReceived << E_MSG_ACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							if (eSlaveStateMachine == E_MSG_TST_SUITE_NAME_SENT)
-							{
-								eSlaveStateMachine = E_MSG_TST_SUITE_NAME_ACK;
-							}
-							else if (eSlaveStateMachine ==
-								E_MSG_TST_CASE_NAME_SENT)
-							{
-								eSlaveStateMachine = E_MSG_TST_CASE_NAME_ACK;
-							}
-							else if (eSlaveStateMachine == E_MSG_TST_RUN_SENT)
-							{
-								eSlaveStateMachine = E_MSG_TST_RUN_ACK;
-							}
-							else if (eSlaveStateMachine ==
-								E_MSG_TST_CASE_LIST_COMPLETED_SENT)
-							{
-								eSlaveStateMachine = E_FRAMEWORK_INITIALIZED;
-							}
-							else if (eSlaveStateMachine ==
-								E_MSG_TST_SUITE_LIST_COMPLETED_SENT)
-							{
-								eSlaveStateMachine =
-									E_MSG_TST_SUITE_LIST_COMPLETED_ACK;
-							}
-							else if (eSlaveStateMachine == E_MSG_CLOSE_SENT)
-							{
-								eSlaveStateMachine = E_MSG_CLOSE_ACK;
-							}
-						}
-						else if(Receive.eMsgType == E_MSG_NACK)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tReceived << E_MSG_NACK [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							eSlaveStateMachine = E_FRAMEWORK_INIT_FAILED;
-						}
-					break;
+	Function Name   : isClosing
+    Description     : Function to check whether the framework is being closed.
+    				  Replies to the requests sent before are then ignored.
+    Arguments       : None
+    Returns         : true if the framework is being closed
 
-					case E_MSG_TST_SUITE_LIST_COMPLETED_ACK:
-						eSlaveStateMachine = E_CLOSE_FRAMEWOERK;
-					break;
+  ============================================================================*/
 
-					case E_FRAMEWORK_INIT_FAILED:
-					case E_CLOSE_FRAMEWOERK:
-						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tSend >> E_MSG_CLOSE [%s:%d]\n",
-							__FILENAME__, __LINE__);
-						Send.eMsgType = E_MSG_CLOSE;
-						eSlaveStateMachine = E_MSG_CLOSE_SENT;
-						bSend = true;
-					break;
-				}
-				if(eSlaveStateMachine == E_MSG_CLOSE_ACK)
-				{
-					break;
-				}
-				if (bSend)
-				{
-					sendMessage(&Send);
-				}
+static bool isClosing(void)
+{
+	return ((eSlaveStateMachine == E_FRAMEWORK_INIT_FAILED) ||
+		(eSlaveStateMachine == E_CLOSE_FRAMEWOERK) ||
+		(eSlaveStateMachine == E_MSG_CLOSE_SENT) ||
+		(eSlaveStateMachine == E_MSG_CLOSE_ACK));
+}
 
-				/* Initialize the set */
-				FD_ZERO(&readset);
-				FD_SET(nCommChannel[0], &readset);
 
-				/* Now, check for readability */
-				nErr = select(nCommChannel[0]+1, &readset, NULL, NULL, &Tv);
-				if (nErr > 0 && FD_ISSET(nCommChannel[0], &readset))
-				{
-					/* Clear flags */
-					FD_CLR(nCommChannel[0], &readset);
+/**=============================================================================
 
-					memset(&ToChild, 0, sizeof(ToChild));
+	Function Name   : isWaitingForEvent
+    Description     : Function to check whether the state machine can move
+    				  only on a reply from master, a status from child process
+    				  or a timer expiry.
+    Arguments       : None
+    Returns         : true if the slave thread has to wait for an event
 
-					/* Do a simple read on data */
-					read(nCommChannel[0], &ToChild,
-						sizeof(ToChild));
+  ============================================================================*/
 
-					eSlaveStateMachine = ToChild.nType;
-					pTestcase->eStatus = ToChild.eStatus;
-				}
-			}
-		}
+static bool isWaitingForEvent(void)
+{
+	switch (eSlaveStateMachine)
+	{
+		/* Next request is sent as soon as the window allows */
+		case E_MSG_HELLO_SENT:
+		case E_MSG_FRAMEWORK_INIT_SENT:
+		case E_MSG_TST_SUITE_LIST_COMPLETED_SENT:
+		case E_FRAMEWORK_INIT_FAILED:
+		case E_CLOSE_FRAMEWOERK:
+			return !isWindowOpen();
+
+		case E_MSG_TST_RUN_SENT:
+		case E_TST_CASE_EXECUTE:
+			return (bStatusRequested || !isWindowOpen());
+
+		case E_MSG_TST_MANIFEST_SENT:
+		case E_MSG_STATUS_SENT:
+		case E_MSG_CLOSE_SENT:
+			return true;
+
+		default:
+			return false;
 	}
 }
 
 
 /**=============================================================================
 
-    Function Name   : defineSlaveStatus
-    Description     : Function to updates the machine state and status of
-    				  of execution based on the response received from the
-    				  master machine.
+	Function Name   : postRequest
+    Description     : Function to send a request to master without waiting
+    				  for the reply. The request is given the next sequence
+    				  number and queued till master answers it. Caller has to
+    				  check the window with isWindowOpen.
     Arguments       :
-                      Name                  Dir     Description
-                      @eReceivedStatus      In      Status received from master
-
-    Returns         : None
+    				  Name            	Dir    	Description
+                      @pMsg  			In		Request to be sent
+    Returns         : Queued request
 
   ============================================================================*/
 
-void defineSlaveStatus(E_TST_STATUS eReceivedStatus)
+static sPendingRequest_t *postRequest(sHandshakeMsg_t *pMsg)
 {
-	sHandshakeMsg_t Receive, Send;
-	memset(&Send,0,sizeof(Send));
+	sPendingRequest_t *pRequest = NULL;
 
-	if (eReceivedStatus == E_RUNNING)
-	{
-		deviceDrvTstFWDebug(LOG_TO_DBG,
-			"\tReceived << E_RUNNING [%s:%d]\n",
-			__FILENAME__, __LINE__);
-		deviceDrvTstFWDebug(LOG_TO_DBG,
-			"\tSend >> E_MSG_STATUS [%s:%d]\n",
-			__FILENAME__, __LINE__);
-		Send.eMsgType = E_MSG_STATUS;
-		sendMessage(&Send);
-	}
-    /* If test Suite found in master device */
-    if ((eReceivedStatus == E_FOUND) &&
-    	(eCurrentStatus == E_MSG_TST_SUITE_NAME_ACK))
-    {
-        deviceDrvTstFWDebug(LOG_TO_DBG,
-        	"\tTest suite %s found in master [%s:%d]\n",
-            szCurrentTestSuite, __FILENAME__, __LINE__);
-        pSuite->eStatus = E_FOUND;
-        eSlaveStateMachine = E_TST_SUITE_FOUND;
-    }
-    /* If test Suite not found in master device */
-    else if ((eReceivedStatus == E_NOT_FOUND) &&
-		(eCurrentStatus == E_MSG_TST_SUITE_NAME_ACK))
-    {
-        g_pSummary->uNumberOfSuitesNotFound++;
-        deviceDrvTstFWDebug(LOG_TO_DBG,
-        	"\tTest suite %s not found in master [%s:%d]\n",
-            szCurrentTestSuite, __FILENAME__, __LINE__);
-        pSuite->eStatus = E_NOT_FOUND;
-        pSuite = pSuite->hh.next;
-        eSlaveStateMachine = E_FRAMEWORK_INITIALIZED;
-    }
-    /* If test case found in master device */
-    else if ((eReceivedStatus == E_FOUND) &&
-    	(eCurrentStatus == E_MSG_TST_CASE_NAME_ACK))
-    {
-        deviceDrvTstFWDebug(LOG_TO_DBG,
-        	"\tTest case %s found in master [%s:%d]\n",
-            szCurrentTestCase, __FILENAME__, __LINE__);
-        pTestcase->eStatus = E_FOUND;
-        eSlaveStateMachine = E_TST_CASE_FOUND;
-    }
-    /* If test case not found in master */
-    else if ((eReceivedStatus == E_NOT_FOUND) &&
-    	(eCurrentStatus == E_MSG_TST_CASE_NAME_ACK))
-    {
-        g_pSummary->uNumberOfTestsNotFound++;
+	pRequest = &aPendingRequest[(uPendingHead + uPendingCount) %
+		FW_MAX_PIPELINE_WINDOW];
+	memset(pRequest, 0, sizeof(sPendingRequest_t));
+	pRequest->eMsgType = pMsg->eMsgType;
+	pRequest->uSeqNo = uNextSeqNo++;
+	uPendingCount++;
 
-        deviceDrvTstFWDebug(LOG_TO_DBG,
-        	"\tTest case %s not found in master [%s:%d]\n",
-            szCurrentTestCase, __FILENAME__, __LINE__);
+	pMsg->uSeqNo = pRequest->uSeqNo;
+	pMsg->uSlaveId = g_uSlaveId;
+	sendMessage(&g_SlaveLink, pMsg);
 
-        if (g_bConsoleInitialized)
-        	fnUpdateTstStatusToScreen(nScreenCol, 0, TST_ERROR);
+	return pRequest;
+}
 
-        pTestcase->eStatus = E_NOT_FOUND;
-        pTestcase = pTestcase->hh.next;
-        eSlaveStateMachine = E_TST_SUITE_FOUND;
-    }
-    /* If test case failed either in master/slave */
-    else if (((eReceivedStatus == E_FAILED) || (pTestcase->eStatus == E_FAILED))
-    	&& (eCurrentStatus == E_TST_CASE_EXECUTED))
-    {
-        deviceDrvTstFWDebug(LOG_TO_DBG,"\tTest case %s failed [%s:%d]\n",
-            szCurrentTestCase, __FILENAME__, __LINE__);
-        pTestcase->dElapsedTime = (pTestcase->uTimeout/1000) -
-			checkTimer(&g_timerId, pTestcase->uTimeout, false);
 
-		if (g_bConsoleInitialized)
-			fnUpdateTstStatusToScreen(nScreenCol,
-				pTestcase->dElapsedTime, TST_FAILED);
+/**=============================================================================
 
-        pTestcase->eStatus = E_FAILED;
-        g_pSummary->uNumberOfTestsFailed++;
-        pTestcase = pTestcase->hh.next;
-        eSlaveStateMachine = E_TST_SUITE_FOUND;
-    }
-    /* If test case timedout either in master/slave */
-    else if (((eReceivedStatus == E_TIMEOUT) ||
-    	(pTestcase->eStatus == E_TIMEOUT)) &&
-    	(eCurrentStatus == E_TST_CASE_EXECUTED))
-    {
-        deviceDrvTstFWDebug(LOG_TO_DBG,"\tTest case %s timeout [%s:%d]\n",
-            szCurrentTestCase, __FILENAME__, __LINE__);
+	Function Name   : sendTestResult
+    Description     : Function to send the result of a settled test case to
+    				  master. A coordinator merges the results of its slaves
+    				  in one report. Master does not answer it, so it is not
+    				  a request in flight and goes out with the next request.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @uCase			In		Case index
+    Returns         : None
 
-        if (g_bConsoleInitialized)
-			fnUpdateTstStatusToScreen(nScreenCol, 0, TST_TIMEOUT);
+  ============================================================================*/
 
-        pTestcase->eStatus = E_TIMEOUT;
-        g_pSummary->uNumberOfTestsTimeout++;
-        pTestcase = pTestcase->hh.next;
-        eSlaveStateMachine = E_TST_SUITE_FOUND;
-    }
-    /* If test case is passed on master as well as slave */
-    else if (((eReceivedStatus == E_PASSED) && (pTestcase->eStatus == E_PASSED))
-    	&& (eCurrentStatus == E_TST_CASE_EXECUTED))
-    {
+static void sendTestResult(unsigned int uCase)
+{
+	sHandshakeMsg_t Send;
+	unsigned char szResult[FW_TST_RESULT_LEN];
+	uint64_t uElapsedNs = 0;
+	int i = 0;
 
-        deviceDrvTstFWDebug(LOG_TO_DBG,"\tTest case %s passed [%s:%d]\n",
-            szCurrentTestCase, __FILENAME__, __LINE__);
-        pTestcase->dElapsedTime = (pTestcase->uTimeout/1000) -
-			checkTimer(&g_timerId, pTestcase->uTimeout, false);
+	uElapsedNs = (uint64_t)(g_Registry.pdElapsedTime[uCase] *
+		WATCHDOG_NSEC_PER_SEC);
 
-		if (g_bConsoleInitialized)
-			fnUpdateTstStatusToScreen(nScreenCol,
-				pTestcase->dElapsedTime, TST_PASSED);
+	szResult[0] = g_Registry.peStatus[uCase];
+	for (i = 1; i < FW_TST_RESULT_LEN; i++)
+	{
+		szResult[i] = (unsigned char)(uElapsedNs & 0xff);
+		uElapsedNs >>= 8;
+	}
 
-        pTestcase->eStatus = E_PASSED;
-        g_pSummary->uNumberOfTestsPassed++;
-        pTestcase = pTestcase->hh.next;
-        eSlaveStateMachine = E_TST_SUITE_FOUND;
-    }
+	memset(&Send, 0, sizeof(Send));
+	Send.uSlaveId = g_uSlaveId;
+	Send.eMsgType = E_MSG_TST_RESULT;
+	Send.Msg.uTestId = uCase;
+	Send.pPayload = szResult;
+	Send.uPayloadLength = FW_TST_RESULT_LEN;
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tSend >> E_MSG_TST_RESULT: %s [%s:%d]\n",
+		g_Registry.pszCaseName[uCase], __FILENAME__, __LINE__);
+	sendMessage(&g_SlaveLink, &Send);
 }
 
 
 /**=============================================================================
 
-	Function Name   : initialHandshake
-    Description     : This function is used to do initial handshaking with
-    				  master machine and also to initialize the test framework
-    				  (loading shared object, adding test suites and test cases
-    				  to list, allocating memory to store test summary).
+	Function Name   : processReply
+    Description     : Function to update the state machine with the reply
+    				  received from master for the request in RepliedRequest.
     Arguments       : None
     Returns         : None
 
   ============================================================================*/
 
-static void initialHandshake(void)
+static void processReply(void)
 {
-	int nDataAvailable =0, nRet = 0;
-	sHandshakeMsg_t Receive, Send;
+	sHandshakeMsg_t Send;
+	int i = 0;
 
-	while(1)
+	memset(&Send, 0, sizeof(Send));
+
+	if (Receive.eMsgType == E_MSG_NACK)
 	{
-		memset(&Receive, 0, sizeof(Receive));
-		memset(&Send, 0, sizeof(Send));
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tReceived << E_MSG_NACK [%s:%d]\n",
+			__FILENAME__, __LINE__);
+	}
+	else if (Receive.eMsgType == E_MSG_ACK)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tReceived << E_MSG_ACK [%s:%d]\n",
+			__FILENAME__, __LINE__);
+	}
 
-		nDataAvailable = 0;
+	/* Only the reply to close request matters while closing */
+	if (isClosing() && (RepliedRequest.eMsgType != E_MSG_CLOSE))
+	{
+		return;
+	}
 
-		/* Check if data available */
-		nDataAvailable = peek();
-		if (nDataAvailable == -1)
-		{
-			deviceDrvTstFWDebug(LOG_TO_USR, "Socket closed\n");
-			freeMemory(1);
-		}
+	switch (RepliedRequest.eMsgType)
+	{
+		case E_MSG_HELLO:
+			if (Receive.eMsgType != E_MSG_ACK)
+			{
+				deviceDrvTstFWDebug(LOG_TO_USR,
+					"Slave id %d refused by master\n", g_uSlaveId);
+				eSlaveStateMachine = E_CLOSE_FRAMEWOERK;
+			}
+			else
+			{
+				/* Master gives the id when the slave did not ask one */
+				g_uSlaveId = Receive.uSlaveId;
+				deviceDrvTstFWDebug(LOG_TO_DBG, "\tSlave id %d [%s:%d]\n",
+					g_uSlaveId, __FILENAME__, __LINE__);
+			}
+		break;
 
-		/* Receive data if avaialble */
-		if ((nDataAvailable > 0) && (eSlaveStateMachine != E_MSG_CLOSE_ACK))
-		{
-			receiveMessage(&Receive);
-		}
+		case E_MSG_FRAMEWORK_INIT:
+			if (Receive.eMsgType != E_MSG_ACK)
+			{
+				eSlaveStateMachine = E_CLOSE_FRAMEWOERK;
+			}
+			else if (initializeTestFramework() == 0)
+			{
+				uCurrentSuite = 0;
+				uManifestCase = 0;
+			}
+			else
+			{
+				eSlaveStateMachine = E_FRAMEWORK_INIT_FAILED;
+				deviceDrvTstFWDebug(LOG_TO_USR,
+					"\tTest framework initialization failed [%s:%d]\n",
+					__FILENAME__, __LINE__);
+			}
+		break;
 
-		switch (eSlaveStateMachine)
-		{
-			case E_NONE:
+		case E_MSG_STATUS:
+			if (Receive.Msg.eStatus == E_RUNNING)
+			{
 				deviceDrvTstFWDebug(LOG_TO_DBG,
-					"\tSend >> E_MSG_HELLO [%s:%d]\n", __FILENAME__, __LINE__);
-				Send.eMsgType = E_MSG_HELLO;
-				eSlaveStateMachine = E_MSG_HELLO_SENT;
-				sendMessage(&Send);
-			break;
-
-			case E_MSG_HELLO_ACK:
-		        deviceDrvTstFWDebug(LOG_TO_DBG,
-		        	"\tSend >> E_MSG_FRAMEWORK_INIT [%s:%d]\n",
-		        	__FILENAME__, __LINE__);
-		        Send.eMsgType = E_MSG_FRAMEWORK_INIT;
-		        eSlaveStateMachine = E_MSG_FRAMEWORK_INIT_SENT;
-		        sendMessage(&Send);
-            break;
-
-        	case E_MSG_FRAMEWORK_INIT_ACK:
-        		deviceDrvTstFWDebug(LOG_TO_DBG,
-        			"\tSend >> E_MSG_STATUS [%s:%d]\n", __FILENAME__, __LINE__);
-                Send.eMsgType = E_MSG_STATUS;
-                eCurrentStatus = eSlaveStateMachine;
-                eSlaveStateMachine = E_MSG_STATUS_SENT;
-                sendMessage(&Send);
-			break;
-
-			case E_MSG_STATUS_SENT:
-                if (Receive.Msg.eStatus == E_RUNNING)
-				{
-					deviceDrvTstFWDebug(LOG_TO_DBG,
-						"\tReceived << E_RUNNING [%s:%d]\n",
-						__FILENAME__, __LINE__);
-					deviceDrvTstFWDebug(LOG_TO_DBG,
-						"\tSend >> E_MSG_STATUS [%s:%d]\n",
-						__FILENAME__, __LINE__);
-					Send.eMsgType = E_MSG_STATUS;
-					sendMessage(&Send);
-				}
-				/* If test framework is initialized in master device */
-				else if (Receive.Msg.eStatus == E_PASSED &&
-					eCurrentStatus == E_MSG_FRAMEWORK_INIT_ACK)
+					"\tReceived << E_RUNNING [%s:%d]\n",
+					__FILENAME__, __LINE__);
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSend >> E_MSG_STATUS [%s:%d]\n",
+					__FILENAME__, __LINE__);
+				Send.eMsgType = E_MSG_STATUS;
+				postRequest(&Send);
+			}
+			/* Status of test framework initialization in master */
+			else if (eSlaveStateMachine == E_MSG_STATUS_SENT)
+			{
+				if (Receive.Msg.eStatus == E_PASSED)
 				{
 					deviceDrvTstFWDebug(LOG_TO_DBG,
 						"\tReceived << E_PASSED [%s:%d]\n",
 						__FILENAME__, __LINE__);
 					eSlaveStateMachine = E_FRAMEWORK_INITIALIZED;
 				}
-				/* If test framework is not initialized in master device */
-				else if (Receive.Msg.eStatus == E_FAILED &&
-					eCurrentStatus == E_MSG_FRAMEWORK_INIT_ACK)
+				else
 				{
 					deviceDrvTstFWDebug(LOG_TO_DBG,
 						"\tReceived << E_FAILED [%s:%d]\n",
@@ -720,107 +565,886 @@ static void initialHandshake(void)
 						"Test framework initialization failed in master\n");
 					eSlaveStateMachine = E_FRAMEWORK_INIT_FAILED;
 				}
-            break;
+			}
+			/* Status of test case execution in master */
+			else
+			{
+				eMasterStatus = Receive.Msg.eStatus;
+				bMasterResult = true;
 
-			case E_MSG_HELLO_SENT:
-			case E_MSG_FRAMEWORK_INIT_SENT:
-			case E_MSG_CLOSE_SENT:
-				if (Receive.eMsgType == E_MSG_ACK)
+				/* Start time of a case run at the scheduled time */
+				uMasterStartedNs = 0;
+				if (Receive.uPayloadLength >= FW_START_TIME_LEN)
 				{
-					deviceDrvTstFWDebug(LOG_TO_DBG,
-						"\tReceived << E_MSG_ACK [%s:%d]\n",
-						__FILENAME__, __LINE__);
-					if (eSlaveStateMachine == E_MSG_HELLO_SENT)
-                    {
-                        eSlaveStateMachine = E_MSG_HELLO_ACK;
-                    }
-                    else if (eSlaveStateMachine == E_MSG_FRAMEWORK_INIT_SENT)
-                    {
-                        nRet = initializeTestFramework();
-                        if (nRet == 0)
-                        {
-                            eSlaveStateMachine = E_MSG_FRAMEWORK_INIT_ACK;
-                            pSuite = g_pSuiteHead;
-                        }
-                        else
-                        {
-                            eSlaveStateMachine = E_FRAMEWORK_INIT_FAILED;
-                            deviceDrvTstFWDebug(LOG_TO_USR,
-							 "\tTest framework initialization failed [%s:%d]\n",
-								__FILENAME__, __LINE__);
-                        }
-                    }
-                    else if (eSlaveStateMachine == E_MSG_CLOSE_SENT)
-                    {
-                        eSlaveStateMachine = E_MSG_CLOSE_ACK;
-                    }
+					for (i = FW_START_TIME_LEN - 1; i >= 0; i--)
+					{
+						uMasterStartedNs = (uMasterStartedNs << 8) |
+							Receive.pPayload[i];
+					}
 				}
-				else if(Receive.eMsgType == E_MSG_NACK)
+
+				if ((eSlaveStateMachine == E_TST_CASE_EXECUTE) && bLocalResult)
 				{
+					eSlaveStateMachine = E_TST_CASE_EXECUTED;
+				}
+			}
+		break;
+
+		case E_MSG_TST_MANIFEST:
+			if (Receive.eMsgType == E_MSG_TST_MANIFEST_RSLT)
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tReceived << E_MSG_TST_MANIFEST_RSLT [%s:%d]\n",
+					__FILENAME__, __LINE__);
+				applyManifestResult(&RepliedRequest, Receive.pPayload,
+					Receive.uPayloadLength);
+				eSlaveStateMachine = E_FRAMEWORK_INITIALIZED;
+			}
+			else
+			{
+				eSlaveStateMachine = E_FRAMEWORK_INIT_FAILED;
+			}
+		break;
+
+		case E_MSG_TST_RUN:
+			if (Receive.eMsgType == E_MSG_ACK)
+			{
+				eSlaveStateMachine = E_MSG_TST_RUN_ACK;
+			}
+			else
+			{
+				eSlaveStateMachine = E_FRAMEWORK_INIT_FAILED;
+			}
+		break;
+
+		case E_MSG_TST_SUITE_LIST_COMPLETED:
+			if (Receive.eMsgType != E_MSG_ACK)
+			{
+				eSlaveStateMachine = E_CLOSE_FRAMEWOERK;
+			}
+		break;
+
+		case E_MSG_CLOSE:
+			eSlaveStateMachine = E_MSG_CLOSE_ACK;
+		break;
+
+		case E_MSG_CLOCK_SYNC:
+			if (Receive.eMsgType == E_MSG_CLOCK_SYNC)
+			{
+				clockSyncSample(RepliedRequest.uSentNs, Receive.pPayload,
+					Receive.uPayloadLength, uReceivedNs);
+			}
+		break;
+
+		default:
+		break;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : initializeSlaveDevice
+    Description     : This function is used to create slave thread and to wait
+    				  on thread till it completes the execution.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void initializeSlaveDevice(void)
+{
+	if ((reactorInit() == -1) ||
+		(reactorAdd(g_SlaveLink.nSockfd, EPOLLIN | EPOLLRDHUP, socketHandler,
+			NULL) == -1))
+	{
+		freeMemory(1);
+	}
+
+	/* Create a thread in parent process */
+	pthread_create(&g_slaveMainThread, NULL, pSlaveMainThread, NULL);
+
+	pthread_join(g_slaveMainThread, NULL);
+
+}
+
+
+/**=============================================================================
+
+	Function Name   : pSlaveMainThread
+    Description     : This is a thread function. It sends the test suite and
+    				  test case list to master machine as a manifest, then
+    				  traverses over the list and the test cases found on
+    				  master machine are scheduled to execute in child process,
+    				  in the order of scheduleCase.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void *pSlaveMainThread(void *pFd)
+{
+	sHandshakeMsg_t Send;
+	sPendingRequest_t *pRequest = NULL;
+	unsigned char szStartAt[FW_START_TIME_LEN];
+
+	/* Send hello message and initialize test framework */
+	initialHandshake();
+
+	if (eSlaveStateMachine == E_FRAMEWORK_INITIALIZED)
+	{
+		/* Test execution process and its test timer */
+		if (watchdogInit(&TestWatchdog, exitHandler, NULL) == -1)
+		{
+			freeMemory(1);
+		}
+
+		/* Results are appended to the report as they are settled */
+		openXMLReport();
+
+		forkChildProcess();
+
+		while (1)
+		{
+			memset(&Send, 0, sizeof(Send));
+
+			/* Reply from master is consumed first */
+			if (Receive.eMsgType != 0)
+			{
+				processReply();
+				memset(&Receive, 0, sizeof(Receive));
+			}
+
+			switch (eSlaveStateMachine)
+			{
+				case E_TST_CASE_EXECUTED:
+					measureStartSkew();
+					eCurrentStatus = eSlaveStateMachine;
+					defineSlaveStatus(eMasterStatus);
+					if (eSlaveStateMachine != E_TST_CASE_EXECUTED)
+					{
+						sendTestResult(uCurrentCase);
+					}
+				break;
+
+				case E_FRAMEWORK_INITIALIZED:
+					/* Chunks are sent without waiting for the result */
+					while ((uManifestCase < g_Registry.uNumberOfCases) &&
+						isWindowOpen())
+					{
+						Send.eMsgType = E_MSG_TST_MANIFEST;
+						Send.pPayload = szManifest;
+						Send.uPayloadLength = buildManifest();
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+							"\tSend >> E_MSG_TST_MANIFEST %d bytes [%s:%d]\n",
+							Send.uPayloadLength, __FILENAME__, __LINE__);
+
+						pRequest = postRequest(&Send);
+						pRequest->uFirstCase = uChunkCase;
+						pRequest->uEndCase = uManifestCase;
+					}
+
+					if ((uManifestCase < g_Registry.uNumberOfCases) ||
+						(uPendingCount > 0))
+					{
+						eSlaveStateMachine = E_MSG_TST_MANIFEST_SENT;
+					}
+					else
+					{
+						uCurrentSuite = 0;
+						eSlaveStateMachine = E_TST_MANIFEST_RESOLVED;
+						scheduleStart();
+					}
+				break;
+
+				case E_TST_MANIFEST_RESOLVED:
+					if (uCurrentSuite < g_Registry.uNumberOfSuites)
+					{
+						if (g_Registry.peSuiteStatus[uCurrentSuite] == E_FOUND)
+						{
+							deviceDrvTstFWDebug(LOG_TO_DBG,
+								"\tTest suite name: %s [%s:%d]\n",
+								g_Registry.pszSuiteName[uCurrentSuite],
+								__FILENAME__, __LINE__);
+							strcpy(szCurrentTestSuite,
+								g_Registry.pszSuiteName[uCurrentSuite]);
+							uCurrentPosition =
+								g_Registry.puFirstCase[uCurrentSuite];
+							eSlaveStateMachine = E_TST_SUITE_FOUND;
+						}
+						else
+						{
+							uCurrentSuite++;
+						}
+					}
+					else if (isWindowOpen())
+					{
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+						"\tSend >> E_MSG_TST_SUITE_LIST_COMPLETED [%s:%d]\n",
+							__FILENAME__, __LINE__);
+						Send.eMsgType = E_MSG_TST_SUITE_LIST_COMPLETED;
+						eSlaveStateMachine =
+							E_MSG_TST_SUITE_LIST_COMPLETED_SENT;
+						scheduleFinish(1);
+						postRequest(&Send);
+					}
+				break;
+
+				case E_TST_SUITE_FOUND:
+					if (uCurrentPosition < REGISTRY_SUITE_END(uCurrentSuite))
+					{
+						uCurrentCase = scheduleCase(uCurrentPosition);
+						strcpy(szCurrentTestCase,
+							g_Registry.pszCaseName[uCurrentCase]);
+
+						if (g_bConsoleInitialized)
+						nScreenCol =
+                            	fnAddTestNameToScreen(
+                            		g_Registry.pszCaseName[uCurrentCase], 0,
+                            		TST_RUNNING);
+
+						if (g_Registry.peStatus[uCurrentCase] == E_FOUND)
+						{
+							eSlaveStateMachine = E_TST_CASE_FOUND;
+						}
+						else
+						{
+							if (g_bConsoleInitialized)
+								fnUpdateTstStatusToScreen(nScreenCol, 0,
+									TST_ERROR);
+							uCurrentPosition++;
+						}
+					}
+					else
+					{
+						uCurrentSuite++;
+						eSlaveStateMachine = E_TST_MANIFEST_RESOLVED;
+					}
+				break;
+
+				case E_TST_CASE_FOUND:
+					/* Clock of master is estimated again between cases,
+					 * when master has nothing else to answer
+					 */
+					if ((uPendingCount == 0) && clockSyncDue())
+					{
+						synchronizeClock();
+					}
+
+					if (isWindowOpen())
+					{
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+							"\tSend >> E_MSG_TST_RUN: %s [%s:%d]\n",
+							g_Registry.pszCaseName[uCurrentCase],
+							__FILENAME__, __LINE__);
+						Send.eMsgType = E_MSG_TST_RUN;
+						Send.Msg.uTestId = uCurrentCase;
+						Send.pPayload = szStartAt;
+						Send.uPayloadLength = proposeStartTime(szStartAt);
+						eSlaveStateMachine = E_MSG_TST_RUN_SENT;
+						bStatusRequested = false;
+						bLocalResult = false;
+						bMasterResult = false;
+						postRequest(&Send);
+					}
+				break;
+
+				case E_MSG_TST_RUN_ACK:
+					eSlaveStateMachine = E_TST_CASE_EXECUTE;
+
+					watchdogStart(&TestWatchdog,
+						g_Registry.puTimeout[uCurrentCase]);
+					arenaSchedule(uCurrentCase, uStartAtNs);
+					channelPost(&TestChannel, uCurrentCase);
+
 					deviceDrvTstFWDebug(LOG_TO_DBG,
-						"\tReceived << E_MSG_NACK [%s:%d]\n",
+						"\tTest case is running... [%s:%d]\n",
 						__FILENAME__, __LINE__);
-					eSlaveStateMachine = E_CLOSE_FRAMEWOERK;
+				break;
+
+				/* Master replies to status once its test case is over,
+				 * so the status is requested along with the run.
+				 */
+				case E_MSG_TST_RUN_SENT:
+				case E_TST_CASE_EXECUTE:
+					if (!bStatusRequested && isWindowOpen())
+					{
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+							"\tSend >> E_MSG_STATUS [%s:%d]\n",
+							__FILENAME__, __LINE__);
+						Send.eMsgType = E_MSG_STATUS;
+						bStatusRequested = true;
+						postRequest(&Send);
+					}
+				break;
+
+				case E_MSG_TST_SUITE_LIST_COMPLETED_SENT:
+				case E_FRAMEWORK_INIT_FAILED:
+				case E_CLOSE_FRAMEWOERK:
+					if (isWindowOpen())
+					{
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+							"\tSend >> E_MSG_CLOSE [%s:%d]\n",
+							__FILENAME__, __LINE__);
+						Send.eMsgType = E_MSG_CLOSE;
+						eSlaveStateMachine = E_MSG_CLOSE_SENT;
+						postRequest(&Send);
+					}
+				break;
+			}
+
+			if(eSlaveStateMachine == E_MSG_CLOSE_ACK)
+			{
+				break;
+			}
+
+			/* Wait for master, child process or timer */
+			if (isWaitingForEvent())
+			{
+				if (flushMessages(&g_SlaveLink) == -1)
+				{
+					deviceDrvTstFWDebug(LOG_TO_USR, "Socket closed\n");
+					freeMemory(1);
 				}
+
+				if (isMessageBuffered(&g_SlaveLink))
+				{
+					socketHandler(g_SlaveLink.nSockfd, EPOLLIN, NULL);
+				}
+				else
+				{
+					reactorDispatch(REACTOR_WAIT_FOREVER, 1);
+				}
+			}
+		}
+	}
+}
+
+
+/**=============================================================================
+
+    Function Name   : defineSlaveStatus
+    Description     : Function to updates the machine state and status of
+    				  of execution based on the response received from the
+    				  master machine.
+    Arguments       :
+                      Name                  Dir     Description
+                      @eReceivedStatus      In      Status received from master
+
+    Returns         : None
+
+  ============================================================================*/
+
+void defineSlaveStatus(E_TST_STATUS eReceivedStatus)
+{
+    /* If test case failed either in master/slave */
+    if (((eReceivedStatus == E_FAILED) || (g_Registry.peStatus[uCurrentCase] == E_FAILED))
+    	&& (eCurrentStatus == E_TST_CASE_EXECUTED))
+    {
+        deviceDrvTstFWDebug(LOG_TO_DBG,"\tTest case %s failed [%s:%d]\n",
+            szCurrentTestCase, __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(nScreenCol,
+				g_Registry.pdElapsedTime[uCurrentCase], TST_FAILED);
+
+        g_Registry.peStatus[uCurrentCase] = E_FAILED;
+        reportTestCase(uCurrentCase);
+        g_pSummary->uNumberOfTestsFailed++;
+        uCurrentPosition++;
+        eSlaveStateMachine = E_TST_SUITE_FOUND;
+    }
+    /* If test case timedout either in master/slave */
+    else if (((eReceivedStatus == E_TIMEOUT) ||
+    	(g_Registry.peStatus[uCurrentCase] == E_TIMEOUT)) &&
+    	(eCurrentStatus == E_TST_CASE_EXECUTED))
+    {
+        deviceDrvTstFWDebug(LOG_TO_DBG,"\tTest case %s timeout [%s:%d]\n",
+            szCurrentTestCase, __FILENAME__, __LINE__);
+
+        if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(nScreenCol, 0, TST_TIMEOUT);
+
+        g_Registry.peStatus[uCurrentCase] = E_TIMEOUT;
+        reportTestCase(uCurrentCase);
+        g_pSummary->uNumberOfTestsTimeout++;
+        uCurrentPosition++;
+        eSlaveStateMachine = E_TST_SUITE_FOUND;
+    }
+    /* If test case is passed on master as well as slave */
+    else if (((eReceivedStatus == E_PASSED) && (g_Registry.peStatus[uCurrentCase] == E_PASSED))
+    	&& (eCurrentStatus == E_TST_CASE_EXECUTED))
+    {
+
+        deviceDrvTstFWDebug(LOG_TO_DBG,"\tTest case %s passed [%s:%d]\n",
+            szCurrentTestCase, __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(nScreenCol,
+				g_Registry.pdElapsedTime[uCurrentCase], TST_PASSED);
+
+        g_Registry.peStatus[uCurrentCase] = E_PASSED;
+        reportTestCase(uCurrentCase);
+        g_pSummary->uNumberOfTestsPassed++;
+        uCurrentPosition++;
+        eSlaveStateMachine = E_TST_SUITE_FOUND;
+    }
+    /* Any other status of master or slave, e.g. E_ERROR, fails the case */
+    else if (eCurrentStatus == E_TST_CASE_EXECUTED)
+    {
+        deviceDrvTstFWDebug(LOG_TO_DBG,
+            "\tTest case %s failed, status %d on master, %d on slave "
+            "[%s:%d]\n", szCurrentTestCase, eReceivedStatus,
+            g_Registry.peStatus[uCurrentCase], __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(nScreenCol,
+				g_Registry.pdElapsedTime[uCurrentCase], TST_FAILED);
+
+        g_Registry.peStatus[uCurrentCase] = E_FAILED;
+        reportTestCase(uCurrentCase);
+        g_pSummary->uNumberOfTestsFailed++;
+        uCurrentPosition++;
+        eSlaveStateMachine = E_TST_SUITE_FOUND;
+    }
+}
+
+
+/**=============================================================================
+
+	Function Name   : buildManifest
+    Description     : Function to fill szManifest with as many suite and case
+    				  records as fit in one handshake message, starting from
+    				  the manifest cursor. A suite which continues from the
+    				  previous chunk is repeated, so that every chunk can be
+    				  resolved by master on its own.
+    Arguments       : None
+    Returns         : Length of the manifest chunk
+
+  ============================================================================*/
+
+static unsigned int buildManifest(void)
+{
+	unsigned int uLength = 0, uNameLength = 0, uSuite = 0;
+
+	uChunkCase = uManifestCase;
+
+	while (uManifestCase < g_Registry.uNumberOfCases)
+	{
+		uSuite = g_Registry.puSuite[uManifestCase];
+
+		/* Suite record, at suite start and at the start of every chunk */
+		if ((uManifestCase == g_Registry.puFirstCase[uSuite]) ||
+			(uLength == 0))
+		{
+			uNameLength = strlen(g_Registry.pszSuiteName[uSuite]);
+			if ((uLength + 2 + uNameLength) > FW_MAX_PAYLOAD_LEN)
+			{
+				break;
+			}
+
+			szManifest[uLength++] = MANIFEST_SUITE_RECORD;
+			szManifest[uLength++] = uNameLength;
+			memcpy(&szManifest[uLength], g_Registry.pszSuiteName[uSuite],
+				uNameLength);
+			uLength += uNameLength;
+		}
+
+		/* Case records of the current suite */
+		uNameLength = strlen(g_Registry.pszCaseName[uManifestCase]);
+		if ((uLength + 2 + uNameLength) > FW_MAX_PAYLOAD_LEN)
+		{
+			break;
+		}
+
+		szManifest[uLength++] = MANIFEST_CASE_RECORD;
+		szManifest[uLength++] = uNameLength;
+		memcpy(&szManifest[uLength], g_Registry.pszCaseName[uManifestCase],
+			uNameLength);
+		uLength += uNameLength;
+
+		uManifestCase++;
+	}
+
+	return uLength;
+}
+
+
+/**=============================================================================
+
+	Function Name   : applyManifestResult
+    Description     : Function to update the suite and case status from the
+    				  found/not-found bitmap sent by master for a manifest
+    				  chunk. Bit n of the bitmap belongs to record n of the
+    				  chunk.
+    Arguments       :
+                      Name              Dir     Description
+                      @pChunk           In      Manifest request answered
+                      @pBitmap          In      Bitmap received from master
+                      @uLength          In      Length of the bitmap
+
+    Returns         : None
+
+  ============================================================================*/
+
+static void applyManifestResult(sPendingRequest_t *pChunk,
+    unsigned char *pBitmap, unsigned int uLength)
+{
+	unsigned int uCase = pChunk->uFirstCase, uSuite = 0, uRecord = 0;
+	bool bFound = false;
+
+	while ((uCase < pChunk->uEndCase) && (uRecord < (uLength * 8)))
+	{
+		uSuite = g_Registry.puSuite[uCase];
+
+		/* Suite record */
+		if ((uCase == g_Registry.puFirstCase[uSuite]) || (uRecord == 0))
+		{
+			bFound = (pBitmap[uRecord / 8] >> (uRecord % 8)) & 0x01;
+			uRecord++;
+
+			if (bFound)
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tTest suite %s found in master [%s:%d]\n",
+					g_Registry.pszSuiteName[uSuite], __FILENAME__, __LINE__);
+				g_Registry.peSuiteStatus[uSuite] = E_FOUND;
+			}
+			else if (g_Registry.peSuiteStatus[uSuite] != E_NOT_FOUND)
+			{
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tTest suite %s not found in master [%s:%d]\n",
+					g_Registry.pszSuiteName[uSuite], __FILENAME__, __LINE__);
+				g_Registry.peSuiteStatus[uSuite] = E_NOT_FOUND;
+				g_pSummary->uNumberOfSuitesNotFound++;
+				reportTestSuiteNotFound(uSuite);
+			}
+		}
+
+		/* Case record, only accounted if its suite is present in master */
+		bFound = (pBitmap[uRecord / 8] >> (uRecord % 8)) & 0x01;
+		uRecord++;
+
+		if (bFound)
+		{
+			g_Registry.peStatus[uCase] = E_FOUND;
+		}
+		else if (g_Registry.peSuiteStatus[uSuite] == E_FOUND)
+		{
+			deviceDrvTstFWDebug(LOG_TO_DBG,
+				"\tTest case %s not found in master [%s:%d]\n",
+				g_Registry.pszCaseName[uCase], __FILENAME__, __LINE__);
+			g_Registry.peStatus[uCase] = E_NOT_FOUND;
+			g_pSummary->uNumberOfTestsNotFound++;
+			reportTestCase(uCase);
+		}
+
+		uCase++;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : initialHandshake
+    Description     : This function is used to do initial handshaking with
+    				  master machine and also to initialize the test framework
+    				  (loading shared object, adding test suites and test cases
+    				  to list, allocating memory to store test summary).
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+static void initialHandshake(void)
+{
+	sHandshakeMsg_t Send;
+
+	while(1)
+	{
+		memset(&Send, 0, sizeof(Send));
+
+		/* Reply from master is consumed first */
+		if (Receive.eMsgType != 0)
+		{
+			processReply();
+			memset(&Receive, 0, sizeof(Receive));
+		}
+
+		/* Hello, framework init and status are sent back to back as far as
+		 * the window allows, master answers them in the same order.
+		 */
+		switch (eSlaveStateMachine)
+		{
+			case E_NONE:
+				deviceDrvTstFWDebug(LOG_TO_DBG,
+					"\tSend >> E_MSG_HELLO [%s:%d]\n", __FILENAME__, __LINE__);
+				Send.eMsgType = E_MSG_HELLO;
+				eSlaveStateMachine = E_MSG_HELLO_SENT;
+				postRequest(&Send);
+			break;
+
+			case E_MSG_HELLO_SENT:
+				if (isWindowOpen())
+				{
+			        deviceDrvTstFWDebug(LOG_TO_DBG,
+			        	"\tSend >> E_MSG_FRAMEWORK_INIT [%s:%d]\n",
+			        	__FILENAME__, __LINE__);
+			        Send.eMsgType = E_MSG_FRAMEWORK_INIT;
+			        eSlaveStateMachine = E_MSG_FRAMEWORK_INIT_SENT;
+			        postRequest(&Send);
+				}
+            break;
+
+        	case E_MSG_FRAMEWORK_INIT_SENT:
+        		if (isWindowOpen())
+        		{
+	        		deviceDrvTstFWDebug(LOG_TO_DBG,
+	        			"\tSend >> E_MSG_STATUS [%s:%d]\n",
+	        			__FILENAME__, __LINE__);
+	                Send.eMsgType = E_MSG_STATUS;
+	                eSlaveStateMachine = E_MSG_STATUS_SENT;
+	                postRequest(&Send);
+        		}
 			break;
 
 			case E_FRAMEWORK_INIT_FAILED:
 			case E_CLOSE_FRAMEWOERK:
-				deviceDrvTstFWDebug(LOG_TO_DBG,
-					"\tSend >> E_MSG_CLOSE [%s:%d]\n", __FILENAME__, __LINE__);
-                Send.eMsgType = E_MSG_CLOSE;
-                eSlaveStateMachine = E_MSG_CLOSE_SENT;
-                sendMessage(&Send);
+				if (isWindowOpen())
+				{
+					deviceDrvTstFWDebug(LOG_TO_DBG,
+						"\tSend >> E_MSG_CLOSE [%s:%d]\n",
+						__FILENAME__, __LINE__);
+	                Send.eMsgType = E_MSG_CLOSE;
+	                eSlaveStateMachine = E_MSG_CLOSE_SENT;
+	                postRequest(&Send);
+				}
+			break;
+		}
+
+		if (eSlaveStateMachine == E_FRAMEWORK_INITIALIZED)
+		{
+			/* First estimate of the clock of master */
+			if (clockSyncDue())
+			{
+				synchronizeClock();
+			}
 			break;
 		}
-		if ((eSlaveStateMachine == E_FRAMEWORK_INITIALIZED) ||
-			(eSlaveStateMachine == E_MSG_CLOSE_ACK))
+
+		if (eSlaveStateMachine == E_MSG_CLOSE_ACK)
 		{
 			break;
 		}
+
+		/* Wait for master */
+		if (isWaitingForEvent())
+		{
+			if (flushMessages(&g_SlaveLink) == -1)
+			{
+				deviceDrvTstFWDebug(LOG_TO_USR, "Socket closed\n");
+				freeMemory(1);
+			}
+
+			if (isMessageBuffered(&g_SlaveLink))
+			{
+				socketHandler(g_SlaveLink.nSockfd, EPOLLIN, NULL);
+			}
+			else
+			{
+				reactorDispatch(REACTOR_WAIT_FOREVER, 1);
+			}
+		}
 	}
 }
 
 /**=============================================================================
 
-	Function Name   : createTimer
-    Description     : This function is used to create a realtime timer and also
-    				  to register the realtime signal, which will be called when
-    				  timer expires.
+	Function Name   : forkChildProcess
+    Description     : This function is used to fork the child process which
+    				  executes the test cases, connected to the slave thread
+    				  through a new channel and tracked by the watchdog.
     Arguments       : None
     Returns         : None
 
   ============================================================================*/
 
-static void createTimer(void)
+static void forkChildProcess(void)
 {
-	struct sigevent sev;
-	struct sigaction sa;
+	pid_t nPid = 0;
 
-	memset(&sev, 0, sizeof(struct sigevent));
-	memset(&sa, 0, sizeof(struct sigaction));
+	if (channelCreate(&TestChannel) == -1)
+	{
+		freeMemory(1);
+	}
+
+	/* Buffered output must not be inherited by the child */
+	fflush(NULL);
 
-	/* Establish handler for timer signal */
-	sa.sa_flags = SA_SIGINFO;
-	sa.sa_sigaction = timerHandler;
-	sigemptyset(&sa.sa_mask);
-	if (sigaction(SIG, &sa, NULL) == -1)
+	/* Create a child process */
+	nPid = fork();
+	if (nPid == 0)
+	{
+		executeTestCases(&TestChannel);
+	}
+	else if (nPid == -1)
 	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Error in registering signal\n");
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"Error in creating test execution process\n");
 		freeMemory(1);
 	}
 
-    /* Create the timer */
-    sev.sigev_notify = SIGEV_SIGNAL;
-	sev.sigev_signo = SIG;
-	sev.sigev_value.sival_ptr = &g_timerId;
-	if(timer_create(CLOCK_REALTIME, &sev, &g_timerId) == -1)
+	if ((watchdogAttach(&TestWatchdog, nPid) == -1) ||
+		(reactorAdd(TestChannel.nDoneFd, EPOLLIN, doneHandler, NULL) == -1))
 	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating timer\n");
 		freeMemory(1);
 	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : synchronizeClock
+    Description     : This function is used to take a round of clock requests
+    				  to master and to send it the estimate of the round. The
+    				  requests are sent one at a time, each once the reply of
+    				  the previous one is received, so that none of them waits
+    				  in a queue. Caller has to make sure no request is in
+    				  flight.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+static void synchronizeClock(void)
+{
+	sHandshakeMsg_t Send;
+	sPendingRequest_t *pRequest = NULL;
+	unsigned char szEstimate[FW_CLOCK_ESTIMATE_LEN];
+	unsigned int uSample = 0;
+
+	for (uSample = 0; uSample < CLOCK_SYNC_SAMPLES; uSample++)
+	{
+		memset(&Send, 0, sizeof(Send));
+		Send.eMsgType = E_MSG_CLOCK_SYNC;
+		pRequest = postRequest(&Send);
+
+		pRequest->uSentNs = clockSyncNow();
+		if (flushMessages(&g_SlaveLink) == -1)
+		{
+			deviceDrvTstFWDebug(LOG_TO_USR, "Socket closed\n");
+			freeMemory(1);
+		}
+
+		/* Wait for the reply */
+		while (uPendingCount > 0)
+		{
+			if (isMessageBuffered(&g_SlaveLink))
+			{
+				socketHandler(g_SlaveLink.nSockfd, EPOLLIN, NULL);
+			}
+			else
+			{
+				reactorDispatch(REACTOR_WAIT_FOREVER, 1);
+			}
+		}
+
+		processReply();
+		memset(&Receive, 0, sizeof(Receive));
+	}
+
+	memset(&Send, 0, sizeof(Send));
+	Send.eMsgType = E_MSG_CLOCK_ESTIMATE;
+	Send.pPayload = szEstimate;
+	Send.uPayloadLength = clockSyncRound(szEstimate);
 
-	g_bTimerCreationFlag = true;
+	/* Not a request, it goes out with the next one */
+	if (Send.uPayloadLength != 0)
+	{
+		Send.uSlaveId = g_uSlaveId;
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tSend >> E_MSG_CLOCK_ESTIMATE [%s:%d]\n",
+			__FILENAME__, __LINE__);
+		sendMessage(&g_SlaveLink, &Send);
+	}
 }
 
 
+/**=============================================================================
+
+	Function Name   : proposeStartTime
+    Description     : This function is used to schedule the start of the
+    				  current test case START_BARRIER_US after now, so that
+    				  the test execution processes of both the machines start
+    				  it at the same time. The start time is sent to master
+    				  on its own clock, the case is not scheduled when the
+    				  clock of master is not estimated.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pPayload			Out		Start time for master
+    Returns         : Length of the payload, 0 if the case is not scheduled
+
+  ============================================================================*/
+
+static unsigned int proposeStartTime(unsigned char *pPayload)
+{
+	uint64_t uMasterStartAtNs = 0;
+	int i = 0;
+
+	uStartAtNs = 0;
+	uMasterStartedNs = 0;
+
+	if (g_uStartBarrierUs == 0)
+	{
+		return 0;
+	}
+
+	uStartAtNs = clockSyncNow() + (uint64_t)g_uStartBarrierUs * 1000;
+	if (!clockSyncToRemote(0, uStartAtNs, &uMasterStartAtNs))
+	{
+		uStartAtNs = 0;
+		return 0;
+	}
+
+	for (i = 0; i < FW_START_TIME_LEN; i++)
+	{
+		pPayload[i] = (unsigned char)(uMasterStartAtNs & 0xff);
+		uMasterStartAtNs >>= 8;
+	}
+
+	return FW_START_TIME_LEN;
+}
+
+
+/**=============================================================================
+
+	Function Name   : measureStartSkew
+    Description     : This function is used to take the skew of the starts of
+    				  a scheduled test case, once the results of both the
+    				  machines are in. The start of master is converted to the
+    				  local clock.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+static void measureStartSkew(void)
+{
+	sStartBarrier_t *pBarrier = &g_Registry.pStartBarrier[uCurrentCase];
+	uint64_t uMasterStartNs = 0;
+
+	if (!pBarrier->bScheduled || (uMasterStartedNs == 0) ||
+		!clockSyncToLocal(0, uMasterStartedNs, &uMasterStartNs,
+		&pBarrier->uErrorNs))
+	{
+		return;
+	}
+
+	pBarrier->bSkewKnown = true;
+	pBarrier->nSkewNs = (int64_t)(uMasterStartNs - pBarrier->uStartNs);
+
+	deviceDrvTstFWDebug(LOG_TO_DBG,
+		"\tTest case %s start skew %lld ns, late %lld ns [%s:%d]\n",
+		g_Registry.pszCaseName[uCurrentCase], (long long)pBarrier->nSkewNs,
+		(long long)pBarrier->nLateNs, __FILENAME__, __LINE__);
+}
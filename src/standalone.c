@@ -47,6 +47,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "deviceDrvTestFW.h"
 #include "testStruct.h"
 #include "console.h"
+#include "reactor.h"
+#include "watchdog.h"
+#include "arena.h"
+#include "schedule.h"
 
 #define LOG_TO_USR 		1
 #define LOG_TO_DBG  	2
@@ -54,8 +58,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define RET_SUCCESS		0
 #define RET_FAILURE	    -1
 
-#define SIG SIGRTMIN
-
 /*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
 
 typedef enum{
@@ -71,55 +73,195 @@ typedef enum{
     E_CLOSE_FRAMEWOERK
 }E_STANDALONE_MACHINE_STATE;
 
+/* Pre-forked test execution process */
+typedef struct standalone_worker
+{
+    sWatchdog_t Watchdog;                   /* Process and test timer */
+    sTestChannel_t Channel;                 /* Scheduled case, result */
+    int nCase;                              /* Case index executed, -1 if
+                                               the worker is free */
+    int nScreenCol;                         /* Console line of the test case */
+}sWorker_t;
+
 E_STANDALONE_MACHINE_STATE eStandaloneStateMachine = E_NONE;
 E_STANDALONE_MACHINE_STATE eCurrentStatus;
 
-sTestCase_t *pTestcase;
-sTestSuite_t *pSuite;
+static unsigned int uCurrentSuite;		/* Suite index being scheduled */
+static unsigned int uCurrentCase;		/* Case index being scheduled */
+static unsigned int uCurrentPosition;	/* Scheduling position of the case */
 
 pthread_t g_standaloneMainThread, g_standaloneWorkerThread;
 
 unsigned char szCurrentTestSuite[30];
 unsigned char szCurrentTestCase[30];
 
-pid_t cpid;
 sigset_t mask;
 
-int nCommChannel[2];					/* Socket Pair */
+sWorker_t aWorker[FW_MAX_WORKERS];		/* Test execution processes */
+unsigned int uWorkersStarted;			/* Number of workers created */
+unsigned int uWorkersBusy;				/* Number of workers executing */
+bool bSerialCaseRunning;				/* Case of a serial suite running */
 
 /*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
 
 void *pStandaloneMainThread(void *pFd);
-void childProcess(void);
-static void createTimer(void);
+static void startWorkers(void);
+static void forkWorker(sWorker_t *pWorker);
+static sWorker_t *getFreeWorker(void);
+static void completeTestCase(sWorker_t *pWorker);
+static void doneHandler(int nFd, uint32_t uEvents, void *pArg);
+static void exitHandler(sWatchdog_t *pWatchdog, int nStatus);
 
 /*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
 
 
 /**=============================================================================
 
-	Function Name   : timerHandler
-    Description     : This is the signal handler. It is called when the timer
-    				  expires and it also sends the SIGKILL to child process
-    				  created in standalone thread.
+	Function Name   : completeTestCase
+    Description     : Function to stop the watchdog of a worker, to read the
+    				  result of its test case from the arena, to update the
+    				  summary and to free the worker. A case without result
+    				  was ended by the termination of the process, it timed
+    				  out if the watchdog expired, else it failed.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWorker  		In		Worker of the test case
+    Returns         : None
+
+  ============================================================================*/
+
+static void completeTestCase(sWorker_t *pWorker)
+{
+	unsigned int uExecuted = pWorker->nCase;
+	E_TST_STATUS eStatus;
+	uint64_t uElapsedNs = 0;
+
+	watchdogStop(&pWorker->Watchdog);
+
+	if (!arenaCollect(uExecuted, &eStatus, &uElapsedNs, uExecuted))
+	{
+		eStatus = pWorker->Watchdog.bExpired ? E_TIMEOUT : E_FAILED;
+	}
+	g_Registry.puHistogramSlot[uExecuted] = pWorker->Channel.uSlot + 1;
+
+	g_Registry.peStatus[uExecuted] = eStatus;
+	g_Registry.pdElapsedTime[uExecuted] =
+		(double)uElapsedNs / WATCHDOG_NSEC_PER_SEC;
+
+	/* If test case failed */
+	if (eStatus == E_FAILED)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tTest case %s failed [%s:%d]\n",
+			g_Registry.pszCaseName[uExecuted], __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(pWorker->nScreenCol,
+				g_Registry.pdElapsedTime[uExecuted], TST_FAILED);
+
+		g_pSummary->uNumberOfTestsFailed++;
+	}
+	/* If test case timedout */
+	else if (eStatus == E_TIMEOUT)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tTest case %s timeout [%s:%d]\n",
+			g_Registry.pszCaseName[uExecuted], __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(pWorker->nScreenCol, 0,
+				TST_TIMEOUT);
+
+		g_pSummary->uNumberOfTestsTimeout++;
+	}
+	/* If test case is passed */
+	else if (eStatus == E_PASSED)
+	{
+		deviceDrvTstFWDebug(LOG_TO_DBG,
+			"\tTest case %s passed [%s:%d]\n",
+			g_Registry.pszCaseName[uExecuted], __FILENAME__, __LINE__);
+
+		if (g_bConsoleInitialized)
+			fnUpdateTstStatusToScreen(pWorker->nScreenCol,
+				g_Registry.pdElapsedTime[uExecuted], TST_PASSED);
+
+		g_pSummary->uNumberOfTestsPassed++;
+	}
+
+	reportTestCase(uExecuted);
+
+	pWorker->nCase = -1;
+	uWorkersBusy--;
+	bSerialCaseRunning = false;
+}
+
+
+/**=============================================================================
+
+	Function Name   : doneHandler
+    Description     : This is the done eventfd handler. It is called when the
+    				  test execution process of a worker published the result
+    				  of its test case in the arena.
     Arguments       :
     				  Name            	Dir    	Description
-                      @sig  			In		Signal number
-                      @si				In		Signal information
-                      @uc				In		Pointer to ucontext_t
+                      @nFd  			In		Done eventfd
+                      @uEvents			In		Epoll events
+                      @pArg				In		Worker of the eventfd
     Returns         : None
 
   ============================================================================*/
 
-static void timerHandler(int sig, siginfo_t *si, void *uc)
+static void doneHandler(int nFd, uint32_t uEvents, void *pArg)
 {
-	kill(cpid, SIGUSR1);
+	sWorker_t *pWorker = pArg;
+
+	if (channelDrain(&pWorker->Channel) && (pWorker->nCase != -1))
+	{
+		completeTestCase(pWorker);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : exitHandler
+    Description     : This is the watchdog exit handler. It is called when the
+    				  test execution process of a worker terminated, the test
+    				  case it was running is completed from the arena, with
+    				  the resources it used from the exit totals, and a
+    				  new process is forked for the worker.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog of the worker
+                      @nStatus			In		Exit status of the process
+    Returns         : None
+
+  ============================================================================*/
+
+static void exitHandler(sWatchdog_t *pWatchdog, int nStatus)
+{
+	sWorker_t *pWorker = pWatchdog->pArg;
+
+	deviceDrvTstFWDebug(LOG_TO_USR,
+		"Test execution process terminated, restarting it\n");
+
+	if (pWorker->nCase != -1)
+	{
+		arenaSettle(pWorker->nCase, &pWatchdog->ExitUsage);
+		completeTestCase(pWorker);
+	}
+
+	reactorRemove(pWorker->Channel.nDoneFd);
+	channelClose(&pWorker->Channel);
+
+	forkWorker(pWorker);
 }
 
 
 /**=============================================================================
 
 	Function Name   : initializeSlaveDevice
+
     Description     : This function is used to create standalone thread and to
 				      wait on thread till it completes the execution.
     Arguments       : None
@@ -129,12 +271,6 @@ static void timerHandler(int sig, siginfo_t *si, void *uc)
 
 void initializeStandaloneDevice(void)
 {
-	if (socketpair(AF_UNIX, SOCK_STREAM, 0, nCommChannel) == -1)
-	{
-		deviceDrvTstFWDebug(LOG_TO_USR,"Error in creating socketpair\n");
-		freeMemory(1);
-	}
-
 	/* Create a thread in parent process */
 	pthread_create(&g_standaloneMainThread, NULL, pStandaloneMainThread, NULL);
 
@@ -144,60 +280,115 @@ void initializeStandaloneDevice(void)
 
 /**=============================================================================
 
-	Function Name   : childProcess
-    Description     : This function is used to execute the testcases scheduled
-    				  by the standalone thread and send back the execution
-    				  status to standalone thread.
+	Function Name   : startWorkers
+    Description     : This function is used to create g_uWorkerCount workers,
+    				  each with its own watchdog and test execution process.
     Arguments       : None
     Returns         : None
 
   ============================================================================*/
 
-void childProcess(void)
+static void startWorkers(void)
 {
-    int nScreenCol = 0, nRet=0, nErr = 0;
-    fd_set readset;
-    sInterProcessMsg_t ToParent;
-
-    E_TST_STATUS testStatus;
-
-	/* Initialize time out struct for select() */
-    struct timeval Tv;
-    Tv.tv_sec = 0;
-    Tv.tv_usec = 10000;
-
-    while (1)
-    {
-		/* Initialize the set */
-        FD_ZERO(&readset);
-        FD_SET(nCommChannel[1], &readset);
-
-        /* Now, check for readability */
-        nErr = select(nCommChannel[1]+1, &readset, NULL, NULL, &Tv);
-        if (nErr > 0 && FD_ISSET(nCommChannel[1], &readset))
-        {
-            /* Clear flags */
-            FD_CLR(nCommChannel[1], &readset);
-
-            /* Do a simple read on data */
-            memset(&ToParent,0,sizeof(ToParent));
-            read(nCommChannel[1], &ToParent, sizeof(ToParent));
-
-			switch (ToParent.nType)
-			{
-				/* Execute test case */
-				case 0x01:
-					pTestcase = ToParent.pTestcase;
-					pTestcase->eStatus = pTestcase->fnPtrTestCase();
-
-					memset(&ToParent,0,sizeof(ToParent));
-					ToParent.nType = E_TST_CASE_EXECUTED;
-					ToParent.eStatus = pTestcase->eStatus;
-					send(nCommChannel[1], &ToParent, sizeof(ToParent), 0);
-				break;
-			}
+	sWorker_t *pWorker = NULL;
+
+	for (uWorkersStarted = 0; uWorkersStarted < g_uWorkerCount; )
+	{
+		pWorker = &aWorker[uWorkersStarted];
+		memset(pWorker, 0, sizeof(sWorker_t));
+		pWorker->nCase = -1;
+		pWorker->Channel.uSlot = uWorkersStarted;
+
+		if (watchdogInit(&pWorker->Watchdog, exitHandler, pWorker) == -1)
+		{
+			freeMemory(1);
+		}
+
+		uWorkersStarted++;
+		forkWorker(pWorker);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : forkWorker
+    Description     : This function is used to fork the test execution process
+    				  of a worker, connected to the standalone thread through a
+    				  new channel and tracked by the watchdog of the worker.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWorker  		In		Worker
+    Returns         : None
+
+  ============================================================================*/
+
+static void forkWorker(sWorker_t *pWorker)
+{
+	pid_t nPid = 0;
+
+	if (channelCreate(&pWorker->Channel) == -1)
+	{
+		freeMemory(1);
+	}
+
+	/* Buffered output must not be inherited by the child */
+	fflush(NULL);
+
+	/* Create a child process */
+	nPid = fork();
+	if (nPid == 0)
+	{
+		executeTestCases(&pWorker->Channel);
+	}
+	else if (nPid == -1)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"Error in creating test execution process\n");
+		freeMemory(1);
+	}
+
+	if ((watchdogAttach(&pWorker->Watchdog, nPid) == -1) ||
+		(reactorAdd(pWorker->Channel.nDoneFd, EPOLLIN, doneHandler,
+			pWorker) == -1))
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in registering worker\n");
+		freeMemory(1);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : getFreeWorker
+    Description     : This function is used to find a worker to execute the
+    				  current test case. Case of a parallel suite gets any free
+    				  worker, case of a serial suite waits till all the workers
+    				  are free and then runs alone.
+    Arguments       : None
+    Returns         : Free worker, NULL if the case has to wait
+
+  ============================================================================*/
+
+static sWorker_t *getFreeWorker(void)
+{
+	unsigned int i = 0;
+
+	if (bSerialCaseRunning ||
+		(!g_Registry.pbParallel[uCurrentSuite] && (uWorkersBusy > 0)))
+	{
+		return NULL;
+	}
+
+	for (i = 0; i < uWorkersStarted; i++)
+	{
+		if (aWorker[i].nCase == -1)
+		{
+			return &aWorker[i];
 		}
 	}
+
+	return NULL;
 }
 
 
@@ -205,8 +396,9 @@ void childProcess(void)
 
     Function Name   : pStandaloneMainThread
     Description     : This is a thread function. It is used to traverse over the
-    				  test suite and test case list and scheduled the testcase
-    				  to execute in child process.
+    				  test suite and test case list and to schedule the
+    				  testcases to the free test execution processes. The
+    				  cases of a suite are taken in the order of scheduleCase.
     Arguments       : None
     Returns         : None
 
@@ -214,236 +406,135 @@ void childProcess(void)
 
 void *pStandaloneMainThread(void *pFd)
 {
-    int nScreenCol = 0, nRet=0, nErr = 0;
-	fd_set readset;
-    sInterProcessMsg_t ToChild;
-
-    /* Initialize time out struct for select() */
-    struct timeval Tv;
-    Tv.tv_sec = 0;
-    Tv.tv_usec = 10000;
+    int nRet=0;
+    E_STANDALONE_MACHINE_STATE ePreviousState;
+    sWorker_t *pWorker = NULL;
 
     /* Initialize test framework */
     nRet = initializeTestFramework();
-	if (nRet == 0)
+	if ((nRet == 0) && (reactorInit() == 0))
 	{
 		eStandaloneStateMachine = E_FRAMEWORK_INITIALIZED;
-		pSuite = g_pSuiteHead;
+		uCurrentSuite = 0;
 
-		createTimer();
+		/* Results are appended to the report as they are settled */
+		openXMLReport();
 
-		bGenerateReport = true;
+		/* Create the test execution processes */
+		startWorkers();
+		scheduleStart();
 
-		/* Create a child process */
-		cpid = fork();
-		if(cpid == 0)
-		{
-			childProcess();
-		}
-		else
+		while(1)
 		{
-			/* Parent process */
-			while(1)
+			ePreviousState = eStandaloneStateMachine;
+
+			switch (eStandaloneStateMachine)
 			{
-				memset(&ToChild, 0, sizeof(ToChild));
-
-				switch (eStandaloneStateMachine)
-				{
-					case E_FRAMEWORK_INITIALIZED:
-						if (pSuite != NULL)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tTest suite name: %s [%s:%d]\n",
-								pSuite->szName, __FILENAME__, __LINE__);
-							strcpy(szCurrentTestSuite, pSuite->szName);
-							pTestcase = pSuite->sTestCaseList;
-							eStandaloneStateMachine = E_TST_SUITE_FOUND;
-							pSuite->eStatus = E_FOUND;
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tE_TST_SUITE_LIST_COMPLETED [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							eStandaloneStateMachine =
-								E_TST_SUITE_LIST_COMPLETED;
-						}
-					break;
-
-					case E_TST_SUITE_FOUND:
-						if (pTestcase!= NULL)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tTest case name: %s [%s:%d]\n",
-								pTestcase->szName, __FILENAME__, __LINE__);
-							strcpy(szCurrentTestCase, pTestcase->szName);
-							eStandaloneStateMachine = E_TST_CASE_FOUND;
-						}
-						else
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tE_TST_CASE_LIST_COMPLETED [%s:%d]\n",
-								__FILENAME__, __LINE__);
-							eStandaloneStateMachine = E_TST_CASE_LIST_COMPLETED;
-							pSuite = pSuite->hh.next;
-						}
-					break;
-
-
-					case E_TST_CASE_FOUND:
-						ToChild.nType = 0x01;
-						ToChild.pTestcase = pTestcase;
-						eStandaloneStateMachine = E_TST_CASE_EXECUTE;
-
-						send(nCommChannel[0], &ToChild,
-							sizeof(ToChild), 0);
-						checkTimer(&g_timerId, pTestcase->uTimeout, true);
+				case E_FRAMEWORK_INITIALIZED:
+					if (uCurrentSuite < g_Registry.uNumberOfSuites)
+					{
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+							"\tTest suite name: %s [%s:%d]\n",
+							g_Registry.pszSuiteName[uCurrentSuite],
+							__FILENAME__, __LINE__);
+						strcpy(szCurrentTestSuite,
+							g_Registry.pszSuiteName[uCurrentSuite]);
+						uCurrentPosition =
+							g_Registry.puFirstCase[uCurrentSuite];
+						eStandaloneStateMachine = E_TST_SUITE_FOUND;
+						g_Registry.peSuiteStatus[uCurrentSuite] = E_FOUND;
+					}
+					else
+					{
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+							"\tE_TST_SUITE_LIST_COMPLETED [%s:%d]\n",
+							__FILENAME__, __LINE__);
+						eStandaloneStateMachine =
+							E_TST_SUITE_LIST_COMPLETED;
+					}
+				break;
+
+				case E_TST_SUITE_FOUND:
+					if (uCurrentPosition < REGISTRY_SUITE_END(uCurrentSuite))
+					{
+						uCurrentCase = scheduleCase(uCurrentPosition);
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+							"\tTest case name: %s [%s:%d]\n",
+							g_Registry.pszCaseName[uCurrentCase],
+							__FILENAME__, __LINE__);
+						strcpy(szCurrentTestCase,
+							g_Registry.pszCaseName[uCurrentCase]);
+						eStandaloneStateMachine = E_TST_CASE_FOUND;
+					}
+					else
+					{
+						deviceDrvTstFWDebug(LOG_TO_DBG,
+							"\tE_TST_CASE_LIST_COMPLETED [%s:%d]\n",
+							__FILENAME__, __LINE__);
+						eStandaloneStateMachine = E_TST_CASE_LIST_COMPLETED;
+						uCurrentSuite++;
+					}
+				break;
+
+				/* Schedule the case as soon as a worker is free for it */
+				case E_TST_CASE_FOUND:
+					pWorker = getFreeWorker();
+					if (pWorker != NULL)
+					{
+						pWorker->nCase = uCurrentCase;
+						uWorkersBusy++;
+						bSerialCaseRunning =
+							!g_Registry.pbParallel[uCurrentSuite];
+
+						watchdogStart(&pWorker->Watchdog,
+							g_Registry.puTimeout[uCurrentCase]);
+						channelPost(&pWorker->Channel, uCurrentCase);
 
 						if (g_bConsoleInitialized)
-							nScreenCol =
-                            fnAddTestNameToScreen(pTestcase->szName, 0,
+							pWorker->nScreenCol =
+                            fnAddTestNameToScreen(
+                            	g_Registry.pszCaseName[uCurrentCase], 0,
                             	TST_RUNNING);
 
 						deviceDrvTstFWDebug(LOG_TO_DBG,
-							"\tTest case is running... [%s:%d]\n",
+							"\tTest case %s is running... [%s:%d]\n",
+							g_Registry.pszCaseName[uCurrentCase],
 							__FILENAME__, __LINE__);
-					break;
-
-
-					case E_TST_CASE_EXECUTED:
-						pTestcase->dElapsedTime = (pTestcase->uTimeout/1000) -
-							checkTimer(&g_timerId, pTestcase->uTimeout, false);
-
-                        /* If test case failed */
-						if (pTestcase->eStatus == E_FAILED)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tTest case %s failed [%s:%d]\n",
-								szCurrentTestCase, __FILENAME__, __LINE__);
-
-							if (g_bConsoleInitialized)
-								fnUpdateTstStatusToScreen(nScreenCol,
-									pTestcase->dElapsedTime, TST_FAILED);
-
-							g_pSummary->uNumberOfTestsFailed++;
-							pTestcase = pTestcase->hh.next;
-							eStandaloneStateMachine = E_TST_SUITE_FOUND;
-						}
-						/* If test case timedout */
-						else if (pTestcase->eStatus == E_TIMEOUT)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tTest case %s timeout [%s:%d]\n",
-								szCurrentTestCase, __FILENAME__, __LINE__);
-
-							if (g_bConsoleInitialized)
-								fnUpdateTstStatusToScreen(nScreenCol, 0,
-									TST_TIMEOUT);
-
-							g_pSummary->uNumberOfTestsTimeout++;
-							pTestcase = pTestcase->hh.next;
-							eStandaloneStateMachine = E_TST_SUITE_FOUND;
-						}
-						/* If test case is passed */
-						else if (pTestcase->eStatus == E_PASSED)
-						{
-							deviceDrvTstFWDebug(LOG_TO_DBG,
-								"\tTest case %s passed [%s:%d]\n",
-								szCurrentTestCase, __FILENAME__, __LINE__);
-
-							if (g_bConsoleInitialized)
-								fnUpdateTstStatusToScreen(nScreenCol,
-									pTestcase->dElapsedTime, TST_PASSED);
-
-							g_pSummary->uNumberOfTestsPassed++;
-							pTestcase = pTestcase->hh.next;
-							eStandaloneStateMachine = E_TST_SUITE_FOUND;
-						}
-					break;
-
-					case E_TST_CASE_LIST_COMPLETED:
-						eStandaloneStateMachine = E_FRAMEWORK_INITIALIZED;
-					break;
-
-					case E_TST_SUITE_LIST_COMPLETED:
-						eStandaloneStateMachine = E_GENERATE_XML_REPORT;
-					break;
-				}
-
-				if (eStandaloneStateMachine == E_GENERATE_XML_REPORT)
-				{
-					break;
-				}
-
-				/* Initialize the set */
-				FD_ZERO(&readset);
-				FD_SET(nCommChannel[0], &readset);
-
-				/* Now, check for readability */
-				nErr = select(nCommChannel[0]+1, &readset, NULL, NULL, &Tv);
-				if (nErr > 0 && FD_ISSET(nCommChannel[0], &readset))
-				{
-					/* Clear flags */
-					FD_CLR(nCommChannel[0], &readset);
-
-					memset(&ToChild, 0, sizeof(ToChild));
-
-					/* Do a simple read on data */
-					read(nCommChannel[0], &ToChild,
-						sizeof(ToChild));
-
-					eStandaloneStateMachine = ToChild.nType;
-					pTestcase->eStatus = ToChild.eStatus;
-				}
-			}
-		}
-	}
-	else
-	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Framework initialization failed\n");
-		freeMemory(1);
-	}
-}
-
 
-/**=============================================================================
-
-	Function Name   : createTimer
-    Description     : This function is used to create a realtime timer and also
-    				  to register the realtime signal, which will be called when
-    				  timer expires.
-    Arguments       : None
-    Returns         : None
+						uCurrentPosition++;
+						eStandaloneStateMachine = E_TST_SUITE_FOUND;
+					}
+				break;
 
-  ============================================================================*/
+				case E_TST_CASE_LIST_COMPLETED:
+					eStandaloneStateMachine = E_FRAMEWORK_INITIALIZED;
+				break;
 
-static void createTimer(void)
-{
-	struct sigevent sev;
-	struct sigaction sa;
+				/* Report is generated once all the workers are done */
+				case E_TST_SUITE_LIST_COMPLETED:
+					if (uWorkersBusy == 0)
+					{
+						scheduleFinish(uWorkersStarted);
+						eStandaloneStateMachine = E_GENERATE_XML_REPORT;
+					}
+				break;
+			}
 
-	memset(&sev, 0, sizeof(struct sigevent));
-	memset(&sa, 0, sizeof(struct sigaction));
+			if (eStandaloneStateMachine == E_GENERATE_XML_REPORT)
+			{
+				break;
+			}
 
-	/* Establish handler for timer signal */
-	sa.sa_flags = SA_SIGINFO;
-	sa.sa_sigaction = timerHandler;
-	sigemptyset(&sa.sa_mask);
-	if (sigaction(SIG, &sa, NULL) == -1)
-	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Error in registering signal\n");
-		freeMemory(1);
+			/* No transition possible, wait for a worker or a timer */
+			if (eStandaloneStateMachine == ePreviousState)
+			{
+				reactorDispatch(REACTOR_WAIT_FOREVER, 1);
+			}
+		}
 	}
-
-    /* Create the timer */
-    sev.sigev_notify = SIGEV_SIGNAL;
-	sev.sigev_signo = SIG;
-	sev.sigev_value.sival_ptr = &g_timerId;
-	if(timer_create(CLOCK_REALTIME, &sev, &g_timerId) == -1)
+	else
 	{
-		deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating timer\n");
+		deviceDrvTstFWDebug(LOG_TO_USR, "Framework initialization failed\n");
 		freeMemory(1);
 	}
-
-	g_bTimerCreationFlag = true;
 }
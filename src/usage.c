@@ -0,0 +1,320 @@
+/**=============================================================================
+  $Workfile: usage.c $
+
+  File Description: Resource accounting of the test cases. The test execution
+                    process takes a getrusage snapshot and enables its perf
+                    hardware counters when a case starts and turns them into
+                    the resources used by the case when it ends. When the
+                    process dies in the middle of a case the scheduler settles
+                    the usage from the rusage returned by wait4.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <linux/perf_event.h>
+
+#include "deviceDrvTestFW.h"
+#include "usage.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+#define USAGE_COUNTERS      3
+
+/* Counted in the same order as the counter fields of sUsage_t */
+static const uint64_t g_auPerfConfig[USAGE_COUNTERS] =
+{
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES
+};
+
+static int g_anPerfFd[USAGE_COUNTERS] = {-1, -1, -1};
+static bool g_bPerfOpen;                    /* All the counters opened */
+
+/*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
+
+static void convertRusage(const struct rusage *pRusage, sUsage_t *pUsage);
+static void subtractUsage(sUsage_t *pUsage, const sUsage_t *pNow);
+static bool readCounters(sUsage_t *pUsage);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : convertRusage
+    Description     : Function to copy the fields of an rusage to a usage,
+    				  the counters are left as they are.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pRusage			In		From getrusage or wait4
+                      @pUsage			Out		Usage
+    Returns         : None
+
+  ============================================================================*/
+
+static void convertRusage(const struct rusage *pRusage, sUsage_t *pUsage)
+{
+	pUsage->uUserNs = (uint64_t)pRusage->ru_utime.tv_sec * 1000000000ULL +
+		(uint64_t)pRusage->ru_utime.tv_usec * 1000ULL;
+	pUsage->uSystemNs = (uint64_t)pRusage->ru_stime.tv_sec * 1000000000ULL +
+		(uint64_t)pRusage->ru_stime.tv_usec * 1000ULL;
+	pUsage->uVoluntarySwitches = pRusage->ru_nvcsw;
+	pUsage->uInvoluntarySwitches = pRusage->ru_nivcsw;
+	pUsage->uMinorFaults = pRusage->ru_minflt;
+	pUsage->uMajorFaults = pRusage->ru_majflt;
+	pUsage->uInBlocks = pRusage->ru_inblock;
+	pUsage->uOutBlocks = pRusage->ru_oublock;
+	pUsage->uMaxRssKb = pRusage->ru_maxrss;
+}
+
+
+/**=============================================================================
+
+	Function Name   : subtractUsage
+    Description     : Function to turn the snapshot taken at the case start
+    				  into the resources used since. The peak RSS only grows,
+    				  its difference is how much the case raised it.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pUsage			In/Out	Snapshot, then usage
+                      @pNow				In		Totals at the case end
+    Returns         : None
+
+  ============================================================================*/
+
+static void subtractUsage(sUsage_t *pUsage, const sUsage_t *pNow)
+{
+	pUsage->uUserNs = pNow->uUserNs - pUsage->uUserNs;
+	pUsage->uSystemNs = pNow->uSystemNs - pUsage->uSystemNs;
+	pUsage->uVoluntarySwitches = pNow->uVoluntarySwitches -
+		pUsage->uVoluntarySwitches;
+	pUsage->uInvoluntarySwitches = pNow->uInvoluntarySwitches -
+		pUsage->uInvoluntarySwitches;
+	pUsage->uMinorFaults = pNow->uMinorFaults - pUsage->uMinorFaults;
+	pUsage->uMajorFaults = pNow->uMajorFaults - pUsage->uMajorFaults;
+	pUsage->uInBlocks = pNow->uInBlocks - pUsage->uInBlocks;
+	pUsage->uOutBlocks = pNow->uOutBlocks - pUsage->uOutBlocks;
+	pUsage->uMaxRssKb = (pNow->uMaxRssKb > pUsage->uMaxRssKb) ?
+		pNow->uMaxRssKb - pUsage->uMaxRssKb : 0;
+	pUsage->uState = E_USAGE_DONE;
+}
+
+
+/**=============================================================================
+
+	Function Name   : readCounters
+    Description     : Function to stop the perf counters and to read them.
+    				  A counter which shared the PMU with other events ran
+    				  only part of the time, its value is scaled up to the
+    				  whole time.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pUsage			Out		Counter fields
+    Returns         : true if all the counters were read, else false
+
+  ============================================================================*/
+
+static bool readCounters(sUsage_t *pUsage)
+{
+	uint64_t *apuCounter[USAGE_COUNTERS] =
+		{&pUsage->uCycles, &pUsage->uInstructions, &pUsage->uCacheMisses};
+	uint64_t auValue[3];                /* Value, time enabled, running */
+	unsigned int i = 0;
+	bool bRead = true;
+
+	for (i = 0; i < USAGE_COUNTERS; i++)
+	{
+		ioctl(g_anPerfFd[i], PERF_EVENT_IOC_DISABLE, 0);
+	}
+
+	for (i = 0; i < USAGE_COUNTERS; i++)
+	{
+		if ((read(g_anPerfFd[i], auValue, sizeof(auValue)) !=
+			sizeof(auValue)) || (auValue[2] == 0))
+		{
+			bRead = false;
+			continue;
+		}
+
+		*apuCounter[i] = (auValue[2] < auValue[1]) ?
+			(uint64_t)((double)auValue[0] * auValue[1] / auValue[2]) :
+			auValue[0];
+	}
+
+	return bRead;
+}
+
+
+/**=============================================================================
+
+	Function Name   : usageOpen
+    Description     : Function called by a test execution process to open its
+    				  perf hardware counters. They count the user space of the
+    				  process and of the threads it starts, so they work with
+    				  the default perf_event_paranoid. Without all of them the
+    				  usage is taken from getrusage only.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void usageOpen(void)
+{
+	struct perf_event_attr Attr;
+	unsigned int i = 0;
+
+	if (getConfigNumber(USAGE_PERF_KEY, 1) == 0)
+	{
+		return;
+	}
+
+	for (i = 0; i < USAGE_COUNTERS; i++)
+	{
+		memset(&Attr, 0, sizeof(Attr));
+		Attr.size = sizeof(Attr);
+		Attr.type = PERF_TYPE_HARDWARE;
+		Attr.config = g_auPerfConfig[i];
+		Attr.disabled = 1;
+		Attr.inherit = 1;
+		Attr.exclude_kernel = 1;
+		Attr.exclude_hv = 1;
+		Attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+			PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		g_anPerfFd[i] = syscall(SYS_perf_event_open, &Attr, 0, -1, -1,
+			PERF_FLAG_FD_CLOEXEC);
+		if (g_anPerfFd[i] == -1)
+		{
+			break;
+		}
+	}
+
+	g_bPerfOpen = (i == USAGE_COUNTERS);
+	if (!g_bPerfOpen)
+	{
+		while (i > 0)
+		{
+			close(g_anPerfFd[--i]);
+			g_anPerfFd[i] = -1;
+		}
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : usageBegin
+    Description     : Function called by the test execution process when a
+    				  case starts, to take the snapshot of its totals and to
+    				  start the counters from 0.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pUsage			Out		Usage of the case
+    Returns         : None
+
+  ============================================================================*/
+
+void usageBegin(sUsage_t *pUsage)
+{
+	struct rusage Rusage;
+	unsigned int i = 0;
+
+	memset(pUsage, 0, sizeof(sUsage_t));
+	getrusage(RUSAGE_SELF, &Rusage);
+	convertRusage(&Rusage, pUsage);
+	pUsage->uState = E_USAGE_STARTED;
+
+	for (i = 0; g_bPerfOpen && (i < USAGE_COUNTERS); i++)
+	{
+		ioctl(g_anPerfFd[i], PERF_EVENT_IOC_RESET, 0);
+		ioctl(g_anPerfFd[i], PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : usageEnd
+    Description     : Function called by the test execution process when a
+    				  case ends, to get the resources it used.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pUsage			In/Out	Usage of the case
+    Returns         : None
+
+  ============================================================================*/
+
+void usageEnd(sUsage_t *pUsage)
+{
+	struct rusage Rusage;
+	sUsage_t Now;
+
+	if (g_bPerfOpen)
+	{
+		pUsage->bCounters = readCounters(pUsage);
+	}
+
+	getrusage(RUSAGE_SELF, &Rusage);
+	convertRusage(&Rusage, &Now);
+	subtractUsage(pUsage, &Now);
+}
+
+
+/**=============================================================================
+
+	Function Name   : usageSettle
+    Description     : Function called by the scheduler when a test execution
+    				  process died in the middle of a case, to get the
+    				  resources the case used from the totals wait4 returned.
+    				  The counters of the dead process are lost.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pUsage			In/Out	Usage of the case
+                      @pExitUsage		In		Totals of the process
+    Returns         : None
+
+  ============================================================================*/
+
+void usageSettle(sUsage_t *pUsage, const struct rusage *pExitUsage)
+{
+	sUsage_t Now;
+
+	if (pUsage->uState != E_USAGE_STARTED)
+	{
+		return;
+	}
+
+	convertRusage(pExitUsage, &Now);
+	subtractUsage(pUsage, &Now);
+	pUsage->bCounters = false;
+}
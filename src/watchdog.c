@@ -0,0 +1,346 @@
+/**=============================================================================
+  $Workfile: watchdog.c$
+
+  File Description: Test watchdog. Every test execution process gets its own
+                    timerfd for the test timeout and a pidfd which becomes
+                    readable when the process exits, both are waited on by
+                    the reactor so any number of tests can run side by side
+                    without signal handlers in the framework.
+
+  Author: Johnnie Alan
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+      * Redistributions of source code must retain the above copyright
+        notice, this list of conditions and the following disclaimer.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+  PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+  OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ============================================================================*/
+
+/*----------------------- I N C L U D E S   S E C T I O N --------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <sys/wait.h>
+
+#include "deviceDrvTestFW.h"
+#include "reactor.h"
+#include "watchdog.h"
+
+#define LOG_TO_USR 		1
+#define LOG_TO_DBG  	2
+
+/*------------------- G L O B A L   D E C L A R A T I O N S ------------------*/
+
+static sWatchdog_t *g_pWatchdogHead;        /* Watchdogs created */
+
+/*----------------- F U N C T I O N   D E C L A R A T I O N S ----------------*/
+
+static void timerHandler(int nFd, uint32_t uEvents, void *pArg);
+static void exitHandler(int nFd, uint32_t uEvents, void *pArg);
+static void signalProcess(sWatchdog_t *pWatchdog, int nSignal);
+
+/*------------------ F U N C T I O N   D E F I N I T I O N S -----------------*/
+
+/**=============================================================================
+
+	Function Name   : signalProcess
+    Description     : Function to send a signal to the test execution process
+    				  through its pidfd, so a recycled pid is never signalled.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog of the process
+                      @nSignal			In		Signal to send
+    Returns         : None
+
+  ============================================================================*/
+
+static void signalProcess(sWatchdog_t *pWatchdog, int nSignal)
+{
+	if (pWatchdog->nPidFd != -1)
+	{
+		syscall(SYS_pidfd_send_signal, pWatchdog->nPidFd, nSignal, NULL, 0);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : timerHandler
+    Description     : This is the test timer event handler. It is called when
+    				  the running test exceeds its timeout and it sends SIGUSR1
+    				  to the test execution process.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		Timer file descriptor
+                      @uEvents			In		Epoll events
+                      @pArg				In		Watchdog of the timer
+    Returns         : None
+
+  ============================================================================*/
+
+static void timerHandler(int nFd, uint32_t uEvents, void *pArg)
+{
+	sWatchdog_t *pWatchdog = pArg;
+	uint64_t uExpirations = 0;
+
+	read(nFd, &uExpirations, sizeof(uExpirations));
+
+	if (pWatchdog->bRunning)
+	{
+		pWatchdog->bExpired = true;
+		signalProcess(pWatchdog, SIGUSR1);
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : exitHandler
+    Description     : This is the pidfd event handler. It is called when the
+    				  test execution process exits, it reaps the process with
+    				  its resource usage and calls the exit handler of the
+    				  owner, which may attach a new process to the watchdog.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @nFd  			In		Process file descriptor
+                      @uEvents			In		Epoll events
+                      @pArg				In		Watchdog of the process
+    Returns         : None
+
+  ============================================================================*/
+
+static void exitHandler(int nFd, uint32_t uEvents, void *pArg)
+{
+	sWatchdog_t *pWatchdog = pArg;
+	int nStatus = 0;
+
+	wait4(pWatchdog->nPid, &nStatus, 0, &pWatchdog->ExitUsage);
+
+	reactorRemove(nFd);
+	close(nFd);
+	pWatchdog->nPidFd = -1;
+	pWatchdog->nPid = 0;
+
+	pWatchdog->fnPtrExitHandler(pWatchdog, nStatus);
+}
+
+
+/**=============================================================================
+
+	Function Name   : watchdogInit
+    Description     : Function to create the test timer of a watchdog and to
+    				  register it with the reactor.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog
+                      @fnPtrExitHandler	In		Called when process exits
+                      @pArg				In		Owner of the watchdog
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int watchdogInit(sWatchdog_t *pWatchdog, pWatchdogFuncPtr fnPtrExitHandler,
+    void *pArg)
+{
+	memset(pWatchdog, 0, sizeof(sWatchdog_t));
+	pWatchdog->nPidFd = -1;
+	pWatchdog->fnPtrExitHandler = fnPtrExitHandler;
+	pWatchdog->pArg = pArg;
+
+	pWatchdog->nTimerFd = timerfd_create(CLOCK_MONOTONIC,
+		TFD_NONBLOCK | TFD_CLOEXEC);
+	if (pWatchdog->nTimerFd == -1)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR, "Error in creating timer\n");
+		return -1;
+	}
+
+	if (reactorAdd(pWatchdog->nTimerFd, EPOLLIN, timerHandler,
+			pWatchdog) == -1)
+	{
+		close(pWatchdog->nTimerFd);
+		return -1;
+	}
+
+	pWatchdog->pNext = g_pWatchdogHead;
+	g_pWatchdogHead = pWatchdog;
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : watchdogAttach
+    Description     : Function to track a forked test execution process, the
+    				  exit handler is called when it exits.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog
+                      @nPid				In		Test execution process
+    Returns         : 0 ON SUCCESS, -1 ON FAILURE
+
+  ============================================================================*/
+
+int watchdogAttach(sWatchdog_t *pWatchdog, pid_t nPid)
+{
+	pWatchdog->nPid = nPid;
+
+	pWatchdog->nPidFd = syscall(SYS_pidfd_open, nPid, 0);
+	if (pWatchdog->nPidFd == -1)
+	{
+		deviceDrvTstFWDebug(LOG_TO_USR,
+			"Error in tracking test execution process\n");
+		return -1;
+	}
+
+	if (reactorAdd(pWatchdog->nPidFd, EPOLLIN, exitHandler, pWatchdog) == -1)
+	{
+		close(pWatchdog->nPidFd);
+		pWatchdog->nPidFd = -1;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**=============================================================================
+
+	Function Name   : watchdogStart
+    Description     : Function to note the start of a test and to arm its
+    				  timer.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog
+                      @uMsec			In		Test timeout in milliseconds
+    Returns         : None
+
+  ============================================================================*/
+
+void watchdogStart(sWatchdog_t *pWatchdog, unsigned int uMsec)
+{
+	struct itimerspec its;
+
+	memset(&its, 0, sizeof(its));
+	its.it_value.tv_sec = uMsec / 1000;
+	its.it_value.tv_nsec = (uMsec % 1000) * 1000000;
+
+	pWatchdog->bRunning = true;
+	pWatchdog->bExpired = false;
+
+	clock_gettime(CLOCK_MONOTONIC, &pWatchdog->StartTime);
+	timerfd_settime(pWatchdog->nTimerFd, 0, &its, NULL);
+}
+
+
+/**=============================================================================
+
+	Function Name   : watchdogStop
+    Description     : Function to disarm the timer of the running test.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog
+    Returns         : Elapsed time of the test in nanoseconds
+
+  ============================================================================*/
+
+uint64_t watchdogStop(sWatchdog_t *pWatchdog)
+{
+	struct itimerspec its;
+	struct timespec StopTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &StopTime);
+
+	memset(&its, 0, sizeof(its));
+	timerfd_settime(pWatchdog->nTimerFd, 0, &its, NULL);
+	pWatchdog->bRunning = false;
+
+	return (uint64_t)(StopTime.tv_sec - pWatchdog->StartTime.tv_sec) *
+		WATCHDOG_NSEC_PER_SEC + StopTime.tv_nsec -
+		pWatchdog->StartTime.tv_nsec;
+}
+
+
+/**=============================================================================
+
+	Function Name   : watchdogClose
+    Description     : Function to kill and reap the test execution process
+    				  and to release the watchdog.
+    Arguments       :
+    				  Name            	Dir    	Description
+                      @pWatchdog		In		Watchdog
+    Returns         : None
+
+  ============================================================================*/
+
+void watchdogClose(sWatchdog_t *pWatchdog)
+{
+	sWatchdog_t **ppWatchdog = &g_pWatchdogHead;
+
+	if (pWatchdog->nPid > 0)
+	{
+		/* Kill child process */
+		signalProcess(pWatchdog, SIGKILL);
+		waitpid(pWatchdog->nPid, NULL, 0);
+		pWatchdog->nPid = 0;
+	}
+
+	if (pWatchdog->nPidFd != -1)
+	{
+		reactorRemove(pWatchdog->nPidFd);
+		close(pWatchdog->nPidFd);
+		pWatchdog->nPidFd = -1;
+	}
+
+	reactorRemove(pWatchdog->nTimerFd);
+	close(pWatchdog->nTimerFd);
+
+	while (*ppWatchdog != NULL)
+	{
+		if (*ppWatchdog == pWatchdog)
+		{
+			*ppWatchdog = pWatchdog->pNext;
+			break;
+		}
+		ppWatchdog = &(*ppWatchdog)->pNext;
+	}
+}
+
+
+/**=============================================================================
+
+	Function Name   : watchdogCloseAll
+    Description     : Function to release all the watchdogs, called when the
+    				  framework exits.
+    Arguments       : None
+    Returns         : None
+
+  ============================================================================*/
+
+void watchdogCloseAll(void)
+{
+	while (g_pWatchdogHead != NULL)
+	{
+		watchdogClose(g_pWatchdogHead);
+	}
+}
@@ -26,6 +26,9 @@ struct user_test_suite aTestSuite[3] = {"TESTSUIT_1", "cleanup", aTestCase1,
                                      "TESTSUIT_2", "cleanup", aTestCase2,
                                       TEST_SUITE_END, 0, NULL};
 
+struct user_test_suite_attr aTestSuiteAttr[2] = {"TESTSUIT_1", true,
+                                      TEST_SUITE_END, false};
+
 int testFunc1(void)
 {
     printf("In test case 1\n");